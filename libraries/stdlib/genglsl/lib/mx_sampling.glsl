@@ -21,6 +21,20 @@ vec2 mx_compute_sample_size_uv(vec2 uv, float filterSize, float filterOffset)
    return vec2(sampleSizeU, sampleSizeV);
 }
 
+//
+// Return true if samples spaced by the given sample size are one texel
+// apart and centered on texels, so that linear filtering between two
+// neighboring samples gives exact weighted sums of them.
+//
+bool mx_is_texel_aligned(sampler2D tex_sampler, vec2 uv, vec2 sampleSize)
+{
+   vec2 texSize = vec2(textureSize(tex_sampler, 0));
+   vec2 spacing = sampleSize * texSize;
+   vec2 texelPos = uv * texSize - 0.5;
+   vec2 centerOffset = abs(texelPos - round(texelPos));
+   return all(lessThan(abs(spacing - 1.0), vec2(1.0E-03))) && all(lessThan(centerOffset, vec2(1.0E-03)));
+}
+
 //
 // Compute a normal mapped to 0..1 space based on a set of input
 // samples using a Sobel filter.
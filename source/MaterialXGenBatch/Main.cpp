@@ -0,0 +1,542 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/XmlIo.h>
+
+#include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#include <MaterialXGenGlsl/GlslShaderReflection.h>
+#include <MaterialXGenOsl/OslShaderGenerator.h>
+
+#include <MaterialXGenShader/DefaultColorManagementSystem.h>
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGraphCache.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace mx = MaterialX;
+
+const std::string options =
+" Options: \n"
+"    --library [FILEPATH]     Library search path, may be given more than once (Default is \"libraries\")\n"
+"    --libraries [NAMES]      Comma separated library folders to load (Default is \"stdlib,pbrlib,bxdf\")\n"
+"    --target [NAME]          Target to generate shaders for, genglsl or genosl (Default is genglsl)\n"
+"    --output [FILEPATH]      Output folder for shaders and the manifest (Default is \"generated\")\n"
+"    --threads [INTEGER]      Number of worker threads (Default is the number of hardware threads)\n"
+"    --interface [NAME]       Shader interface, complete or reduced (Default is complete)\n"
+"    --optimize [INTEGER]     Shader graph optimization level (Default is 1)\n"
+"    --flatten                Flatten the subgraphs of nodegraph implementations\n"
+"    --bake                   Bake uniform values into the shaders as constants\n"
+"    --noCache                Disable caching of nodegraph implementation graphs\n"
+"    --help                   Print this list\n"
+" All other arguments are MaterialX files, or folders searched recursively for MaterialX files.\n";
+
+namespace
+{
+
+// Result of generating the shader for a single renderable element.
+struct ShaderResult
+{
+    std::string elementPath;
+    std::string shaderName;
+    mx::StringVec outputFiles;
+    double time = 0.0;
+    std::string error;
+};
+
+// Result of processing a single MaterialX file.
+struct FileResult
+{
+    mx::FilePath inputFile;
+    std::string outputName;
+    double loadTime = 0.0;
+    double generationTime = 0.0;
+    size_t cacheHits = 0;
+    size_t failures = 0;
+    std::vector<ShaderResult> shaders;
+    std::string error;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMilliseconds(Clock::time_point startTime)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+}
+
+bool parseInteger(const std::string& str, int& value)
+{
+    try
+    {
+        size_t length = 0;
+        value = std::stoi(str, &length);
+        return length == str.size();
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+}
+
+mx::DocumentPtr loadLibraries(const mx::StringVec& libraryFolders, const mx::FileSearchPath& searchPath)
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    for (const std::string& libraryFolder : libraryFolders)
+    {
+        mx::FilePath libraryPath = searchPath.find(libraryFolder);
+        if (!libraryPath.isDirectory())
+        {
+            std::cerr << "Library folder not found: " << libraryFolder << std::endl;
+            continue;
+        }
+        for (const mx::FilePath& path : libraryPath.getSubDirectories())
+        {
+            for (const mx::FilePath& filename : path.getFilesInDirectory(mx::MTLX_EXTENSION))
+            {
+                mx::FilePath file = path / filename;
+                mx::DocumentPtr libDoc = mx::createDocument();
+                mx::readFromXmlFile(libDoc, file);
+                libDoc->setSourceUri(file);
+                doc->importLibrary(libDoc);
+            }
+        }
+    }
+    return doc;
+}
+
+// Return all MaterialX files given directly, or found under the given folders.
+mx::FilePathVec findInputFiles(const mx::StringVec& inputs)
+{
+    mx::FilePathVec files;
+    for (const std::string& input : inputs)
+    {
+        mx::FilePath path(input);
+        if (path.isDirectory())
+        {
+            for (const mx::FilePath& dir : path.getSubDirectories())
+            {
+                for (const mx::FilePath& file : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+                {
+                    files.push_back(dir / file);
+                }
+            }
+        }
+        else if (path.exists())
+        {
+            files.push_back(path);
+        }
+        else
+        {
+            std::cerr << "Input not found: " << input << std::endl;
+        }
+    }
+    return files;
+}
+
+// Return the file extension to use for the given shader stage.
+std::string getStageExtension(const std::string& language, const std::string& stage)
+{
+    if (language == mx::OslShaderGenerator::LANGUAGE)
+    {
+        return "osl";
+    }
+    if (stage == mx::Stage::VERTEX)
+    {
+        return "vert";
+    }
+    if (stage == mx::Stage::PIXEL)
+    {
+        return "frag";
+    }
+    return stage;
+}
+
+void writeFile(const mx::FilePath& filename, const std::string& content)
+{
+    std::ofstream file(filename.asString());
+    if (!file)
+    {
+        throw mx::Exception("Failed to write file: " + filename.asString());
+    }
+    file << content;
+}
+
+// Shader generation state owned by a single worker thread.
+class Worker
+{
+  public:
+    Worker(const std::string& language, mx::DocumentPtr libraries, const mx::FileSearchPath& searchPath,
+           const mx::GenOptions& genOptions, bool useCache) :
+        _generator(language == mx::OslShaderGenerator::LANGUAGE ? mx::OslShaderGenerator::create() : mx::GlslShaderGenerator::create()),
+        _context(_generator),
+        _libraries(libraries)
+    {
+        mx::ColorManagementSystemPtr cms = mx::DefaultColorManagementSystem::create(_generator->getLanguage());
+        cms->loadLibrary(libraries);
+        _generator->setColorManagementSystem(cms);
+
+        _context.getOptions() = genOptions;
+        for (size_t i = 0; i < searchPath.size(); i++)
+        {
+            _context.registerSourceCodeSearchPath(searchPath[i]);
+        }
+        if (useCache)
+        {
+            _context.setGraphCache(mx::ShaderGraphCache::create());
+        }
+    }
+
+    void process(FileResult& result, const mx::FilePath& outputPath)
+    {
+        Clock::time_point startTime = Clock::now();
+        mx::DocumentPtr doc = mx::createDocument();
+        std::vector<mx::TypedElementPtr> elements;
+        try
+        {
+            mx::FilePath parentPath = result.inputFile;
+            parentPath.pop();
+            mx::readFromXmlFile(doc, result.inputFile, parentPath);
+            doc->importLibrary(_libraries);
+            mx::findRenderableElements(doc, elements);
+        }
+        catch (std::exception& e)
+        {
+            result.error = e.what();
+            result.failures++;
+            return;
+        }
+        result.loadTime = elapsedMilliseconds(startTime);
+        if (elements.empty())
+        {
+            return;
+        }
+
+        // Node implementations are cached by name, so they can not be shared
+        // between documents. Graphs for library nodegraphs are kept in the graph
+        // cache, which is keyed by content.
+        _context.clearNodeImplementations();
+        _context.setArena(mx::GenArena::create());
+        mx::ShaderGraphCachePtr cache = _context.getGraphCache();
+        const size_t numHits = cache ? cache->numHits() : 0;
+
+        mx::FilePath shaderPath = outputPath / result.outputName;
+        shaderPath.createDirectory();
+
+        mx::StringMap pathMap;
+        pathMap["/"] = "_";
+        for (mx::TypedElementPtr element : elements)
+        {
+            ShaderResult shaderResult;
+            shaderResult.elementPath = element->getNamePath();
+            shaderResult.shaderName = mx::createValidName(mx::replaceSubstrings(shaderResult.elementPath, pathMap));
+
+            startTime = Clock::now();
+            try
+            {
+                mx::ShaderPtr shader = _generator->generate(shaderResult.shaderName, element, _context);
+                if (!shader)
+                {
+                    throw mx::Exception("No shader generated");
+                }
+                const std::string filePrefix = result.outputName + "/" + shaderResult.shaderName + ".";
+                for (size_t i = 0; i < shader->numStages(); i++)
+                {
+                    const mx::ShaderStage& stage = shader->getStage(i);
+                    const std::string filename = filePrefix + getStageExtension(_generator->getLanguage(), stage.getName());
+                    writeFile(outputPath / filename, stage.getSourceCode());
+                    shaderResult.outputFiles.push_back(filename);
+                }
+
+                // Write the reflection data next to GLSL shaders.
+                if (_generator->getLanguage() == mx::GlslShaderGenerator::LANGUAGE)
+                {
+                    const std::string filename = filePrefix + "json";
+                    writeFile(outputPath / filename, mx::GlslShaderReflection::create(*shader, _context)->asJson());
+                    shaderResult.outputFiles.push_back(filename);
+                }
+            }
+            catch (std::exception& e)
+            {
+                shaderResult.error = e.what();
+                result.failures++;
+            }
+            shaderResult.time = elapsedMilliseconds(startTime);
+            result.generationTime += shaderResult.time;
+            result.shaders.push_back(shaderResult);
+        }
+
+        _context.setArena(nullptr);
+        result.cacheHits = cache ? cache->numHits() - numHits : 0;
+    }
+
+  private:
+    mx::ShaderGeneratorPtr _generator;
+    mx::GenContext _context;
+    mx::DocumentPtr _libraries;
+};
+
+void writeManifest(const mx::FilePath& filename, const std::string& target, const std::vector<FileResult>& results)
+{
+    std::ofstream stream(filename.asString());
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\n  \"target\": \"" << mx::escapeJsonString(target) << "\",\n  \"files\": [";
+    std::string fileDelim = "\n";
+    for (const FileResult& result : results)
+    {
+        stream << fileDelim << "    {\n"
+               << "      \"file\": \"" << mx::escapeJsonString(result.inputFile.asString(mx::FilePath::FormatPosix)) << "\",\n"
+               << "      \"output\": \"" << mx::escapeJsonString(result.outputName) << "\",\n"
+               << "      \"loadTime\": " << result.loadTime << ",\n"
+               << "      \"generationTime\": " << result.generationTime << ",\n"
+               << "      \"cacheHits\": " << result.cacheHits << ",\n"
+               << "      \"failures\": " << result.failures << ",\n";
+        if (!result.error.empty())
+        {
+            stream << "      \"error\": \"" << mx::escapeJsonString(result.error) << "\",\n";
+        }
+        stream << "      \"shaders\": [";
+        std::string shaderDelim = "\n";
+        for (const ShaderResult& shader : result.shaders)
+        {
+            stream << shaderDelim << "        {\"element\": \"" << mx::escapeJsonString(shader.elementPath)
+                   << "\", \"name\": \"" << mx::escapeJsonString(shader.shaderName)
+                   << "\", \"time\": " << shader.time << ", \"outputs\": [";
+            std::string outputDelim;
+            for (const std::string& output : shader.outputFiles)
+            {
+                stream << outputDelim << "\"" << mx::escapeJsonString(output) << "\"";
+                outputDelim = ", ";
+            }
+            stream << "]";
+            if (!shader.error.empty())
+            {
+                stream << ", \"error\": \"" << mx::escapeJsonString(shader.error) << "\"";
+            }
+            stream << "}";
+            shaderDelim = ",\n";
+        }
+        stream << (result.shaders.empty() ? "]\n" : "\n      ]\n") << "    }";
+        fileDelim = ",\n";
+    }
+    stream << "\n  ]\n}\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* const argv[])
+{
+    std::vector<std::string> tokens;
+    for (int i = 1; i < argc; i++)
+    {
+        tokens.push_back(std::string(argv[i]));
+    }
+
+    mx::FileSearchPath searchPath;
+    mx::StringVec libraryFolders = { "stdlib", "pbrlib", "bxdf" };
+    std::string target = mx::GlslShaderGenerator::LANGUAGE;
+    mx::FilePath outputPath("generated");
+    size_t numThreads = std::thread::hardware_concurrency();
+    mx::GenOptions genOptions;
+    bool useCache = true;
+    mx::StringVec inputs;
+
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        const std::string& token = tokens[i];
+        const std::string& nextToken = i + 1 < tokens.size() ? tokens[i + 1] : mx::EMPTY_STRING;
+        if (token == "--help")
+        {
+            std::cout << " Usage: MaterialXGenBatch [options] [FILEPATH]...\n" << options << std::endl;
+            return 0;
+        }
+        if (token == "--flatten")
+        {
+            genOptions.flattenSubgraphs = true;
+            continue;
+        }
+        if (token == "--bake")
+        {
+            genOptions.bakeUniforms = true;
+            continue;
+        }
+        if (token == "--noCache")
+        {
+            useCache = false;
+            continue;
+        }
+        if (token.compare(0, 2, "--") != 0)
+        {
+            inputs.push_back(token);
+            continue;
+        }
+        if (nextToken.empty())
+        {
+            std::cerr << "Missing value for option: " << token << std::endl;
+            return 1;
+        }
+        i++;
+        if (token == "--library")
+        {
+            searchPath.append(mx::FilePath(nextToken));
+        }
+        else if (token == "--libraries")
+        {
+            libraryFolders = mx::splitString(nextToken, ",");
+        }
+        else if (token == "--target")
+        {
+            target = nextToken;
+        }
+        else if (token == "--output")
+        {
+            outputPath = nextToken;
+        }
+        else if (token == "--threads")
+        {
+            int value = 0;
+            if (!parseInteger(nextToken, value))
+            {
+                std::cerr << "Invalid value for option " << token << ": " << nextToken << std::endl;
+                std::cout << " Usage: MaterialXGenBatch [options] [FILEPATH]...\n" << options << std::endl;
+                return 1;
+            }
+            numThreads = static_cast<size_t>(std::max(1, value));
+        }
+        else if (token == "--interface")
+        {
+            genOptions.shaderInterfaceType = nextToken == "reduced" ? mx::SHADER_INTERFACE_REDUCED : mx::SHADER_INTERFACE_COMPLETE;
+        }
+        else if (token == "--optimize")
+        {
+            int value = 0;
+            if (!parseInteger(nextToken, value))
+            {
+                std::cerr << "Invalid value for option " << token << ": " << nextToken << std::endl;
+                std::cout << " Usage: MaterialXGenBatch [options] [FILEPATH]...\n" << options << std::endl;
+                return 1;
+            }
+            genOptions.optimizationLevel = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << token << std::endl;
+            return 1;
+        }
+    }
+
+    if (target != mx::GlslShaderGenerator::LANGUAGE && target != mx::OslShaderGenerator::LANGUAGE)
+    {
+        std::cerr << "Unsupported target: " << target << std::endl;
+        return 1;
+    }
+    if (searchPath.size() == 0)
+    {
+        searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    }
+
+    mx::FilePathVec inputFiles = findInputFiles(inputs);
+    if (inputFiles.empty())
+    {
+        std::cerr << "No MaterialX files to process." << std::endl;
+        std::cout << " Usage: MaterialXGenBatch [options] [FILEPATH]...\n" << options << std::endl;
+        return 1;
+    }
+
+    mx::DocumentPtr libraries;
+    try
+    {
+        libraries = loadLibraries(libraryFolders, searchPath);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Failed to load libraries: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Give each file its own output folder, named by the file.
+    std::vector<FileResult> results(inputFiles.size());
+    std::map<std::string, size_t> outputNames;
+    for (size_t i = 0; i < inputFiles.size(); i++)
+    {
+        std::string name = mx::createValidName(mx::removeExtension(inputFiles[i].getBaseName()));
+        size_t count = outputNames[name]++;
+        results[i].inputFile = inputFiles[i];
+        results[i].outputName = count ? name + "_" + std::to_string(count) : name;
+    }
+    outputPath.createDirectory();
+    if (!outputPath.isDirectory())
+    {
+        std::cerr << "Failed to create output folder: " << outputPath.asString() << std::endl;
+        return 1;
+    }
+
+    // Files are handed out to the workers in order, and each worker
+    // keeps its own generator, context and graph cache.
+    Clock::time_point startTime = Clock::now();
+    numThreads = std::max(size_t(1), std::min(numThreads, inputFiles.size()));
+    std::atomic<size_t> nextFile(0);
+    auto runWorker = [&]()
+    {
+        Worker worker(target, libraries, searchPath, genOptions, useCache);
+        for (size_t i = nextFile++; i < results.size(); i = nextFile++)
+        {
+            worker.process(results[i], outputPath);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < numThreads; i++)
+    {
+        threads.emplace_back(runWorker);
+    }
+    runWorker();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const double totalTime = elapsedMilliseconds(startTime);
+
+    writeManifest(outputPath / mx::FilePath("manifest.json"), target, results);
+
+    // Report per file results and totals.
+    size_t numShaders = 0;
+    size_t numFailures = 0;
+    size_t numCacheHits = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const FileResult& result : results)
+    {
+        std::cout << result.inputFile.asString() << ": " << result.shaders.size() << " shaders, "
+                  << result.failures << " failures, " << result.cacheHits << " cache hits, "
+                  << result.loadTime + result.generationTime << " ms" << std::endl;
+        if (!result.error.empty())
+        {
+            std::cout << "    Error: " << result.error << std::endl;
+        }
+        for (const ShaderResult& shader : result.shaders)
+        {
+            if (!shader.error.empty())
+            {
+                std::cout << "    Error in " << shader.elementPath << ": " << shader.error << std::endl;
+            }
+        }
+        numShaders += result.shaders.size();
+        numFailures += result.failures;
+        numCacheHits += result.cacheHits;
+    }
+    std::cout << "Generated " << numShaders - numFailures << " of " << numShaders << " shaders from "
+              << results.size() << " files in " << totalTime << " ms using " << numThreads << " threads, with "
+              << numFailures << " failures and " << numCacheHits << " cache hits" << std::endl;
+
+    return numFailures ? 1 : 0;
+}
@@ -254,6 +254,8 @@ GlslShaderGenerator::GlslShaderGenerator() :
 
 ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "GlslShaderGenerator::generate");
+
     ShaderPtr shader = createShader(name, element, context);
 
     // Turn on fixed float formatting to make sure float values are
@@ -274,6 +276,8 @@ ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element,
 
 void GlslShaderGenerator::emitVertexStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "GlslShaderGenerator::emitVertexStage");
+
     // Add version directive
     emitLine("#version " + getVersion(), stage, false);
     emitLineBreak(stage);
@@ -357,6 +361,8 @@ void GlslShaderGenerator::emitSpecularEnvironment(GenContext& context, ShaderSta
 
 void GlslShaderGenerator::emitPixelStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "GlslShaderGenerator::emitPixelStage");
+
     // Add version directive
     emitLine("#version " + getVersion(), stage, false);
     emitLineBreak(stage);
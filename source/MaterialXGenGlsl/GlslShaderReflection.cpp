@@ -0,0 +1,272 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenGlsl/GlslShaderReflection.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace MaterialX
+{
+
+const size_t GlslShaderReflection::INVALID_OFFSET = size_t(-1);
+
+namespace
+{
+    const size_t VEC4_SIZE = 16;
+
+    size_t alignOffset(size_t offset, size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    void writeOffset(std::ostream& stream, size_t offset)
+    {
+        if (offset == GlslShaderReflection::INVALID_OFFSET)
+        {
+            stream << "null";
+        }
+        else
+        {
+            stream << offset;
+        }
+    }
+}
+
+GlslShaderReflectionPtr GlslShaderReflection::create(const Shader& shader, GenContext& context)
+{
+    return GlslShaderReflectionPtr(new GlslShaderReflection(shader, context));
+}
+
+GlslShaderReflection::GlslShaderReflection(const Shader& shader, GenContext& context) :
+    _name(shader.getName())
+{
+    // Follow the order in which the generator declares the variables. Uniform
+    // blocks are stored in a map, so they are sorted by name for a stable order.
+    for (size_t i = 0; i < shader.numStages(); i++)
+    {
+        const ShaderStage& stage = shader.getStage(i);
+
+        vector<const VariableBlock*> blocks;
+        for (auto it : stage.getUniformBlocks())
+        {
+            blocks.push_back(it.second.get());
+        }
+        std::sort(blocks.begin(), blocks.end(), [](const VariableBlock* a, const VariableBlock* b)
+        {
+            return a->getName() < b->getName();
+        });
+
+        for (const VariableBlock* block : blocks)
+        {
+            if (block->empty())
+            {
+                continue;
+            }
+            if (block->getName() == HW::LIGHT_DATA)
+            {
+                // Light data is declared as an array of structs in the
+                // pixel stage, and only for shaders using lights.
+                const bool lighting = shader.hasClassification(ShaderNode::Classification::SHADER | ShaderNode::Classification::SURFACE) ||
+                                      shader.hasClassification(ShaderNode::Classification::BSDF);
+                if (stage.getName() == Stage::PIXEL && lighting)
+                {
+                    addUniformBlock(stage, *block, std::max(1u, context.getOptions().hwMaxActiveLightSources));
+                }
+                else if (stage.getName() != Stage::PIXEL)
+                {
+                    addUniformBlock(stage, *block, 0);
+                }
+            }
+            else
+            {
+                addUniformBlock(stage, *block, 0);
+            }
+        }
+
+        if (stage.getName() == Stage::VERTEX && stage.getInputBlocks().count(HW::VERTEX_INPUTS))
+        {
+            const VariableBlock& vertexInputs = stage.getInputBlock(HW::VERTEX_INPUTS);
+            for (size_t j = 0; j < vertexInputs.size(); j++)
+            {
+                const ShaderPort* port = vertexInputs[j];
+                _vertexInputs.push_back({ port->getVariable(), port->getType()->getName(), port->getSemantic(), j });
+            }
+        }
+    }
+}
+
+void GlslShaderReflection::addUniformBlock(const ShaderStage& stage, const VariableBlock& block, size_t arraySize)
+{
+    UniformBlock uniformBlock;
+    uniformBlock.stage = stage.getName();
+    uniformBlock.name = block.getName();
+    uniformBlock.arraySize = arraySize;
+
+    size_t offset = 0;
+    for (const ShaderPort* port : block.getVariableOrder())
+    {
+        ConstValuePtr value = port->getValue();
+        const string valueString = value ? value->getValueString() : EMPTY_STRING;
+
+        // Samplers are opaque types, which are bound to texture units
+        // rather than stored in the block.
+        if (port->getType() == Type::FILENAME)
+        {
+            auto it = std::find_if(_textures.begin(), _textures.end(), [port](const Texture& texture)
+            {
+                return texture.name == port->getVariable();
+            });
+            const size_t unit = it != _textures.end() ? it->unit :
+                                _textures.empty() ? 0 : _textures.back().unit + 1;
+            _textures.push_back({ stage.getName(), port->getVariable(), port->getPath(), valueString, unit });
+            continue;
+        }
+
+        Uniform uniform;
+        uniform.name = port->getVariable();
+        uniform.type = port->getType()->getName();
+        uniform.semantic = port->getSemantic();
+        uniform.path = port->getPath();
+        uniform.value = valueString;
+        uniform.offset = INVALID_OFFSET;
+        uniform.size = 0;
+        uniform.arraySize = 0;
+
+        size_t alignment = 0;
+        if (getStd140Layout(port->getType(), value, uniform.size, alignment, uniform.arraySize))
+        {
+            uniform.offset = alignOffset(offset, alignment);
+            offset = uniform.offset + uniform.size;
+        }
+        uniformBlock.uniforms.push_back(uniform);
+    }
+
+    // Structs, and the default block when copied to a buffer,
+    // are padded to a multiple of the size of a vec4.
+    uniformBlock.size = alignOffset(offset, VEC4_SIZE);
+    _uniformBlocks.push_back(uniformBlock);
+}
+
+const GlslShaderReflection::Uniform* GlslShaderReflection::findUniform(const string& stage, const string& name) const
+{
+    for (const UniformBlock& block : _uniformBlocks)
+    {
+        if (block.stage != stage)
+        {
+            continue;
+        }
+        for (const Uniform& uniform : block.uniforms)
+        {
+            if (uniform.name == name)
+            {
+                return &uniform;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool GlslShaderReflection::getStd140Layout(const TypeDesc* type, ConstValuePtr value,
+                                           size_t& size, size_t& alignment, size_t& arraySize)
+{
+    const size_t scalarSize = 4;
+    arraySize = 0;
+
+    // Strings are declared as integers in GLSL.
+    if (type->getBaseType() == TypeDesc::BASETYPE_STRING && type != Type::FILENAME)
+    {
+        size = alignment = scalarSize;
+        return true;
+    }
+    if (type->getBaseType() != TypeDesc::BASETYPE_BOOLEAN &&
+        type->getBaseType() != TypeDesc::BASETYPE_INTEGER &&
+        type->getBaseType() != TypeDesc::BASETYPE_FLOAT)
+    {
+        return false;
+    }
+
+    // Array elements, and matrix columns, are padded to the size of a vec4.
+    if (type->isArray())
+    {
+        if (value && value->isA<vector<float>>())
+        {
+            arraySize = value->asA<vector<float>>().size();
+        }
+        else if (value && value->isA<vector<int>>())
+        {
+            arraySize = value->asA<vector<int>>().size();
+        }
+        if (arraySize == 0)
+        {
+            return false;
+        }
+        size = arraySize * VEC4_SIZE;
+        alignment = VEC4_SIZE;
+        return true;
+    }
+    if (type->getSemantic() == TypeDesc::SEMANTIC_MATRIX)
+    {
+        const size_t columns = type->getSize() == 9 ? 3 : 4;
+        size = columns * VEC4_SIZE;
+        alignment = VEC4_SIZE;
+        return true;
+    }
+
+    const size_t components = type->getSize();
+    size = components * scalarSize;
+    alignment = components == 1 ? scalarSize : components == 2 ? 2 * scalarSize : VEC4_SIZE;
+    return true;
+}
+
+string GlslShaderReflection::asJson() const
+{
+    std::stringstream stream;
+    stream << "{\"name\":\"" << escapeJsonString(_name) << "\",\"uniformBlocks\":[";
+    string blockDelim;
+    for (const UniformBlock& block : _uniformBlocks)
+    {
+        stream << blockDelim << "\n{\"stage\":\"" << escapeJsonString(block.stage) << "\",\"name\":\"" << escapeJsonString(block.name)
+               << "\",\"size\":" << block.size << ",\"arraySize\":" << block.arraySize << ",\"uniforms\":[";
+        string uniformDelim;
+        for (const Uniform& uniform : block.uniforms)
+        {
+            stream << uniformDelim << "\n{\"name\":\"" << escapeJsonString(uniform.name) << "\",\"type\":\"" << escapeJsonString(uniform.type)
+                   << "\",\"semantic\":\"" << escapeJsonString(uniform.semantic) << "\",\"path\":\"" << escapeJsonString(uniform.path)
+                   << "\",\"value\":\"" << escapeJsonString(uniform.value) << "\",\"offset\":";
+            writeOffset(stream, uniform.offset);
+            stream << ",\"size\":" << uniform.size << ",\"arraySize\":" << uniform.arraySize << "}";
+            uniformDelim = ",";
+        }
+        stream << "]}";
+        blockDelim = ",";
+    }
+    stream << "],\"textures\":[";
+    string textureDelim;
+    for (const Texture& texture : _textures)
+    {
+        stream << textureDelim << "\n{\"stage\":\"" << escapeJsonString(texture.stage) << "\",\"name\":\"" << escapeJsonString(texture.name)
+               << "\",\"path\":\"" << escapeJsonString(texture.path) << "\",\"value\":\"" << escapeJsonString(texture.value)
+               << "\",\"unit\":" << texture.unit << "}";
+        textureDelim = ",";
+    }
+    stream << "],\"vertexInputs\":[";
+    string inputDelim;
+    for (const VertexInput& input : _vertexInputs)
+    {
+        stream << inputDelim << "\n{\"name\":\"" << escapeJsonString(input.name) << "\",\"type\":\"" << escapeJsonString(input.type)
+               << "\",\"semantic\":\"" << escapeJsonString(input.semantic) << "\",\"location\":" << input.location << "}";
+        inputDelim = ",";
+    }
+    stream << "]}\n";
+    return stream.str();
+}
+
+} // namespace MaterialX
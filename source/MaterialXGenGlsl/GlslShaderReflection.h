@@ -0,0 +1,162 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_GLSLSHADERREFLECTION_H
+#define MATERIALX_GLSLSHADERREFLECTION_H
+
+/// @file
+/// Reflection of the interface of generated GLSL shaders
+
+#include <MaterialXGenShader/Shader.h>
+
+namespace MaterialX
+{
+
+class GenContext;
+class TypeDesc;
+
+/// Shared pointer to a GlslShaderReflection
+using GlslShaderReflectionPtr = shared_ptr<class GlslShaderReflection>;
+
+/// @class GlslShaderReflection
+/// Reflection data for the interface of a shader generated by the GlslShaderGenerator.
+///
+/// Lists the uniform blocks of each stage as they are declared in the shader
+/// source, with the offset of each uniform in the std140 layout of the block,
+/// along with the textures and vertex inputs. Each variable records the path
+/// of the element it was created for, so applications can build binding tables
+/// once, without parsing the source code or querying the compiled program.
+///
+/// The uniforms are declared in the default uniform block of the program, so
+/// the std140 offsets apply when the uniforms are copied to a uniform buffer
+/// with the same layout.
+class GlslShaderReflection
+{
+  public:
+    /// Offset used for variables which are not part of a std140 layout.
+    static const size_t INVALID_OFFSET;
+
+    /// A uniform variable.
+    struct Uniform
+    {
+        /// Variable name in the shader source.
+        string name;
+        /// MaterialX type name.
+        string type;
+        /// Variable semantic.
+        string semantic;
+        /// Path of the element the uniform was created for.
+        string path;
+        /// Default value as a string.
+        string value;
+        /// Byte offset in the std140 layout of the block.
+        size_t offset;
+        /// Size in bytes in the std140 layout.
+        size_t size;
+        /// Number of array elements, or zero if not an array.
+        size_t arraySize;
+    };
+
+    /// A block of uniforms declared in a shader stage.
+    struct UniformBlock
+    {
+        /// Name of the shader stage.
+        string stage;
+        /// Name of the block.
+        string name;
+        /// Size in bytes of the block in the std140 layout.
+        size_t size;
+        /// Number of array elements for blocks declared as an array of structs,
+        /// such as the light data, or zero if not an array.
+        size_t arraySize;
+        /// Uniforms in declaration order.
+        vector<Uniform> uniforms;
+    };
+
+    /// A texture sampler.
+    struct Texture
+    {
+        /// Name of the shader stage.
+        string stage;
+        /// Sampler name in the shader source.
+        string name;
+        /// Path of the element the texture was created for.
+        string path;
+        /// Default filename.
+        string value;
+        /// Texture unit, assigned in declaration order.
+        size_t unit;
+    };
+
+    /// A vertex input.
+    struct VertexInput
+    {
+        /// Variable name in the shader source.
+        string name;
+        /// MaterialX type name.
+        string type;
+        /// Variable semantic.
+        string semantic;
+        /// Attribute location, assigned in declaration order.
+        size_t location;
+    };
+
+    /// Create reflection data for a shader generated with the given context.
+    static GlslShaderReflectionPtr create(const Shader& shader, GenContext& context);
+
+    /// Return the name of the shader.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+    /// Return all uniform blocks, ordered by stage and name.
+    const vector<UniformBlock>& getUniformBlocks() const
+    {
+        return _uniformBlocks;
+    }
+
+    /// Return all textures.
+    const vector<Texture>& getTextures() const
+    {
+        return _textures;
+    }
+
+    /// Return all vertex inputs.
+    const vector<VertexInput>& getVertexInputs() const
+    {
+        return _vertexInputs;
+    }
+
+    /// Return the uniform with the given name in the given stage,
+    /// or nullptr if no such uniform exists.
+    const Uniform* findUniform(const string& stage, const string& name) const;
+
+    /// Return the reflection data as compact JSON.
+    string asJson() const;
+
+    /// Return the size and base alignment in bytes of a variable with the
+    /// given type in a std140 layout, using the value to size arrays. The
+    /// number of array elements is returned in arraySize, or zero if the
+    /// type is not an array. Returns false for types which can not be
+    /// stored in a uniform block.
+    static bool getStd140Layout(const TypeDesc* type, ConstValuePtr value,
+                                size_t& size, size_t& alignment, size_t& arraySize);
+
+  protected:
+    /// Protected constructor
+    GlslShaderReflection(const Shader& shader, GenContext& context);
+
+    void addUniformBlock(const ShaderStage& stage, const VariableBlock& block, size_t arraySize);
+
+    string _name;
+    vector<UniformBlock> _uniformBlocks;
+    vector<Texture> _textures;
+    vector<VertexInput> _vertexInputs;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -102,4 +102,9 @@ void BitangentNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& con
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool BitangentNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != SPACE && input.getName() != INDEX;
+}
+
 } // namespace MaterialX
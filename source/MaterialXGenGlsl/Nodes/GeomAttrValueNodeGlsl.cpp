@@ -45,4 +45,9 @@ void GeomAttrValueNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext&
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool GeomAttrValueNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != ATTRNAME;
+}
+
 } // namespace MaterialX
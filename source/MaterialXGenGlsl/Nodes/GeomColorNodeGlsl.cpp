@@ -70,4 +70,9 @@ void GeomColorNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& con
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool GeomColorNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != INDEX;
+}
+
 } // namespace MaterialX
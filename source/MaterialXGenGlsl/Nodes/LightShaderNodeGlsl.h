@@ -28,6 +28,9 @@ public:
 
     void createVariables(const ShaderNode& node, GenContext& context, Shader& shader) const override;
 
+    /// Light shaders are bound per shader, so their definitions are never shared.
+    bool hasShareableDefinition() const override { return false; }
+
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
 protected:
@@ -102,4 +102,9 @@ void NormalNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& contex
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool NormalNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != SPACE;
+}
+
 } // namespace MaterialX
@@ -101,4 +101,9 @@ void PositionNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& cont
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool PositionNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != SPACE;
+}
+
 } // namespace MaterialX
@@ -193,4 +193,10 @@ void SurfaceNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& conte
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+bool SurfaceNodeGlsl::isUsed(const ShaderInput& input, const GenContext& context) const
+{
+    // Opacity is only read for transparent surfaces.
+    return input.getName() != "opacity" || context.getOptions().hwTransparency;
+}
+
 } // namespace MaterialX
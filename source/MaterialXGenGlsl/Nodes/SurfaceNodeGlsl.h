@@ -23,6 +23,8 @@ class SurfaceNodeGlsl : public GlslImplementation
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    bool isUsed(const ShaderInput& input, const GenContext& context) const override;
+
   private:
     /// Closure contexts for calling closure functions.
     HwClosureContextPtr _callReflection;
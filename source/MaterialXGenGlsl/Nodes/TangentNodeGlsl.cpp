@@ -102,4 +102,9 @@ void TangentNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& conte
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool TangentNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != SPACE && input.getName() != INDEX;
+}
+
 } // namespace MaterialX
@@ -58,4 +58,9 @@ void TexCoordNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& cont
     END_SHADER_STAGE(shader, Stage::PIXEL)
 }
 
+bool TexCoordNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != INDEX;
+}
+
 } // namespace MaterialX
@@ -35,4 +35,9 @@ void TimeNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext& context,
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+bool TimeNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != "fps";
+}
+
 } // namespace MaterialX
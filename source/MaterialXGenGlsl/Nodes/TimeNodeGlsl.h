@@ -20,6 +20,8 @@ public:
     void createVariables(const ShaderNode& node, GenContext& context, Shader& shader) const override;
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
+
+    bool isUsed(const ShaderInput& input, const GenContext& context) const override;
 };
 
 } // namespace MaterialX
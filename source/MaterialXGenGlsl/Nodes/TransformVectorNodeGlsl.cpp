@@ -87,4 +87,9 @@ string TransformVectorNodeGlsl::getHomogeneousCoordinate(const ShaderInput* in,
     return "vec4(" + shadergen.getUpstreamResult(in, context) + ", 0.0)";
 }
 
+bool TransformVectorNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != TO_SPACE && input.getName() != FROM_SPACE;
+}
+
 } // namespace MaterialX
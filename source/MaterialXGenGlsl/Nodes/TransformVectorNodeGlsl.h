@@ -21,6 +21,8 @@ public:
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    bool isUsed(const ShaderInput& input, const GenContext& context) const override;
+
 protected:
     virtual const string& getMatrix(const string& fromSpace, const string& toSpace) const;
     virtual string getHomogeneousCoordinate(const ShaderInput* in, GenContext& context) const;
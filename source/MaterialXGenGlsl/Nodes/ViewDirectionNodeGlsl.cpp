@@ -51,4 +51,9 @@ void ViewDirectionNodeGlsl::emitFunctionCall(const ShaderNode& node, GenContext&
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+bool ViewDirectionNodeGlsl::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return input.getName() != SPACE;
+}
+
 } // namespace MaterialX
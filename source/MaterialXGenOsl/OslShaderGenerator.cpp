@@ -170,6 +170,8 @@ OslShaderGenerator::OslShaderGenerator() :
 
 ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "OslShaderGenerator::generate");
+
     ShaderPtr shader = createShader(name, element, context);
 
     const ShaderGraph& graph = shader->getGraph();
@@ -277,6 +279,8 @@ ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, G
 
 ShaderPtr OslShaderGenerator::createShader(const string& name, ElementPtr element, GenContext& context) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "OslShaderGenerator::createShader");
+
     // Create the root shader graph
     ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
     ShaderPtr shader = std::make_shared<Shader>(name, graph);
@@ -288,9 +292,12 @@ ShaderPtr OslShaderGenerator::createShader(const string& name, ElementPtr elemen
     stage->createOutputBlock(OSL::OUTPUTS);
 
     // Create shader variables for all nodes that need this.
-    for (ShaderNode* node : graph->getNodes())
     {
-        node->getImplementation().createVariables(*node, context, *shader);
+        GenProfilerScope variablesScope(context.getProfiler(), GenProfiler::PHASE, "OslShaderGenerator::createVariables");
+        for (ShaderNode* node : graph->getNodes())
+        {
+            node->getImplementation().createVariables(*node, context, *shader);
+        }
     }
 
     // Create uniforms for the published graph interface.
@@ -0,0 +1,51 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/GenArena.h>
+
+#include <algorithm>
+
+namespace MaterialX
+{
+
+const size_t GenArena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+GenArenaPtr GenArena::create(size_t blockSize)
+{
+    return GenArenaPtr(new GenArena(blockSize));
+}
+
+GenArena::GenArena(size_t blockSize) :
+    _blockSize(blockSize),
+    _current(nullptr),
+    _remaining(0),
+    _numAllocations(0),
+    _numBytes(0)
+{
+}
+
+void* GenArena::allocate(size_t size, size_t alignment)
+{
+    size_t padding = _current ? (alignment - reinterpret_cast<size_t>(_current) % alignment) % alignment : 0;
+    if (!_current || padding + size > _remaining)
+    {
+        // Start a new block, large enough for the requested size.
+        // Blocks from operator new are aligned for any fundamental type.
+        const size_t blockSize = std::max(_blockSize, size + alignment);
+        _blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+        _current = _blocks.back().get();
+        _remaining = blockSize;
+        padding = (alignment - reinterpret_cast<size_t>(_current) % alignment) % alignment;
+    }
+
+    void* ptr = _current + padding;
+    _current += padding + size;
+    _remaining -= padding + size;
+    _numAllocations++;
+    _numBytes += size;
+    return ptr;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,139 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_GENARENA_H
+#define MATERIALX_GENARENA_H
+
+/// @file
+/// Arena allocation for shader generation
+
+#include <MaterialXGenShader/Library.h>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a GenArena
+using GenArenaPtr = shared_ptr<class GenArena>;
+
+/// @class GenArena
+/// A memory arena for the many small objects created during shader generation.
+///
+/// Memory is handed out from large blocks and is never reused. All blocks are
+/// released together when the arena is destroyed, which happens when the last
+/// object allocated from it is released, since each object keeps a reference
+/// to its arena. An arena should therefore be used for a single generation or
+/// batch of generations, after which a new arena is started.
+///
+/// An arena is not thread safe, and should only be used by a single context.
+class GenArena
+{
+  public:
+    /// Create a new arena, allocating blocks of the given size.
+    static GenArenaPtr create(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// Return memory for an object of the given size and alignment.
+    void* allocate(size_t size, size_t alignment);
+
+    /// Return the number of allocations made from the arena.
+    size_t numAllocations() const
+    {
+        return _numAllocations;
+    }
+
+    /// Return the number of bytes allocated from the arena.
+    size_t numBytes() const
+    {
+        return _numBytes;
+    }
+
+    /// Return the number of blocks allocated by the arena.
+    size_t numBlocks() const
+    {
+        return _blocks.size();
+    }
+
+    /// Default size of blocks allocated by the arena.
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+  protected:
+    /// Protected constructor
+    GenArena(size_t blockSize);
+
+    size_t _blockSize;
+    vector<std::unique_ptr<char[]>> _blocks;
+    char* _current;
+    size_t _remaining;
+    size_t _numAllocations;
+    size_t _numBytes;
+};
+
+/// @class GenArenaAllocator
+/// A standard allocator using a GenArena, or the heap if no arena is given.
+/// Deallocation of arena memory is deferred to the destruction of the arena.
+template<class T> class GenArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    GenArenaAllocator(GenArenaPtr arena) :
+        _arena(arena)
+    {
+    }
+
+    template<class U> GenArenaAllocator(const GenArenaAllocator<U>& other) :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (_arena)
+        {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t)
+    {
+        if (!_arena)
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    const GenArenaPtr& getArena() const
+    {
+        return _arena;
+    }
+
+    template<class U> bool operator==(const GenArenaAllocator<U>& other) const
+    {
+        return _arena == other.getArena();
+    }
+
+    template<class U> bool operator!=(const GenArenaAllocator<U>& other) const
+    {
+        return _arena != other.getArena();
+    }
+
+  private:
+    GenArenaPtr _arena;
+};
+
+/// Create an object sharing a single allocation with its reference count,
+/// using the given arena, or the heap if no arena is given.
+template<class T, class... Args> shared_ptr<T> allocateShared(GenArenaPtr arena, Args&&... args)
+{
+    if (arena)
+    {
+        return std::allocate_shared<T>(GenArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+} // namespace MaterialX
+
+#endif
@@ -11,7 +11,11 @@
 
 #include <MaterialXGenShader/Library.h>
 
+#include <MaterialXGenShader/GenArena.h>
 #include <MaterialXGenShader/GenOptions.h>
+#include <MaterialXGenShader/GenProfiler.h>
+#include <MaterialXGenShader/ShaderFunctionLibrary.h>
+#include <MaterialXGenShader/ShaderGraphCache.h>
 #include <MaterialXGenShader/ShaderNode.h>
 
 #include <MaterialXFormat/File.h>
@@ -123,6 +127,63 @@ class GenContext
     /// Clear all cached shader node implementation.
     void clearNodeImplementations();
 
+    /// Set a function library to share function definitions
+    /// between shaders, or nullptr to disable sharing.
+    void setFunctionLibrary(ShaderFunctionLibraryPtr library)
+    {
+        _functionLibrary = library;
+    }
+
+    /// Return the function library used for sharing function
+    /// definitions, or nullptr if no library is set.
+    ShaderFunctionLibraryPtr getFunctionLibrary() const
+    {
+        return _functionLibrary;
+    }
+
+    /// Set a cache for the graphs of nodes implemented by nodegraphs,
+    /// or nullptr to disable caching.
+    void setGraphCache(ShaderGraphCachePtr cache)
+    {
+        _graphCache = cache;
+    }
+
+    /// Return the cache used for the graphs of nodes implemented
+    /// by nodegraphs, or nullptr if no cache is set.
+    ShaderGraphCachePtr getGraphCache() const
+    {
+        return _graphCache;
+    }
+
+    /// Set an arena for allocating the nodes and ports of shader graphs,
+    /// or nullptr to allocate them from the heap. Graphs keep their arena
+    /// alive, so a new arena can be set for each generation or batch.
+    void setArena(GenArenaPtr arena)
+    {
+        _arena = arena;
+    }
+
+    /// Return the arena used for allocating the nodes and ports of
+    /// shader graphs, or nullptr if they are allocated from the heap.
+    GenArenaPtr getArena() const
+    {
+        return _arena;
+    }
+
+    /// Set a profiler to collect timings and counters
+    /// during shader generation, or nullptr to disable profiling.
+    void setProfiler(GenProfilerPtr profiler)
+    {
+        _profiler = profiler;
+    }
+
+    /// Return the profiler used during shader generation,
+    /// or nullptr if profiling is disabled.
+    GenProfiler* getProfiler() const
+    {
+        return _profiler.get();
+    }
+
     /// Add user data to the context to make it
     /// available during shader generator.
     void pushUserData(const string& name, GenUserDataPtr data)
@@ -201,6 +262,18 @@ class GenContext
     // Cached shader node implementations.
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
 
+    // Function library for shared function definitions.
+    ShaderFunctionLibraryPtr _functionLibrary;
+
+    // Cache of graphs for nodegraph implementations.
+    ShaderGraphCachePtr _graphCache;
+
+    // Arena for shader graph allocations.
+    GenArenaPtr _arena;
+
+    // Profiler for shader generation.
+    GenProfilerPtr _profiler;
+
     // User data
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
 
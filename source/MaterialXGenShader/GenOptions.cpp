@@ -13,7 +13,12 @@ GenOptions::GenOptions() :
     fileTextureVerticalFlip(false),
     hwTransparency(false),
     hwSpecularEnvironmentMethod(SPECULAR_ENVIRONMENT_FIS),
-    hwMaxActiveLightSources(3)
+    hwMaxActiveLightSources(3),
+    hwLightLoopHoisting(false),
+    optimizationLevel(1),
+    convolutionSamplingMethod(CONVOLUTION_SAMPLING_FULL),
+    flattenSubgraphs(false),
+    bakeUniforms(false)
 {
 }
 GenOptions::~GenOptions()
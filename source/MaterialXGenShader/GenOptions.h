@@ -46,6 +46,24 @@ enum HwSpecularEnvironmentMethod
     SPECULAR_ENVIRONMENT_PREFILTER
 };
 
+/// Method to use for sampling the upstream graph in convolution nodes
+enum ConvolutionSamplingMethod
+{
+    /// Evaluate the upstream graph once for every weight in the
+    /// filter kernel, and apply the weights at runtime.
+    /// This is the default method.
+    CONVOLUTION_SAMPLING_FULL,
+
+    /// Factor separable filter kernels into per-axis weights which are
+    /// baked into the shader code. If the upstream is a file texture with
+    /// a constant linear filter type, hardware shaders also merge pairs of
+    /// neighboring samples into a single sample placed between them, which
+    /// halves the sample count along each axis. This is only exact when
+    /// samples are one texel apart and centered on texels, so it's checked
+    /// at runtime, and the samples are not merged otherwise.
+    CONVOLUTION_SAMPLING_SEPARABLE
+};
+
 /// @class GenOptions 
 /// Class holding options to configure shader generation.
 class GenOptions
@@ -54,10 +72,6 @@ class GenOptions
     GenOptions();
     virtual ~GenOptions();
 
-    // TODO: Add options for:
-    //  - shader gen optimization level
-    //  - graph flattening or not
-
     /// Sets the type of shader interface to be generated
     int shaderInterfaceType;
 
@@ -86,6 +100,51 @@ class GenOptions
     /// Sets the maximum number of light sources that can
     /// be active at once.
     unsigned int hwMaxActiveLightSources;
+
+    /// If true, BSDF nodes implemented by nodegraphs are inlined into the
+    /// shader graph of the parent. The light-independent texture nodes in
+    /// these graphs are then evaluated once, before the light loop, instead
+    /// of once per light source inside the BSDF functions.
+    /// By default this option is false.
+    bool hwLightLoopHoisting;
+
+    /// Sets the level of optimization to apply to shader graphs:
+    ///  0 - No optimization. Gives the fastest generation, e.g. for interactive editing.
+    ///  1 - Remove constant nodes and conditionals with constant conditions,
+    ///      and merge nodes computing identical results.
+    ///  2 - As level 1, but also evaluate constant expressions at generation time,
+    ///      inline nodes implemented by nodegraphs (see flattenSubgraphs and
+    ///      hwLightLoopHoisting), and for hardware targets leave out uniforms
+    ///      published for node inputs which the generated code never reads.
+    /// By default the level is 1.
+    int optimizationLevel;
+
+    /// Sets the method to use for sampling the upstream
+    /// graph in convolution nodes, such as blur.
+    int convolutionSamplingMethod;
+
+    /// If true, nodes implemented by nodegraphs are inlined into the
+    /// shader graph of the parent, instead of being emitted as separate
+    /// functions. This allows optimizations to be applied across the
+    /// nodegraph boundaries. Only texture nodes are inlined, closures
+    /// are inlined by hwLightLoopHoisting and shaders are always emitted
+    /// as functions.
+    /// By default this option is false.
+    bool flattenSubgraphs;
+
+    /// If true, the values of inputs which would otherwise be emitted as
+    /// uniforms are baked into the shader as constants. This specializes the
+    /// shader for final quality rendering, where values will not change,
+    /// and the graph is optimized again with the constant values. Filename
+    /// inputs are always kept as uniforms. The option is applied to the
+    /// shader interface after publishing, so with the complete interface
+    /// the inputs of all nodes are baked.
+    /// By default this option is false.
+    bool bakeUniforms;
+
+    /// The names of the uniforms to bake if bakeUniforms is true,
+    /// or an empty set to bake all uniforms.
+    StringSet bakedUniformNames;
 };
 
 } // namespace MaterialX
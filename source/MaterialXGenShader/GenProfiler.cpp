@@ -0,0 +1,164 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/GenProfiler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace MaterialX
+{
+
+const string GenProfiler::PHASE = "phase";
+const string GenProfiler::FUNCTION_CALL = "functionCall";
+const string GenProfiler::FUNCTION_DEFINITION = "functionDefinition";
+
+namespace
+{
+    string escapeJsonString(const string& str)
+    {
+        string result;
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+}
+
+GenProfilerPtr GenProfiler::create()
+{
+    return GenProfilerPtr(new GenProfiler());
+}
+
+GenProfiler::GenProfiler() :
+    _startTime(Clock::now())
+{
+}
+
+double GenProfiler::now() const
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - _startTime).count();
+}
+
+void GenProfiler::beginEvent(const char* category, const char* name)
+{
+    Event event;
+    event.category = category;
+    event.name = name;
+    event.depth = _openEvents.size();
+    event.duration = 0.0;
+    event.start = now();
+    _openEvents.push_back(event);
+}
+
+void GenProfiler::endEvent()
+{
+    if (_openEvents.empty())
+    {
+        throw ExceptionShaderGenError("No profiler event to end");
+    }
+    Event event = _openEvents.back();
+    _openEvents.pop_back();
+    event.duration = now() - event.start;
+    _events.push_back(event);
+}
+
+void GenProfiler::clear()
+{
+    _openEvents.clear();
+    _events.clear();
+    _counters.clear();
+    _startTime = Clock::now();
+}
+
+string GenProfiler::getSummary() const
+{
+    struct Total
+    {
+        string category;
+        string name;
+        size_t count;
+        double duration;
+    };
+
+    // Sum up the events with the same category and name.
+    std::map<std::pair<string, string>, size_t> totalIndex;
+    vector<Total> totals;
+    for (const Event& event : _events)
+    {
+        auto key = std::make_pair(event.category, event.name);
+        auto it = totalIndex.find(key);
+        if (it == totalIndex.end())
+        {
+            it = totalIndex.insert(std::make_pair(key, totals.size())).first;
+            totals.push_back({ event.category, event.name, 0, 0.0 });
+        }
+        totals[it->second].count++;
+        totals[it->second].duration += event.duration;
+    }
+    std::stable_sort(totals.begin(), totals.end(), [](const Total& a, const Total& b)
+    {
+        return a.duration > b.duration;
+    });
+
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << std::left << std::setw(20) << "Category" << std::setw(48) << "Name"
+           << std::right << std::setw(10) << "Count" << std::setw(14) << "Total (ms)" << std::setw(14) << "Average (ms)" << "\n";
+    for (const Total& total : totals)
+    {
+        stream << std::left << std::setw(20) << total.category << std::setw(48) << total.name
+               << std::right << std::setw(10) << total.count
+               << std::setw(14) << total.duration / 1000.0
+               << std::setw(14) << total.duration / 1000.0 / double(total.count) << "\n";
+    }
+    if (!_counters.empty())
+    {
+        stream << "\n" << std::left << std::setw(68) << "Counter" << std::right << std::setw(10) << "Count" << "\n";
+        for (auto it : _counters)
+        {
+            stream << std::left << std::setw(68) << it.first << std::right << std::setw(10) << it.second << "\n";
+        }
+    }
+    return stream.str();
+}
+
+string GenProfiler::getChromeTrace() const
+{
+    // Events are written as complete events, and the counters as a single
+    // counter event at the end of the trace.
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\":[";
+    string delim = "\n";
+    for (const Event& event : _events)
+    {
+        stream << delim << "{\"name\":\"" << escapeJsonString(event.name) << "\",\"cat\":\"" << escapeJsonString(event.category)
+               << "\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":1}";
+        delim = ",\n";
+    }
+    if (!_counters.empty())
+    {
+        const double end = _events.empty() ? 0.0 : _events.back().start + _events.back().duration;
+        stream << delim << "{\"name\":\"counters\",\"ph\":\"C\",\"ts\":" << end << ",\"pid\":1,\"tid\":1,\"args\":{";
+        string argDelim;
+        for (auto it : _counters)
+        {
+            stream << argDelim << "\"" << escapeJsonString(it.first) << "\":" << it.second;
+            argDelim = ",";
+        }
+        stream << "}}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return stream.str();
+}
+
+} // namespace MaterialX
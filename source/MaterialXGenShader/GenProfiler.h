@@ -0,0 +1,142 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_GENPROFILER_H
+#define MATERIALX_GENPROFILER_H
+
+/// @file
+/// Profiling of shader generation
+
+#include <MaterialXGenShader/Library.h>
+
+#include <chrono>
+#include <map>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a GenProfiler
+using GenProfilerPtr = shared_ptr<class GenProfiler>;
+
+/// @class GenProfiler
+/// Class collecting timings and counters during shader generation.
+///
+/// Timings are recorded as nested events, each with a category and a name.
+/// Generation phases are recorded in the PHASE category, and the work done by
+/// each node implementation in the FUNCTION_CALL and FUNCTION_DEFINITION
+/// categories, named by the implementation. Counters record the number of
+/// objects allocated for shader graphs.
+///
+/// Set a profiler on a GenContext to enable profiling. Without a profiler
+/// the instrumentation only costs a pointer test per scope.
+class GenProfiler
+{
+  public:
+    /// A timed event.
+    struct Event
+    {
+        /// Event category.
+        string category;
+        /// Event name.
+        string name;
+        /// Start time in microseconds, relative to the creation of the profiler.
+        double start;
+        /// Duration in microseconds.
+        double duration;
+        /// Nesting depth of the event.
+        size_t depth;
+    };
+
+    /// Create a new profiler.
+    static GenProfilerPtr create();
+
+    /// Begin a new event, nested in any event currently open.
+    void beginEvent(const char* category, const char* name);
+
+    /// End the event most recently begun.
+    void endEvent();
+
+    /// Add to the counter with the given name.
+    void addCount(const char* name, size_t count = 1)
+    {
+        _counters[name] += count;
+    }
+
+    /// Return all completed events, in the order they were ended.
+    const vector<Event>& getEvents() const
+    {
+        return _events;
+    }
+
+    /// Return all counters.
+    const std::map<string, size_t>& getCounters() const
+    {
+        return _counters;
+    }
+
+    /// Clear all events and counters.
+    void clear();
+
+    /// Return a summary table with the total time, call count and average
+    /// time for each event name, sorted by total time, followed by all counters.
+    string getSummary() const;
+
+    /// Return the events and counters in the Chrome trace event format,
+    /// for display in chrome://tracing or compatible trace viewers.
+    string getChromeTrace() const;
+
+    /// Category for shader generation phases.
+    static const string PHASE;
+    /// Category for emitting node function calls.
+    static const string FUNCTION_CALL;
+    /// Category for emitting node function definitions.
+    static const string FUNCTION_DEFINITION;
+
+  protected:
+    /// Protected constructor
+    GenProfiler();
+
+    double now() const;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point _startTime;
+    vector<Event> _openEvents;
+    vector<Event> _events;
+    std::map<string, size_t> _counters;
+};
+
+/// @class GenProfilerScope
+/// Records an event for the lifetime of the scope,
+/// if profiling is enabled.
+class GenProfilerScope
+{
+  public:
+    GenProfilerScope(GenProfiler* profiler, const string& category, const char* name) :
+        _profiler(profiler)
+    {
+        if (_profiler)
+        {
+            _profiler->beginEvent(category.c_str(), name);
+        }
+    }
+
+    ~GenProfilerScope()
+    {
+        if (_profiler)
+        {
+            _profiler->endEvent();
+        }
+    }
+
+  private:
+    GenProfilerScope(const GenProfilerScope&) = delete;
+    GenProfilerScope& operator=(const GenProfilerScope&) = delete;
+
+    GenProfiler* _profiler;
+};
+
+} // namespace MaterialX
+
+#endif
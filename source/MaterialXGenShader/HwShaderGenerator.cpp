@@ -36,6 +36,25 @@ namespace HW
     const string USER_DATA_LIGHT_SHADERS   = "udls";
 }
 
+namespace
+{
+    // Return true if the code emitted for a graph reads the given input socket.
+    // Nodes are emitted whether or not their outputs are read, so the socket
+    // is read if any node reads an input it is connected to.
+    bool isUsed(const ShaderGraphInputSocket& inputSocket, const ShaderGraph& graph, const GenContext& context)
+    {
+        for (const ShaderInput* input : inputSocket.getConnections())
+        {
+            const ShaderNode* node = input->getNode();
+            if (node == &graph || node->isUsed(*input, context))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
 //
 // HwShaderGenerator methods
 //
@@ -66,6 +85,8 @@ HwShaderGenerator::HwShaderGenerator(SyntaxPtr syntax) :
 
 ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element, GenContext& context) const
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "HwShaderGenerator::createShader");
+
     // Create the root shader graph
     ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
     ShaderPtr shader = std::make_shared<Shader>(name, graph);
@@ -116,12 +137,21 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
     }
 
     // Create uniforms for the published graph interface
+    const bool removeUnused = context.getOptions().optimizationLevel > 1;
     for (ShaderGraphInputSocket* inputSocket : graph->getInputSockets())
     {
         // Only for inputs that are connected/used internally,
         // and are editable by users.
         if (!inputSocket->getConnections().empty() && graph->isEditable(*inputSocket))
         {
+            // At the highest optimization level, inputs published for a complete
+            // interface are left out if the emitted code never reads them.
+            // Inputs on the interface of the element are always kept.
+            if (removeUnused && (inputSocket->getFlags() & ShaderPort::AUTO_PUBLISHED) &&
+                !isUsed(*inputSocket, *graph, context))
+            {
+                continue;
+            }
             psPublicUniforms->add(inputSocket->getSelf());
         }
     }
@@ -134,23 +164,27 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
     output->setVariable(outputSocket->getVariable());
     output->setPath(outputSocket->getPath());
 
-    // Create shader variables for all nodes that need this.
-    for (ShaderNode* node : graph->getNodes())
-    {
-        node->getImplementation().createVariables(*node, context, *shader);
-    }
-
     HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
 
-    // For surface shaders we need light shaders
-    if (lightShaders && graph->hasClassification(ShaderNode::Classification::SHADER | ShaderNode::Classification::SURFACE))
     {
-        // Create shader variables for all bound light shaders
-        for (auto it : lightShaders->get())
+        GenProfilerScope variablesScope(context.getProfiler(), GenProfiler::PHASE, "HwShaderGenerator::createVariables");
+
+        // Create shader variables for all nodes that need this.
+        for (ShaderNode* node : graph->getNodes())
         {
-            ShaderNode* node = it.second.get();
             node->getImplementation().createVariables(*node, context, *shader);
         }
+
+        // For surface shaders we need light shaders
+        if (lightShaders && graph->hasClassification(ShaderNode::Classification::SHADER | ShaderNode::Classification::SURFACE))
+        {
+            // Create shader variables for all bound light shaders
+            for (auto it : lightShaders->get())
+            {
+                ShaderNode* node = it.second.get();
+                node->getImplementation().createVariables(*node, context, *shader);
+            }
+        }
     }
 
     //
@@ -8,7 +8,9 @@
 #include <MaterialXGenShader/ShaderNode.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/Syntax.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace MaterialX
@@ -56,6 +58,88 @@ void BlurNode::computeSampleOffsetStrings(const string& sampleSizeName, const st
     }
 }
 
+void BlurNode::emitSeparableFilter(const ShaderNode& node, const vector<float>& weights,
+                                   GenContext& context, ShaderStage& stage) const
+{
+    // Neighboring samples can only be merged if the upstream texture interpolates
+    // linearly between them, which requires them to be one texel apart. The sample
+    // size depends on screen derivatives, so this is checked at runtime.
+    const string mergeCondition = getSampleMergeCondition(node, filterSize, filterOffset, sampleSizeFunctionUV, context);
+    if (mergeCondition.empty())
+    {
+        emitSeparableSamples(node, weights, false, context, stage);
+        return;
+    }
+
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    shadergen.emitLine("if (" + mergeCondition + ")", stage, false);
+    shadergen.emitScopeBegin(stage);
+    emitSeparableSamples(node, weights, true, context, stage);
+    shadergen.emitScopeEnd(stage);
+    shadergen.emitLine("else", stage, false);
+    shadergen.emitScopeBegin(stage);
+    emitSeparableSamples(node, weights, false, context, stage);
+    shadergen.emitScopeEnd(stage);
+}
+
+void BlurNode::emitSeparableSamples(const ShaderNode& node, const vector<float>& weights, bool mergeSamples,
+                                    GenContext& context, ShaderStage& stage) const
+{
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    const Syntax& syntax = shadergen.getSyntax();
+    const ShaderOutput* output = node.getOutput();
+
+    vector<float> offsets, sampleWeights;
+    computeSeparableSamples(weights, mergeSamples, offsets, sampleWeights);
+
+    vector<Vector2> sampleOffsets;
+    for (float row : offsets)
+    {
+        for (float col : offsets)
+        {
+            sampleOffsets.push_back(Vector2(col, row));
+        }
+    }
+    StringVec sampleStrings;
+    emitInputSamplesUV(node, sampleOffsets,
+                       filterSize, filterOffset, sampleSizeFunctionUV,
+                       context, stage, sampleStrings);
+    if (sampleStrings.size() != sampleOffsets.size())
+    {
+        throw ExceptionShaderGenError("Node '" + node.getName() + "' cannot compute upstream samples");
+    }
+
+    // If the upstream could not be sampled at the offsets,
+    // all samples are the same and there is nothing to filter.
+    if (std::equal(sampleStrings.begin() + 1, sampleStrings.end(), sampleStrings.begin()))
+    {
+        shadergen.emitLine(output->getVariable() + " = " + sampleStrings[0], stage);
+        return;
+    }
+
+    StringVec weightStrings;
+    for (float weight : sampleWeights)
+    {
+        weightStrings.push_back(syntax.getValue(Type::FLOAT, *Value::createValue(weight)));
+    }
+
+    const string& inputTypeString = syntax.getTypeName(node.getInput(IN_STRING)->getType());
+    const size_t count = sampleWeights.size();
+    string result;
+    for (size_t row = 0; row < count; row++)
+    {
+        const string rowName = output->getVariable() + "_row" + std::to_string(row);
+        string rowResult;
+        for (size_t col = 0; col < count; col++)
+        {
+            rowResult += (col > 0 ? " + " : "") + sampleStrings[row * count + col] + " * " + weightStrings[col];
+        }
+        shadergen.emitLine(inputTypeString + " " + rowName + " = " + rowResult, stage);
+        result += (row > 0 ? " + " : "") + rowName + " * " + weightStrings[row];
+    }
+    shadergen.emitLine(output->getVariable() + " = " + result, stage);
+}
+
 bool BlurNode::acceptsInputType(const TypeDesc* type) const
 {
     // Float 1-4 is acceptable as input
@@ -110,6 +194,50 @@ void BlurNode::emitFunctionCall(const ShaderNode& node, GenContext& context, Sha
         // Sample count is square of filter size
         const unsigned int sampleCount = filterWidth*filterWidth;
 
+        const ShaderOutput* output = node.getOutput();
+
+        // Use separable filters with weights baked into the code if requested.
+        if (sampleCount > 1 && context.getOptions().convolutionSamplingMethod == CONVOLUTION_SAMPLING_SEPARABLE)
+        {
+            vector<float> gaussianWeights;
+            getGaussianWeights(filterWidth, gaussianWeights);
+            const vector<float> boxWeights(filterWidth, 1.0f / float(filterWidth));
+
+            shadergen.emitLineBegin(stage);
+            shadergen.emitOutput(output, true, false, context, stage);
+            shadergen.emitLineEnd(stage);
+
+            // The filter type can only be selected at generation time
+            // if it's not connected to a uniform or an upstream node.
+            if (!filterTypeInput->getConnection())
+            {
+                const bool gaussian = hasEnumValue(filterTypeInput, GAUSSIAN_FILTER, 1);
+                emitSeparableFilter(node, gaussian ? gaussianWeights : boxWeights, context, stage);
+                return;
+            }
+
+            shadergen.emitLineBegin(stage);
+            shadergen.emitString("if (", stage);
+            shadergen.emitInput(filterTypeInput, context, stage);
+            if (shadergen.getSyntax().typeSupported(Type::STRING))
+            {
+                shadergen.emitString(" == \"" + GAUSSIAN_FILTER + "\")", stage);
+            }
+            else
+            {
+                shadergen.emitString(" == 1)", stage);
+            }
+            shadergen.emitLineEnd(stage, false);
+            shadergen.emitScopeBegin(stage);
+            emitSeparableFilter(node, gaussianWeights, context, stage);
+            shadergen.emitScopeEnd(stage);
+            shadergen.emitLine("else", stage, false);
+            shadergen.emitScopeBegin(stage);
+            emitSeparableFilter(node, boxWeights, context, stage);
+            shadergen.emitScopeEnd(stage);
+            return;
+        }
+
         // Check for type of filter to apply
         // Default to box filter
         //
@@ -142,8 +270,6 @@ void BlurNode::emitFunctionCall(const ShaderNode& node, GenContext& context, Sha
             throw ExceptionShaderGenError("Node '" + node.getName() + "' cannot compute upstream samples");
         }
 
-        const ShaderOutput* output = node.getOutput();
-
         if (sampleCount > 1)
         {
             const string MX_MAX_SAMPLE_COUNT_STRING("MX_MAX_SAMPLE_COUNT");
@@ -30,6 +30,19 @@ class BlurNode : public ConvolutionNode
     void computeSampleOffsetStrings(const string& sampleSizeName, const string& offsetTypeString,
                                     unsigned int filterWidth, StringVec& offsetStrings) const override;
 
+    /// Emit code to filter the input with a separable kernel with the given per-axis
+    /// weights. The samples are weighted along each row first, and the row results
+    /// are then weighted along the columns, as in a two-pass filter.
+    /// If the input is a linearly filtered texture, pairs of samples are merged
+    /// when they are one texel apart, which is checked at runtime.
+    void emitSeparableFilter(const ShaderNode& node, const vector<float>& weights,
+                             GenContext& context, ShaderStage& stage) const;
+
+    /// Emit code to filter the input with a separable kernel, optionally merging
+    /// pairs of neighboring samples into single linearly filtered samples.
+    void emitSeparableSamples(const ShaderNode& node, const vector<float>& weights, bool mergeSamples,
+                              GenContext& context, ShaderStage& stage) const;
+
     /// Box filter option on blur
     static const string BOX_FILTER;
     /// Box filter weights variable name
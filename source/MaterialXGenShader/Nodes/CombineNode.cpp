@@ -130,4 +130,20 @@ void CombineNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+ValuePtr CombineNode::evaluateConstant(const ShaderNode& node, GenContext&) const
+{
+    // The components of the input values, in order,
+    // make up the components of the output value.
+    string valueString;
+    for (const ShaderInput* input : node.getInputs())
+    {
+        if (!input->getValue())
+        {
+            return nullptr;
+        }
+        valueString += (valueString.empty() ? EMPTY_STRING : ", ") + input->getValue()->getValueString();
+    }
+    return Value::createValueFromStrings(valueString, node.getOutput()->getType()->getName());
+}
+
 } // namespace MaterialX
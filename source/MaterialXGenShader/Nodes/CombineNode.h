@@ -18,6 +18,9 @@ class CombineNode : public ShaderNodeImpl
     static ShaderNodeImplPtr create();
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
+
+    /// Evaluate the combined value of constant inputs.
+    ValuePtr evaluateConstant(const ShaderNode& node, GenContext& context) const override;
 };
 
 } // namespace MaterialX
@@ -15,6 +15,50 @@
 namespace MaterialX
 {
 
+namespace
+{
+    // Return a string identifying the signature and contents of a compound graph.
+    string getGraphSignature(const ShaderGraph& graph)
+    {
+        auto connectionString = [](const ShaderOutput* connection)
+        {
+            return connection->getNode()->getName() + "." + connection->getName();
+        };
+        auto valueString = [](const ShaderPort* port)
+        {
+            return port->getValue() ? port->getValue()->getValueString() : EMPTY_STRING;
+        };
+
+        string signature = graph.getName() + "(";
+        for (const ShaderGraphInputSocket* inputSocket : graph.getInputSockets())
+        {
+            signature += inputSocket->getType()->getName() + " " + inputSocket->getVariable() + " " + valueString(inputSocket) + ",";
+        }
+        for (const ShaderGraphOutputSocket* outputSocket : graph.getOutputSockets())
+        {
+            signature += outputSocket->getType()->getName() + " " + outputSocket->getVariable() + " ";
+            signature += outputSocket->getConnection() ? connectionString(outputSocket->getConnection()) : valueString(outputSocket);
+            signature += ",";
+        }
+        signature += ")\n";
+        for (const ShaderNode* node : graph.getNodes())
+        {
+            signature += node->getName() + " " + std::to_string(node->getImplementation().getHash()) + "\n";
+            for (const ShaderInput* input : node->getInputs())
+            {
+                signature += "  " + input->getName() + " " + input->getType()->getName() + " ";
+                signature += input->getConnection() ? connectionString(input->getConnection()) : valueString(input);
+                signature += "\n";
+            }
+            for (const ShaderOutput* output : node->getOutputs())
+            {
+                signature += "  " + output->getName() + " " + output->getType()->getName() + "\n";
+            }
+        }
+        return signature;
+    }
+}
+
 ShaderNodeImplPtr CompoundNode::create()
 {
     return std::make_shared<CompoundNode>();
@@ -35,15 +79,21 @@ void CompoundNode::initialize(const InterfaceElement& element, GenContext& conte
     context.getShaderGenerator().getSyntax().makeValidName(_functionName);
 
     // For compounds we do not want to publish all internal inputs
-    // so always use the reduced interface for this graph.
+    // so always use the reduced interface for this graph. The interface
+    // is made of function arguments, so no uniforms are baked either.
     const int oldShaderInterfaceType = context.getOptions().shaderInterfaceType;
+    const bool oldBakeUniforms = context.getOptions().bakeUniforms;
     context.getOptions().shaderInterfaceType = SHADER_INTERFACE_REDUCED;
-    _rootGraph = ShaderGraph::create(nullptr, graph, context);
+    context.getOptions().bakeUniforms = false;
+    ShaderGraphCachePtr graphCache = context.getGraphCache();
+    _rootGraph = graphCache ? graphCache->createGraph(graph, context) : ShaderGraph::create(nullptr, graph, context);
     context.getOptions().shaderInterfaceType = oldShaderInterfaceType;
+    context.getOptions().bakeUniforms = oldBakeUniforms;
 
-    // Set hash using the function name.
-    // TODO: Could be improved to include the full function signature.
-    _hash = std::hash<string>{}(_functionName);
+    // Set hash using the function signature and the contents of the graph,
+    // so that graphs with the same name from different documents are only
+    // considered equal if they generate the same function.
+    _hash = std::hash<string>{}(getGraphSignature(*_rootGraph));
 }
 
 void CompoundNode::createVariables(const ShaderNode&, GenContext& context, Shader& shader) const
@@ -13,12 +13,11 @@
 namespace MaterialX
 {
 
-ShaderNodeImplPtr ConvertNode::create()
-{
-    return std::make_shared<ConvertNode>();
-}
+static const string IN_STRING("in");
 
-void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
+// Return the swizzle pattern for converting between two types,
+// or nullptr if the conversion is not supported.
+static const string* getConversionSwizzle(const TypeDesc* from, const TypeDesc* to)
 {
     using ConvertTable = std::unordered_map<const TypeDesc*, std::unordered_map<const TypeDesc*, string> >;
 
@@ -78,8 +77,25 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
         }
     });
 
-    static const string IN_STRING("in");
+    auto i = CONVERT_TABLE.find(from);
+    if (i != CONVERT_TABLE.end())
+    {
+        auto j = i->second.find(to);
+        if (j != i->second.end())
+        {
+            return &j->second;
+        }
+    }
+    return nullptr;
+}
+
+ShaderNodeImplPtr ConvertNode::create()
+{
+    return std::make_shared<ConvertNode>();
+}
 
+void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
+{
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
         const ShaderGenerator& shadergen = context.getShaderGenerator();
 
@@ -106,16 +122,7 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
         else
         {
             // Search the conversion table for a swizzle pattern to use.
-            const string* swizzle = nullptr;
-            auto i = CONVERT_TABLE.find(in->getType());
-            if (i != CONVERT_TABLE.end())
-            {
-                auto j = i->second.find(out->getType());
-                if (j != i->second.end())
-                {
-                    swizzle = &j->second;
-                }
-            }
+            const string* swizzle = getConversionSwizzle(in->getType(), out->getType());
             if (!swizzle || swizzle->empty())
             {
                 throw ExceptionShaderGenError("Conversion from '" + in->getType()->getName() + "' to '" + out->getType()->getName() + "' is not supported by convert node");
@@ -141,4 +148,20 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+ValuePtr ConvertNode::evaluateConstant(const ShaderNode& node, GenContext& context) const
+{
+    const ShaderInput* in = node.getInput(IN_STRING);
+    const ShaderOutput* out = node.getOutput();
+    if (!in || !out || !in->getValue())
+    {
+        return nullptr;
+    }
+    const string* swizzle = getConversionSwizzle(in->getType(), out->getType());
+    if (!swizzle || swizzle->empty())
+    {
+        return nullptr;
+    }
+    return context.getShaderGenerator().getSyntax().getSwizzledValue(in->getValue(), in->getType(), *swizzle, out->getType());
+}
+
 } // namespace MaterialX
@@ -18,6 +18,9 @@ class ConvertNode : public ShaderNodeImpl
     static ShaderNodeImplPtr create();
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
+
+    /// Evaluate the converted value of a constant input.
+    ValuePtr evaluateConstant(const ShaderNode& node, GenContext& context) const override;
 };
 
 } // namespace MaterialX
@@ -5,6 +5,7 @@
 
 #include <MaterialXGenShader/Nodes/ConvolutionNode.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/ShaderNode.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
@@ -42,6 +43,20 @@ namespace MaterialX
 const string ConvolutionNode::SAMPLE2D_INPUT = "texcoord";
 const string ConvolutionNode::SAMPLE3D_INPUT = "position";
 
+namespace
+{
+    const string IN_INPUT = "in";
+    const string FILTERTYPE_INPUT = "filtertype";
+    const string FILE_INPUT = "file";
+    const string LINEAR_FILTER = "linear";
+    const int LINEAR_FILTER_INDEX = 1;
+
+    /// Name of function returning true if samples spaced by a sample size are
+    /// one texel apart and centered on texels. Takes a texture sampler, uv and
+    /// sample size as input.
+    const string TEXEL_ALIGNED_FUNCTION = "mx_is_texel_aligned";
+}
+
 ConvolutionNode::ConvolutionNode()
 {
 }
@@ -75,6 +90,60 @@ void ConvolutionNode::createVariables(const ShaderNode&, GenContext&, Shader& sh
     constants.add(Type::FLOATARRAY, "c_gaussian_filter_weights", Value::createValue<vector<float>>(GAUSSIAN_WEIGHT_ARRAY));
 }
 
+void ConvolutionNode::getGaussianWeights(unsigned int filterWidth, vector<float>& weights)
+{
+    // Find the kernel in the weight array, which holds the
+    // kernels of width 1, 3, 5 and 7 after each other.
+    size_t arrayOffset = 0;
+    for (unsigned int width = 1; width < filterWidth; width += 2)
+    {
+        arrayOffset += width * width;
+    }
+    if (filterWidth % 2 == 0 || arrayOffset + filterWidth * filterWidth > GAUSSIAN_WEIGHT_ARRAY.size())
+    {
+        throw ExceptionShaderGenError("Unsupported Gaussian filter width: " + std::to_string(filterWidth));
+    }
+
+    // The kernels are separable, so the per-axis
+    // weights are given by the sums over the rows.
+    weights.assign(filterWidth, 0.0f);
+    for (unsigned int row = 0; row < filterWidth; row++)
+    {
+        for (unsigned int col = 0; col < filterWidth; col++)
+        {
+            weights[row] += GAUSSIAN_WEIGHT_ARRAY[arrayOffset + row * filterWidth + col];
+        }
+    }
+}
+
+void ConvolutionNode::computeSeparableSamples(const vector<float>& weights, bool mergeSamples,
+                                              vector<float>& sampleOffsets, vector<float>& sampleWeights)
+{
+    sampleOffsets.clear();
+    sampleWeights.clear();
+
+    const int w = static_cast<int>(weights.size()) / 2;
+    const size_t step = mergeSamples ? 2 : 1;
+    for (size_t i = 0; i < weights.size(); i += step)
+    {
+        float offset = float(int(i) - w);
+        float weight = weights[i];
+        if (i + 1 < weights.size() && mergeSamples)
+        {
+            // Place the sample so that linear interpolation gives
+            // each of the two neighbors its original weight.
+            const float nextWeight = weights[i + 1];
+            weight += nextWeight;
+            if (weight > 0.0f)
+            {
+                offset += nextWeight / weight;
+            }
+        }
+        sampleOffsets.push_back(offset);
+        sampleWeights.push_back(weight);
+    }
+}
+
 /// Get input which is used for sampling. If there is none
 /// then a null pointer is returned.
 const ShaderInput* ConvolutionNode::getSamplingInput(const ShaderNode& node) const
@@ -93,19 +162,96 @@ const ShaderInput* ConvolutionNode::getSamplingInput(const ShaderNode& node) con
     return nullptr;
 }
 
+bool ConvolutionNode::hasEnumValue(const ShaderInput* input, const string& value, int index)
+{
+    const ValuePtr inputValue = input ? input->getValue() : nullptr;
+    if (!inputValue)
+    {
+        return false;
+    }
+    return inputValue->isA<int>() ? inputValue->asA<int>() == index : inputValue->getValueString() == value;
+}
+
+bool ConvolutionNode::hasLinearUpstream(const ShaderNode& node) const
+{
+    const ShaderInput* inInput = node.getInput(IN_INPUT);
+    const ShaderOutput* inConnection = inInput ? inInput->getConnection() : nullptr;
+    const ShaderNode* upstreamNode = inConnection ? inConnection->getNode() : nullptr;
+    if (!upstreamNode || !upstreamNode->hasClassification(ShaderNode::Classification::IMAGE))
+    {
+        return false;
+    }
+    // A filter type which is connected or published can change at runtime.
+    const ShaderInput* filterTypeInput = upstreamNode->getInput(FILTERTYPE_INPUT);
+    if (filterTypeInput && filterTypeInput->getConnection())
+    {
+        return false;
+    }
+    return !filterTypeInput || !filterTypeInput->getValue() ||
+           hasEnumValue(filterTypeInput, LINEAR_FILTER, LINEAR_FILTER_INDEX);
+}
+
+string ConvolutionNode::getSampleMergeCondition(const ShaderNode& node, float filterSize, float filterOffset,
+                                                const string& sampleSizeFunctionUV, GenContext& context) const
+{
+    // The texel size is only queried by hardware generators.
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    if (!dynamic_cast<const HwShaderGenerator*>(&shadergen) || !hasLinearUpstream(node))
+    {
+        return EMPTY_STRING;
+    }
+
+    const ShaderNode* upstreamNode = node.getInput(IN_INPUT)->getConnection()->getNode();
+    const ShaderInput* fileInput = upstreamNode->getInput(FILE_INPUT);
+    const ShaderInput* samplingInput = getSamplingInput(*upstreamNode);
+    if (!upstreamNode->hasClassification(ShaderNode::Classification::SAMPLE2D) ||
+        !fileInput || fileInput->getType() != Type::FILENAME ||
+        !samplingInput || samplingInput->getType() != Type::VECTOR2)
+    {
+        return EMPTY_STRING;
+    }
+
+    const string uv = shadergen.getUpstreamResult(samplingInput, context);
+    return TEXEL_ALIGNED_FUNCTION + "(" + shadergen.getUpstreamResult(fileInput, context) + ", " + uv + ", " +
+           sampleSizeFunctionUV + "(" + uv + "," + std::to_string(filterSize) + "," + std::to_string(filterOffset) + "))";
+}
+
 void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node, 
                                          unsigned int sampleCount, unsigned int filterWidth, 
                                          float filterSize, float filterOffset,
                                          const string& sampleSizeFunctionUV, 
                                          GenContext& context, ShaderStage& stage, 
                                          StringVec& sampleStrings) const
+{
+    emitInputSamplesUV(node, sampleCount, filterWidth, nullptr, filterSize, filterOffset,
+                       sampleSizeFunctionUV, context, stage, sampleStrings);
+}
+
+void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node,
+                                         const vector<Vector2>& sampleOffsets,
+                                         float filterSize, float filterOffset,
+                                         const string& sampleSizeFunctionUV,
+                                         GenContext& context, ShaderStage& stage,
+                                         StringVec& sampleStrings) const
+{
+    emitInputSamplesUV(node, static_cast<unsigned int>(sampleOffsets.size()), 0, &sampleOffsets,
+                       filterSize, filterOffset, sampleSizeFunctionUV, context, stage, sampleStrings);
+}
+
+void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node,
+                                         unsigned int sampleCount, unsigned int filterWidth,
+                                         const vector<Vector2>* sampleOffsets,
+                                         float filterSize, float filterOffset,
+                                         const string& sampleSizeFunctionUV,
+                                         GenContext& context, ShaderStage& stage,
+                                         StringVec& sampleStrings) const
 {
     sampleStrings.clear();
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
     // Check for an upstream node to sample
-    const ShaderInput* inInput = node.getInput("in");
+    const ShaderInput* inInput = node.getInput(IN_INPUT);
     const ShaderOutput* inConnection = inInput ? inInput->getConnection() : nullptr;
 
     if (inConnection && inConnection->getType() && acceptsInputType(inConnection->getType()))
@@ -153,7 +299,14 @@ void ConvolutionNode::emitInputSamplesUV(const ShaderNode& node,
                     // sample. The sample size is passed over.
                     //
                     StringVec inputVec2Suffix;
-                    if (sampleCount > 1)
+                    if (sampleOffsets)
+                    {
+                        for (const Vector2& offset : *sampleOffsets)
+                        {
+                            inputVec2Suffix.push_back(" + " + sampleSizeName + " * " + vec2TypeString + "(" + std::to_string(offset[0]) + "," + std::to_string(offset[1]) + ")");
+                        }
+                    }
+                    else if (sampleCount > 1)
                     {
                         computeSampleOffsetStrings(sampleSizeName, vec2TypeString,
                             filterWidth, inputVec2Suffix);
@@ -8,6 +8,8 @@
 
 #include <MaterialXGenShader/ShaderNodeImpl.h>
 
+#include <MaterialXCore/Types.h>
+
 namespace MaterialX
 {
 
@@ -18,6 +20,18 @@ class ConvolutionNode : public ShaderNodeImpl
   public:
      void createVariables(const ShaderNode& node, GenContext& context, Shader& shader) const override;
 
+    /// Return the per-axis weights of the separable Gaussian filter kernel
+    /// of the given width. Supported widths are 1, 3, 5 and 7.
+    static void getGaussianWeights(unsigned int filterWidth, vector<float>& weights);
+
+    /// Compute sample offsets and weights along one axis for a separable filter
+    /// kernel with the given per-axis weights, centered on the middle weight.
+    /// If mergeSamples is true, pairs of neighboring samples are merged into a
+    /// single sample placed between them, such that linear interpolation of the
+    /// upstream values gives the same result as the two original samples.
+    static void computeSeparableSamples(const vector<float>& weights, bool mergeSamples,
+                                        vector<float>& sampleOffsets, vector<float>& sampleWeights);
+
   protected:
     /// Constructor
     ConvolutionNode();
@@ -43,8 +57,43 @@ class ConvolutionNode : public ShaderNodeImpl
                             GenContext& context, ShaderStage& stage,
                             StringVec& sampleStrings) const;
 
+    /// Generate upstream / input sampling code in uv space at the given offsets from
+    /// the center sample, in units of the sample size, and cache the output variable
+    /// names which will hold the sample values after execution.
+    void emitInputSamplesUV(const ShaderNode& node,
+                            const vector<Vector2>& sampleOffsets,
+                            float filterSize, float filterOffset,
+                            const string& sampleSizeFunctionUV,
+                            GenContext& context, ShaderStage& stage,
+                            StringVec& sampleStrings) const;
+
+    /// Return true if the given enum input has the given enum value. Generators
+    /// without string support hold the index of the enum value instead.
+    static bool hasEnumValue(const ShaderInput* input, const string& value, int index);
+
+    /// Return true if the input of the node is connected to a file texture
+    /// which is linearly interpolated between texels. A filter type which is
+    /// connected or published can change at runtime, and is not linear.
+    bool hasLinearUpstream(const ShaderNode& node) const;
+
+    /// Return a condition to evaluate at runtime, which is true if samples spaced
+    /// by the sample size are one texel apart and centered on texels of the upstream
+    /// file texture. Only then do merged samples give the same result as the
+    /// samples they replace. Returns an empty string if samples can't be merged.
+    string getSampleMergeCondition(const ShaderNode& node, float filterSize, float filterOffset,
+                                   const string& sampleSizeFunctionUV, GenContext& context) const;
+
     static const string SAMPLE2D_INPUT;
     static const string SAMPLE3D_INPUT;
+
+  private:
+    void emitInputSamplesUV(const ShaderNode& node,
+                            unsigned int sampleCount, unsigned int filterWidth,
+                            const vector<Vector2>* sampleOffsets,
+                            float filterSize, float filterOffset,
+                            const string& sampleSizeFunctionUV,
+                            GenContext& context, ShaderStage& stage,
+                            StringVec& sampleStrings) const;
 };
 
 } // namespace MaterialX
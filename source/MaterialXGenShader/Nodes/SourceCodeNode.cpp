@@ -58,9 +58,10 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
         _functionSource.erase(std::remove(_functionSource.begin(), _functionSource.end(), '\n'), _functionSource.end());
     }
 
-    // Set hash using the function name.
-    // TODO: Could be improved to include the full function signature.
-    _hash = std::hash<string>{}(_functionName);
+    // Set hash using the function name and the source code, so that functions
+    // with the same name but different signatures, e.g. overloads for different
+    // types, are not mistaken for each other.
+    _hash = std::hash<string>{}(_functionName + "\n" + _functionSource);
 }
 
 void SourceCodeNode::emitFunctionDefinition(const ShaderNode&, GenContext& context, ShaderStage& stage) const
@@ -187,4 +188,43 @@ void SourceCodeNode::emitFunctionCall(const ShaderNode& node, GenContext& contex
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+ValuePtr SourceCodeNode::evaluateConstant(const ShaderNode& node, GenContext&) const
+{
+    if (!_inlined)
+    {
+        return nullptr;
+    }
+
+    // Check for an expression consisting of a single input, e.g. "{{in}}".
+    static const string prefix("{{");
+    static const string postfix("}}");
+    static const string whitespace(" \t\r\n;");
+    const size_t first = _functionSource.find_first_not_of(whitespace);
+    const size_t last = _functionSource.find_last_not_of(whitespace);
+    if (first == string::npos)
+    {
+        return nullptr;
+    }
+    const string expression = _functionSource.substr(first, last - first + 1);
+    if (expression.size() <= prefix.size() + postfix.size() ||
+        expression.compare(0, prefix.size(), prefix) != 0 ||
+        expression.compare(expression.size() - postfix.size(), postfix.size(), postfix) != 0)
+    {
+        return nullptr;
+    }
+    const string variable = expression.substr(prefix.size(), expression.size() - prefix.size() - postfix.size());
+    if (variable.find_first_of("{}") != string::npos)
+    {
+        return nullptr;
+    }
+
+    const ShaderInput* input = node.getInput(variable);
+    return (input && input->getType() == node.getOutput()->getType()) ? input->getValue() : nullptr;
+}
+
+bool SourceCodeNode::isUsed(const ShaderInput& input, const GenContext&) const
+{
+    return !_inlined || _functionSource.find("{{" + input.getName() + "}}") != string::npos;
+}
+
 } // namespace MaterialX
@@ -21,10 +21,18 @@ public:
 
     void initialize(const InterfaceElement& implementation, GenContext& context) override;
 
+    bool hasShareableDefinition() const override { return !_inlined; }
+
     void emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    /// Evaluate inline expressions that pass an input value through unchanged.
+    ValuePtr evaluateConstant(const ShaderNode& node, GenContext& context) const override;
+
+    /// Inline expressions only read the inputs they reference.
+    bool isUsed(const ShaderInput& input, const GenContext& context) const override;
+
 protected:
     bool _inlined;
     string _functionName;
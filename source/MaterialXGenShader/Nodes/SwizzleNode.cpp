@@ -65,4 +65,20 @@ bool SwizzleNode::isEditable(const ShaderInput& input) const
     return (input.getName() != CHANNELS_STRING);
 }
 
+ValuePtr SwizzleNode::evaluateConstant(const ShaderNode& node, GenContext& context) const
+{
+    const ShaderInput* in = node.getInput(IN_STRING);
+    const ShaderInput* channels = node.getInput(CHANNELS_STRING);
+    if (!in || !channels || !in->getValue())
+    {
+        return nullptr;
+    }
+    const string& swizzle = channels->getValue() ? channels->getValue()->getValueString() : EMPTY_STRING;
+    if (swizzle.empty())
+    {
+        return in->getType() == node.getOutput()->getType() ? in->getValue() : nullptr;
+    }
+    return context.getShaderGenerator().getSyntax().getSwizzledValue(in->getValue(), in->getType(), swizzle, node.getOutput()->getType());
+}
+
 } // namespace MaterialX
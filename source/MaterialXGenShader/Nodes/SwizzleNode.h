@@ -23,6 +23,9 @@ class SwizzleNode : public ShaderNodeImpl
     /// Editable inputs are allowed to be published as shader uniforms
     /// and hence must be presentable in a user interface.
     bool isEditable(const ShaderInput& input) const override;
+
+    /// Evaluate the swizzled value of a constant input.
+    ValuePtr evaluateConstant(const ShaderNode& node, GenContext& context) const override;
 };
 
 } // namespace MaterialX
@@ -0,0 +1,45 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderFunctionLibrary.h>
+
+#include <MaterialXGenShader/ShaderStage.h>
+
+namespace MaterialX
+{
+
+ShaderFunctionLibraryPtr ShaderFunctionLibrary::create(const string& name)
+{
+    return ShaderFunctionLibraryPtr(new ShaderFunctionLibrary(name));
+}
+
+ShaderFunctionLibrary::ShaderFunctionLibrary(const string& name) :
+    _name(name),
+    _numFunctions(0)
+{
+}
+
+const string& ShaderFunctionLibrary::getSourceCode() const
+{
+    return _stage ? _stage->getSourceCode() : EMPTY_STRING;
+}
+
+string ShaderFunctionLibrary::resolveSourceCode(const string& sourceCode) const
+{
+    if (_includeStatement.empty())
+    {
+        return sourceCode;
+    }
+    const size_t pos = sourceCode.find(_includeStatement);
+    if (pos == string::npos)
+    {
+        return sourceCode;
+    }
+    string result = sourceCode;
+    result.replace(pos, _includeStatement.size(), getSourceCode());
+    return result;
+}
+
+} // namespace MaterialX
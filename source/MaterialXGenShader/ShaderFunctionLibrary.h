@@ -0,0 +1,71 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERFUNCTIONLIBRARY_H
+#define MATERIALX_SHADERFUNCTIONLIBRARY_H
+
+/// @file
+/// Library of function definitions shared between shaders
+
+#include <MaterialXGenShader/Library.h>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a ShaderFunctionLibrary
+using ShaderFunctionLibraryPtr = shared_ptr<class ShaderFunctionLibrary>;
+
+/// @class ShaderFunctionLibrary
+/// A library of function definitions shared by a batch of shaders.
+///
+/// When a function library is set on the GenContext, node function definitions
+/// which can be shared are emitted once into the library instead of into each
+/// shader, and the pixel stage of each shader includes the library by name.
+/// Include files are wrapped in include guards, so the library source can be
+/// inserted in place of the include statement.
+///
+/// All shaders using a library should be generated with the same generator
+/// and generation options.
+class ShaderFunctionLibrary
+{
+  public:
+    /// Create a new function library with the given name.
+    static ShaderFunctionLibraryPtr create(const string& name);
+
+    /// Return the name of the library, which is used when including it.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+    /// Return the number of functions defined in the library.
+    size_t numFunctions() const
+    {
+        return _numFunctions;
+    }
+
+    /// Return the source code for all functions defined in the library.
+    const string& getSourceCode() const;
+
+    /// Return the given shader source code with the statement including the library
+    /// replaced by the library source code. Can be used for targets without
+    /// support for include files.
+    string resolveSourceCode(const string& sourceCode) const;
+
+  protected:
+    /// Protected constructor
+    ShaderFunctionLibrary(const string& name);
+
+    friend class ShaderStage;
+
+    string _name;
+    size_t _numFunctions;
+    string _includeStatement;
+    ShaderStagePtr _stage;
+};
+
+} // namespace MaterialX
+
+#endif
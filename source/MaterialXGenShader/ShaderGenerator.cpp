@@ -99,7 +99,9 @@ void ShaderGenerator::emitFunctionCall(const ShaderNode& node, GenContext& conte
     }
     else
     {
-        node.getImplementation().emitFunctionCall(node, context, stage);
+        const ShaderNodeImpl& impl = node.getImplementation();
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::FUNCTION_CALL, impl.getName().c_str());
+        impl.emitFunctionCall(node, context, stage);
     }
 }
 
@@ -247,6 +249,12 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& ele
         return impl;
     }
 
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGenerator::getImplementation");
+    if (GenProfiler* profiler = context.getProfiler())
+    {
+        profiler->addCount("ShaderNodeImpl");
+    }
+
     if (element.isA<NodeGraph>())
     {
         // Use a compound implementation.
@@ -13,16 +13,40 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 
+static const string DEFAULT_INPUT = "default";
+static const string CHANNEL_NAMES = "rgbaxyzw";
+
+// Return the channels selecting the first channelCount channels of the given type.
+static string getLeadingChannels(const TypeDesc* type, size_t channelCount)
+{
+    string channels;
+    for (size_t i = 0; i < channelCount; ++i)
+    {
+        for (char c : CHANNEL_NAMES)
+        {
+            if (type->getChannelIndex(c) == int(i))
+            {
+                channels += c;
+                break;
+            }
+        }
+    }
+    return channels.size() == channelCount ? channels : EMPTY_STRING;
+}
+
 //
 // ShaderGraph methods
 //
 
 ShaderGraph::ShaderGraph(const ShaderGraph* parent, const string& name, ConstDocumentPtr document) :
     ShaderNode(parent, name),
-    _document(document)
+    _document(document),
+    _inputsPublished(false)
 {
 }
 
@@ -66,6 +90,8 @@ void ShaderGraph::addOutputSockets(const InterfaceElement& elem)
 
 void ShaderGraph::addUpstreamDependencies(const Element& root, ConstMaterialPtr material, GenContext& context)
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::addUpstreamDependencies");
+
     // Keep track of our root node in the graph.
     // This is needed when the graph is a shader graph and we need
     // to make connections for BindInputs during traversal below.
@@ -312,6 +338,12 @@ void ShaderGraph::addColorTransformNode(ShaderOutput* output, const ColorSpaceTr
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& nodeGraph, GenContext& context)
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::create");
+    if (GenProfiler* profiler = context.getProfiler())
+    {
+        profiler->addCount("ShaderGraph");
+    }
+
     NodeDefPtr nodeDef = nodeGraph.getNodeDef();
     if (!nodeDef)
     {
@@ -320,7 +352,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& n
 
     string graphName = nodeGraph.getName();
     context.getShaderGenerator().getSyntax().makeValidName(graphName);
-    ShaderGraphPtr graph = std::make_shared<ShaderGraph>(parent, graphName, nodeGraph.getDocument());
+    ShaderGraphPtr graph = allocateShared<ShaderGraph>(context.getArena(), parent, graphName, nodeGraph.getDocument());
+    graph->_arena = context.getArena();
 
     // Clear classification
     graph->_classification = 0;
@@ -352,6 +385,12 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& n
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name, ElementPtr element, GenContext& context)
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::create");
+    if (GenProfiler* profiler = context.getProfiler())
+    {
+        profiler->addCount("ShaderGraph");
+    }
+
     ShaderGraphPtr graph;
     ElementPtr root;
     MaterialPtr material;
@@ -387,7 +426,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name
             throw ExceptionShaderGenError("Given output '" + output->getName() + "' has no interface valid for shader generation");
         }
 
-        graph = std::make_shared<ShaderGraph>(parent, name, element->getDocument());
+        graph = allocateShared<ShaderGraph>(context.getArena(), parent, name, element->getDocument());
+        graph->_arena = context.getArena();
 
         // Clear classification
         graph->_classification = 0;
@@ -413,7 +453,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name
             throw ExceptionShaderGenError("Could not find a nodedef for shader '" + shaderRef->getName() + "'");
         }
 
-        graph = std::make_shared<ShaderGraph>(parent, name, element->getDocument());
+        graph = allocateShared<ShaderGraph>(context.getArena(), parent, name, element->getDocument());
+        graph->_arena = context.getArena();
 
         // Create input sockets
         graph->addInputSockets(*nodeDef, context);
@@ -676,6 +717,102 @@ ShaderGraphOutputSocket* ShaderGraph::addOutputSocket(const string& name, const
     return ShaderNode::addInput(name, type);
 }
 
+ShaderGraphPtr ShaderGraph::clone(const ShaderGraph* parent, ConstDocumentPtr document, GenArenaPtr arena) const
+{
+    ShaderGraphPtr graph = allocateShared<ShaderGraph>(arena, parent, _name, document);
+    graph->_arena = arena;
+    graph->_classification = _classification;
+    graph->_impl = _impl;
+    graph->_inputsPublished = _inputsPublished;
+
+    auto copyPort = [](const ShaderPort* from, ShaderPort* to)
+    {
+        to->setPath(from->getPath());
+        to->setSemantic(from->getSemantic());
+        to->setVariable(from->getVariable());
+        to->setValue(from->getValue());
+        to->setFlags(from->getFlags());
+    };
+
+    // Copy the sockets and nodes, recording the copy of each output
+    // to re-create the connections.
+    std::unordered_map<const ShaderNode*, ShaderNode*> nodeCopies;
+    std::unordered_map<const ShaderOutput*, ShaderOutput*> outputCopies;
+    nodeCopies[this] = graph.get();
+    for (const ShaderGraphInputSocket* inputSocket : getInputSockets())
+    {
+        ShaderGraphInputSocket* socketCopy = graph->addInputSocket(inputSocket->getName(), inputSocket->getType());
+        copyPort(inputSocket, socketCopy);
+        outputCopies[inputSocket] = socketCopy;
+    }
+    for (const ShaderGraphOutputSocket* outputSocket : getOutputSockets())
+    {
+        ShaderGraphOutputSocket* socketCopy = graph->addOutputSocket(outputSocket->getName(), outputSocket->getType());
+        copyPort(outputSocket, socketCopy);
+        socketCopy->setChannels(outputSocket->getChannels());
+    }
+    for (auto it : _nodeMap)
+    {
+        const ShaderNode* node = it.second.get();
+        ShaderNodePtr nodeCopy = ShaderNode::create(graph.get(), node->getName(), node->_impl, node->_classification);
+        for (const ShaderInput* input : node->getInputs())
+        {
+            ShaderInput* inputCopy = nodeCopy->addInput(input->getName(), input->getType());
+            copyPort(input, inputCopy);
+            inputCopy->setChannels(input->getChannels());
+        }
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            ShaderOutput* outputCopy = nodeCopy->addOutput(output->getName(), output->getType());
+            copyPort(output, outputCopy);
+            outputCopies[output] = outputCopy;
+        }
+        graph->_nodeMap[it.first] = nodeCopy;
+        nodeCopies[node] = nodeCopy.get();
+    }
+    for (const ShaderNode* node : _nodeOrder)
+    {
+        graph->_nodeOrder.push_back(nodeCopies[node]);
+    }
+
+    // Re-create the connections, and the references between nodes.
+    auto copyConnection = [&outputCopies](const ShaderInput* input, ShaderInput* inputCopy)
+    {
+        if (input->getConnection())
+        {
+            inputCopy->makeConnection(outputCopies[input->getConnection()]);
+        }
+    };
+    for (size_t i = 0; i < numOutputSockets(); ++i)
+    {
+        copyConnection(getOutputSocket(i), graph->getOutputSocket(i));
+    }
+    for (auto it : nodeCopies)
+    {
+        const ShaderNode* node = it.first;
+        ShaderNode* nodeCopy = it.second;
+        if (node == this)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < node->numInputs(); ++i)
+        {
+            copyConnection(node->getInput(i), nodeCopy->getInput(i));
+        }
+        nodeCopy->_scopeInfo = node->_scopeInfo;
+        if (node->_scopeInfo.conditionalNode)
+        {
+            nodeCopy->_scopeInfo.conditionalNode = nodeCopies[node->_scopeInfo.conditionalNode];
+        }
+        for (const ShaderNode* closure : node->_usedClosures)
+        {
+            nodeCopy->_usedClosures.insert(nodeCopies[closure]);
+        }
+    }
+
+    return graph;
+}
+
 ShaderGraphEdgeIterator ShaderGraph::traverseUpstream(ShaderOutput* output)
 {
     return ShaderGraphEdgeIterator(output);
@@ -694,6 +831,8 @@ const ShaderNode* ShaderGraph::getNode(const string& name) const
 
 void ShaderGraph::finalize(GenContext& context)
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::finalize");
+
     // Insert color transformation nodes where needed
     for (auto it : _inputColorTransformMap)
     {
@@ -707,7 +846,11 @@ void ShaderGraph::finalize(GenContext& context)
     _outputColorTransformMap.clear();
 
     // Optimize the graph, removing redundant paths.
-    optimize(context);
+    const int optimizationLevel = context.getOptions().optimizationLevel;
+    if (optimizationLevel > 0)
+    {
+        optimize(context);
+    }
 
     if (context.getOptions().shaderInterfaceType == SHADER_INTERFACE_COMPLETE)
     {
@@ -733,22 +876,67 @@ void ShaderGraph::finalize(GenContext& context)
                             inputSocket = addInputSocket(interfaceName, input->getType());
                             inputSocket->setPath(input->getPath());
                             inputSocket->setValue(input->getValue());
+                            inputSocket->setFlags(inputSocket->getFlags() | ShaderPort::AUTO_PUBLISHED);
                         }
                         inputSocket->makeConnection(input);
                     }
                 }
             }
         }
+        _inputsPublished = true;
+    }
+
+    // Run the passes for higher optimization levels. These are done after
+    // publishing so the interface matches the one of the unoptimized graph.
+    size_t numEdits = 0;
+    unsigned int flattenClassification = 0;
+    if (context.getOptions().flattenSubgraphs || optimizationLevel > 1)
+    {
+        flattenClassification |= Classification::TEXTURE;
+    }
+    if (context.getOptions().hwLightLoopHoisting || optimizationLevel > 1)
+    {
+        // Inline BSDF graphs so their light-independent texture nodes are
+        // emitted with the other texture nodes, ahead of the light loop.
+        flattenClassification |= Classification::BSDF;
+    }
+    if (flattenClassification)
+    {
+        numEdits += flattenSubgraphs(context, flattenClassification);
+    }
+    if (context.getOptions().bakeUniforms)
+    {
+        numEdits += bakeInputSockets(context);
+    }
+    if (optimizationLevel > 1)
+    {
+        numEdits += foldConstants(context);
+    }
+    if (numEdits > 0 && optimizationLevel > 0)
+    {
+        // Optimize again, now that inlined nodes are visible
+        // and constant values have been propagated.
+        removeUnusedNodes();
+        optimize(context);
     }
 
     // Sort the nodes in topological order.
-    topologicalSort();
+    {
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::topologicalSort");
+        topologicalSort();
+    }
 
     // Calculate scopes for all nodes in the graph.
-    calculateScopes();
+    {
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::calculateScopes");
+        calculateScopes();
+    }
 
     // Set variable names for inputs and outputs in the graph.
-    setVariableNames(context.getShaderGenerator().getSyntax());
+    {
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::setVariableNames");
+        setVariableNames(context.getShaderGenerator().getSyntax());
+    }
 
     // Track closure nodes used by each surface shader.
     //
@@ -787,6 +975,8 @@ void ShaderGraph::disconnect(ShaderNode* node) const
 
 void ShaderGraph::optimize(GenContext& context)
 {
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::optimize");
+
     size_t numEdits = 0;
     for (ShaderNode* node : getNodes())
     {
@@ -840,38 +1030,53 @@ void ShaderGraph::optimize(GenContext& context)
         }
     }
 
+    // Merge redundant texture samples, and then nodes that compute
+    // identical results, including any made identical by the sample merging.
+    numEdits += mergeTextureSamples(context);
+    numEdits += eliminateCommonSubexpressions(context);
+
     if (numEdits > 0)
     {
-        std::set<ShaderNode*> usedNodes;
+        removeUnusedNodes();
+    }
+}
 
-        // Travers the graph to find nodes still in use
-        for (ShaderGraphOutputSocket* outputSocket : getOutputSockets())
+void ShaderGraph::removeUnusedNodes()
+{
+    std::set<ShaderNode*> usedNodes;
+
+    // Travers the graph to find nodes still in use
+    for (ShaderGraphOutputSocket* outputSocket : getOutputSockets())
+    {
+        if (outputSocket->getConnection())
         {
-            if (outputSocket->getConnection())
+            for (ShaderGraphEdge edge : ShaderGraph::traverseUpstream(outputSocket->getConnection()))
             {
-                for (ShaderGraphEdge edge : ShaderGraph::traverseUpstream(outputSocket->getConnection()))
-                {
-                    usedNodes.insert(edge.upstream->getNode());
-                }
+                usedNodes.insert(edge.upstream->getNode());
             }
         }
+    }
 
-        // Remove any unused nodes
-        for (ShaderNode* node : _nodeOrder)
+    // Remove any unused nodes, keeping the order of the used nodes
+    vector<ShaderNode*> nodeOrder;
+    nodeOrder.reserve(usedNodes.size());
+    for (ShaderNode* node : _nodeOrder)
+    {
+        if (usedNodes.count(node) == 0)
         {
-            if (usedNodes.count(node) == 0)
-            {
-                // Break all connections
-                disconnect(node);
+            // Break all connections
+            disconnect(node);
 
-                // Erase from storage
-                _nodeMap.erase(node->getName());
-            }
+            // Erase from storage
+            _nodeMap.erase(node->getName());
+        }
+        else
+        {
+            nodeOrder.push_back(node);
         }
-
-        _nodeOrder.resize(usedNodes.size());
-        _nodeOrder.assign(usedNodes.begin(), usedNodes.end());
     }
+
+    _nodeOrder.swap(nodeOrder);
 }
 
 void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex)
@@ -921,6 +1126,568 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
     }
 }
 
+size_t ShaderGraph::eliminateCommonSubexpressions(GenContext& context)
+{
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::eliminateCommonSubexpressions");
+
+    // Visit nodes in topological order so that upstream duplicates are
+    // merged first. Their downstream inputs then share the same connection
+    // which in turn makes the downstream nodes candidates for merging.
+    topologicalSort();
+
+    const bool publishInputs = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_COMPLETE && !_inputsPublished;
+
+    size_t numMerged = 0;
+    std::unordered_map<string, ShaderNode*> nodesByKey;
+
+    for (ShaderNode* node : _nodeOrder)
+    {
+        // Closures and shaders are evaluated in closure contexts
+        // and are never merged.
+        if (!node->_impl ||
+            node->hasClassification(ShaderNode::Classification::CLOSURE) ||
+            node->hasClassification(ShaderNode::Classification::SHADER))
+        {
+            continue;
+        }
+
+        // Build a key describing the computation made by this node.
+        string key = std::to_string(reinterpret_cast<size_t>(node->_impl.get())) + ":" + std::to_string(node->_classification);
+        bool mergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            key += "|" + input->getName() + ":" + input->getType()->getName() + ":" + input->getChannels() + ":";
+            const ShaderOutput* upstream = input->getConnection();
+            if (upstream)
+            {
+                key += std::to_string(reinterpret_cast<size_t>(upstream));
+            }
+            else if (publishInputs && input->getType()->isEditable() && node->isEditable(*input))
+            {
+                // The input will be published as a separate uniform
+                // so the node must be kept to keep the interface intact.
+                mergeable = false;
+                break;
+            }
+            else if (input->getValue())
+            {
+                key += "=" + input->getValue()->getValueString();
+            }
+        }
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            key += "|" + output->getName() + ":" + output->getType()->getName();
+        }
+        if (!mergeable)
+        {
+            continue;
+        }
+
+        auto it = nodesByKey.find(key);
+        if (it == nodesByKey.end())
+        {
+            nodesByKey[key] = node;
+            continue;
+        }
+
+        // Re-route all downstream connections to the existing node.
+        // Iterate a copy of the connection set since the original
+        // set will change when breaking connections.
+        ShaderNode* existing = it->second;
+        for (size_t i = 0; i < node->numOutputs(); ++i)
+        {
+            ShaderOutput* output = node->getOutput(i);
+            ShaderInputSet downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(existing->getOutput(i));
+            }
+        }
+        ++numMerged;
+    }
+
+    return numMerged;
+}
+
+size_t ShaderGraph::mergeTextureSamples(GenContext& context)
+{
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::mergeTextureSamples");
+
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+    const bool publishInputs = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_COMPLETE && !_inputsPublished;
+
+    // Group image nodes by their sampling state, which is given by
+    // all inputs except the default value.
+    vector<vector<ShaderNode*>> samples;
+    std::unordered_map<string, size_t> samplesByKey;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        if (!node->_impl || !node->hasClassification(ShaderNode::Classification::IMAGE) || node->numOutputs() != 1)
+        {
+            continue;
+        }
+
+        string key;
+        bool mergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            const ShaderOutput* upstream = input->getConnection();
+            if (!upstream && publishInputs && input->getType()->isEditable() && node->isEditable(*input))
+            {
+                // The input will be published as a separate uniform
+                // so the node must be kept to keep the interface intact.
+                mergeable = false;
+                break;
+            }
+            if (input->getName() == DEFAULT_INPUT)
+            {
+                continue;
+            }
+            key += "|" + input->getName() + ":" + input->getType()->getName() + ":" + input->getChannels() + ":";
+            if (upstream)
+            {
+                key += std::to_string(reinterpret_cast<size_t>(upstream));
+            }
+            else if (input->getValue())
+            {
+                key += "=" + input->getValue()->getValueString();
+            }
+        }
+        if (!mergeable)
+        {
+            continue;
+        }
+
+        auto it = samplesByKey.find(key);
+        if (it == samplesByKey.end())
+        {
+            samplesByKey[key] = samples.size();
+            samples.push_back({ node });
+        }
+        else
+        {
+            samples[it->second].push_back(node);
+        }
+    }
+
+    size_t numMerged = 0;
+    for (const vector<ShaderNode*>& nodes : samples)
+    {
+        if (nodes.size() < 2)
+        {
+            continue;
+        }
+
+        // Keep the node with the widest output type,
+        // since all other outputs can be extracted from it.
+        ShaderNode* sample = nodes[0];
+        for (ShaderNode* node : nodes)
+        {
+            if (node->getOutput()->getType()->getSize() > sample->getOutput()->getType()->getSize())
+            {
+                sample = node;
+            }
+        }
+        ShaderOutput* sampleOutput = sample->getOutput();
+        const TypeDesc* sampleType = sampleOutput->getType();
+        const ShaderInput* sampleDefault = sample->getInput(DEFAULT_INPUT);
+
+        for (ShaderNode* node : nodes)
+        {
+            if (node == sample)
+            {
+                continue;
+            }
+
+            ShaderOutput* output = node->getOutput();
+            const TypeDesc* type = output->getType();
+            bool mergeable = true;
+            const string channels = type != sampleType ? getLeadingChannels(sampleType, type->getSize()) : EMPTY_STRING;
+            if (type != sampleType && channels.empty())
+            {
+                continue;
+            }
+
+            // The default values must match, since they are
+            // returned when the texture can't be sampled.
+            const ShaderInput* defaultInput = node->getInput(DEFAULT_INPUT);
+            if (defaultInput && sampleDefault)
+            {
+                if (defaultInput->getConnection() || sampleDefault->getConnection())
+                {
+                    if (type != sampleType ||
+                        defaultInput->getConnection() != sampleDefault->getConnection() ||
+                        defaultInput->getChannels() != sampleDefault->getChannels())
+                    {
+                        continue;
+                    }
+                }
+                else if (defaultInput->getValue() && sampleDefault->getValue())
+                {
+                    ValuePtr value = channels.empty() ? sampleDefault->getValue() :
+                        syntax.getSwizzledValue(sampleDefault->getValue(), sampleType, channels, type);
+                    if (value && !channels.empty())
+                    {
+                        // Parse the swizzled value to compare with a canonical string.
+                        value = Value::createValueFromStrings(value->getValueString(), type->getName());
+                    }
+                    if (!value || value->getValueString() != defaultInput->getValue()->getValueString())
+                    {
+                        continue;
+                    }
+                }
+                else if (defaultInput->getValue() || sampleDefault->getValue())
+                {
+                    continue;
+                }
+            }
+            else if (defaultInput || sampleDefault)
+            {
+                continue;
+            }
+
+            // Find the channels to extract from the remaining sample for each
+            // downstream input, composing with any channels already in use.
+            // Channel extraction is only supported on node inputs, so nodes
+            // of another type connected to graph outputs are kept.
+            std::unordered_map<ShaderInput*, string> downstreamChannels;
+            for (ShaderInput* downstream : output->getConnections())
+            {
+                string& extracted = downstreamChannels[downstream];
+                if (channels.empty())
+                {
+                    extracted = downstream->getChannels();
+                }
+                else if (downstream->getNode() == this)
+                {
+                    mergeable = false;
+                }
+                else if (downstream->getChannels().empty())
+                {
+                    extracted = channels;
+                }
+                else
+                {
+                    for (char c : downstream->getChannels())
+                    {
+                        const int index = type->getSize() == 1 ? 0 : type->getChannelIndex(c);
+                        if (index < 0 || index >= int(channels.size()))
+                        {
+                            mergeable = false;
+                            break;
+                        }
+                        extracted += channels[index];
+                    }
+                }
+            }
+            if (!mergeable)
+            {
+                continue;
+            }
+
+            // Re-route all downstream connections to the remaining sample.
+            for (auto it : downstreamChannels)
+            {
+                ShaderInput* downstream = it.first;
+                output->breakConnection(downstream);
+                downstream->makeConnection(sampleOutput);
+                downstream->setChannels(it.second);
+            }
+            ++numMerged;
+        }
+    }
+
+    return numMerged;
+}
+
+size_t ShaderGraph::flattenSubgraphs(GenContext& context, unsigned int classification)
+{
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::flattenSubgraphs");
+
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+
+    std::deque<ShaderNode*> compoundNodes;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        compoundNodes.push_back(node);
+    }
+
+    size_t numFlattened = 0;
+    while (!compoundNodes.empty())
+    {
+        ShaderNode* node = compoundNodes.front();
+        compoundNodes.pop_front();
+
+        // Only texture and BSDF nodes are inlined. Shaders and other
+        // closures are emitted as functions.
+        ShaderGraph* subgraph = node->_impl ? node->_impl->getGraph() : nullptr;
+        const bool isTexture = node->hasClassification(Classification::TEXTURE) &&
+                               !node->hasClassification(Classification::CLOSURE);
+        const bool isBsdf = node->hasClassification(Classification::BSDF);
+        if (!subgraph ||
+            !(node->_classification & classification) ||
+            node->hasClassification(Classification::SHADER) ||
+            !(isTexture || isBsdf))
+        {
+            continue;
+        }
+
+        // All outputs must be computed by internal nodes without swizzling,
+        // and swizzles on both sides of an input socket can't be combined.
+        // Output sockets map to the compound node outputs by index.
+        bool supported = subgraph->numOutputSockets() == node->numOutputs();
+        if (isBsdf)
+        {
+            // The internal nodes of a BSDF graph are emitted in the closure contexts of
+            // the parent graph, where only texture and BSDF nodes are supported.
+            for (const ShaderNode* child : subgraph->getNodes())
+            {
+                if (child->hasClassification(Classification::SHADER) ||
+                    (child->hasClassification(Classification::CLOSURE) && !child->hasClassification(Classification::BSDF)))
+                {
+                    supported = false;
+                }
+            }
+        }
+        for (const ShaderGraphOutputSocket* outputSocket : subgraph->getOutputSockets())
+        {
+            const ShaderOutput* upstream = outputSocket->getConnection();
+            if (!upstream || upstream->getNode() == subgraph || !outputSocket->getChannels().empty())
+            {
+                supported = false;
+            }
+        }
+        for (const ShaderNode* child : subgraph->getNodes())
+        {
+            for (const ShaderInput* childInput : child->getInputs())
+            {
+                const ShaderOutput* upstream = childInput->getConnection();
+                if (upstream && upstream->getNode() == subgraph)
+                {
+                    const ShaderInput* input = node->getInput(upstream->getName());
+                    if (!input || (!input->getChannels().empty() && !childInput->getChannels().empty()))
+                    {
+                        supported = false;
+                    }
+                }
+            }
+        }
+        if (!supported)
+        {
+            continue;
+        }
+
+        // Create copies of all internal nodes.
+        std::unordered_map<const ShaderNode*, ShaderNode*> copies;
+        for (const ShaderNode* child : subgraph->getNodes())
+        {
+            string name = node->getName() + "_" + child->getName();
+            for (size_t i = 2; _nodeMap.count(name); ++i)
+            {
+                name = node->getName() + "_" + child->getName() + std::to_string(i);
+            }
+            ShaderNodePtr copy = ShaderNode::create(this, name, child->_impl, child->_classification);
+            for (const ShaderInput* childInput : child->getInputs())
+            {
+                ShaderInput* input = copy->addInput(childInput->getName(), childInput->getType());
+                input->setValue(childInput->getValue());
+                input->setPath(childInput->getPath());
+                input->setChannels(childInput->getChannels());
+            }
+            for (const ShaderOutput* childOutput : child->getOutputs())
+            {
+                copy->addOutput(childOutput->getName(), childOutput->getType());
+            }
+            _nodeMap[name] = copy;
+            _nodeOrder.push_back(copy.get());
+            copies[child] = copy.get();
+
+            // Nested compounds are inlined as well.
+            compoundNodes.push_back(copy.get());
+        }
+
+        // Re-create the internal connections, connecting input sockets
+        // to the upstream connections or values of the compound node.
+        for (const ShaderNode* child : subgraph->getNodes())
+        {
+            ShaderNode* copy = copies[child];
+            for (const ShaderInput* childInput : child->getInputs())
+            {
+                const ShaderOutput* upstream = childInput->getConnection();
+                if (!upstream)
+                {
+                    continue;
+                }
+                ShaderInput* input = copy->getInput(childInput->getName());
+                if (upstream->getNode() != subgraph)
+                {
+                    input->makeConnection(copies[upstream->getNode()]->getOutput(upstream->getName()));
+                    continue;
+                }
+
+                ShaderInput* interfaceInput = node->getInput(upstream->getName());
+                if (interfaceInput->getConnection())
+                {
+                    input->makeConnection(interfaceInput->getConnection());
+                    if (!interfaceInput->getChannels().empty())
+                    {
+                        input->setChannels(interfaceInput->getChannels());
+                    }
+                }
+                else
+                {
+                    input->setValue(interfaceInput->getValue());
+                    input->setPath(interfaceInput->getPath());
+                    if (!input->getChannels().empty() && interfaceInput->getValue())
+                    {
+                        input->setValue(syntax.getSwizzledValue(interfaceInput->getValue(), interfaceInput->getType(),
+                                                                input->getChannels(), input->getType()));
+                        input->setChannels(EMPTY_STRING);
+                    }
+                }
+            }
+        }
+
+        // Re-route the compound outputs to the internal nodes computing them.
+        for (size_t i = 0; i < node->numOutputs(); ++i)
+        {
+            const ShaderOutput* upstream = subgraph->getOutputSocket(i)->getConnection();
+            ShaderOutput* internalOutput = copies[upstream->getNode()]->getOutput(upstream->getName());
+            ShaderOutput* output = node->getOutput(i);
+            ShaderInputSet downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(internalOutput);
+            }
+        }
+
+        if (subgraph->hasClassification(Classification::CONVOLUTION2D))
+        {
+            _classification |= Classification::CONVOLUTION2D;
+        }
+
+        // Remove the compound node.
+        disconnect(node);
+        _nodeOrder.erase(std::find(_nodeOrder.begin(), _nodeOrder.end(), node));
+        const string name = node->getName();
+        _nodeMap.erase(name);
+
+        ++numFlattened;
+    }
+
+    return numFlattened;
+}
+
+size_t ShaderGraph::bakeInputSockets(GenContext& context)
+{
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::bakeInputSockets");
+
+    const StringSet& bakedNames = context.getOptions().bakedUniformNames;
+
+    size_t numBaked = 0;
+    for (ShaderGraphInputSocket* inputSocket : getInputSockets())
+    {
+        if (!inputSocket->getValue() ||
+            inputSocket->getType() == Type::FILENAME ||
+            (!bakedNames.empty() && !bakedNames.count(inputSocket->getName())))
+        {
+            continue;
+        }
+
+        // Assign the value to all downstream inputs. Inputs with swizzles, and
+        // output sockets passing the value through, keep their connection.
+        bool baked = false;
+        const vector<ShaderInput*> downstreamInputs(inputSocket->getConnections().begin(), inputSocket->getConnections().end());
+        for (ShaderInput* downstream : downstreamInputs)
+        {
+            if (downstream->getNode() == this ||
+                !downstream->getChannels().empty() ||
+                downstream->getType() != inputSocket->getType())
+            {
+                continue;
+            }
+            downstream->breakConnection();
+            downstream->setValue(inputSocket->getValue());
+            baked = true;
+        }
+        if (baked)
+        {
+            ++numBaked;
+        }
+    }
+    return numBaked;
+}
+
+size_t ShaderGraph::foldConstants(GenContext& context)
+{
+    GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraph::foldConstants");
+
+    // Visit nodes in topological order so values
+    // folded upstream can be folded further downstream.
+    topologicalSort();
+
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+    const bool publishInputs = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_COMPLETE && !_inputsPublished;
+
+    size_t numFolded = 0;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        if (!node->_impl || node->numOutputs() != 1 ||
+            !node->hasClassification(ShaderNode::Classification::TEXTURE) ||
+            node->hasClassification(ShaderNode::Classification::FILETEXTURE))
+        {
+            continue;
+        }
+
+        // All inputs must be constant, and not about to be published.
+        bool constant = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            if (input->getConnection() ||
+                (publishInputs && input->getType()->isEditable() && node->isEditable(*input)))
+            {
+                constant = false;
+                break;
+            }
+        }
+        if (!constant)
+        {
+            continue;
+        }
+
+        ValuePtr value = node->_impl->evaluateConstant(*node, context);
+        if (!value)
+        {
+            continue;
+        }
+
+        // Push the value downstream.
+        // Iterate a copy of the connection set since the
+        // original set will change when breaking connections.
+        ShaderOutput* output = node->getOutput();
+        ShaderInputSet downstreamConnections = output->getConnections();
+        for (ShaderInput* downstream : downstreamConnections)
+        {
+            output->breakConnection(downstream);
+            const string& channels = downstream->getChannels();
+            if (channels.empty())
+            {
+                downstream->setValue(value);
+            }
+            else
+            {
+                downstream->setValue(syntax.getSwizzledValue(value, output->getType(), channels, downstream->getType()));
+                downstream->setChannels(EMPTY_STRING);
+            }
+        }
+        ++numFolded;
+    }
+
+    return numFolded;
+}
+
 void ShaderGraph::topologicalSort()
 {
     // Calculate a topological order of the children, using Kahn's algorithm
@@ -929,11 +1696,15 @@ void ShaderGraph::topologicalSort()
     // Running time: O(numNodes + numEdges).
 
     // Calculate in-degrees for all nodes, and enqueue those with degree 0.
+    // Nodes are visited in insertion order, so the resulting order only
+    // depends on the graph structure and not on the node names.
     std::unordered_map<ShaderNode*, int> inDegree(_nodeMap.size());
+    std::unordered_map<ShaderNode*, size_t> insertionIndex(_nodeMap.size());
     std::deque<ShaderNode*> nodeQueue;
-    for (auto it : _nodeMap)
+    for (ShaderNode* node : _nodeOrder)
     {
-        ShaderNode* node = it.second.get();
+        const size_t index = insertionIndex.size();
+        insertionIndex[node] = index;
 
         int connectionCount = 0;
         for (const ShaderInput* input : node->getInputs())
@@ -954,6 +1725,7 @@ void ShaderGraph::topologicalSort()
 
     _nodeOrder.resize(_nodeMap.size(), nullptr);
     size_t count = 0;
+    vector<ShaderNode*> downstreamNodes;
 
     while (!nodeQueue.empty())
     {
@@ -964,19 +1736,30 @@ void ShaderGraph::topologicalSort()
 
         // Find connected nodes and decrease their in-degree,
         // adding node to the queue if in-degrees becomes 0.
+        // Connections are stored by address, so they are visited
+        // in insertion order of their nodes instead.
+        downstreamNodes.clear();
         for (auto output : node->getOutputs())
         {
             for (auto input : output->getConnections())
             {
                 if (input->getNode() != this)
                 {
-                    if (--inDegree[input->getNode()] <= 0)
-                    {
-                        nodeQueue.push_back(input->getNode());
-                    }
+                    downstreamNodes.push_back(input->getNode());
                 }
             }
         }
+        std::sort(downstreamNodes.begin(), downstreamNodes.end(), [&insertionIndex](ShaderNode* a, ShaderNode* b)
+        {
+            return insertionIndex[a] < insertionIndex[b];
+        });
+        for (ShaderNode* downstreamNode : downstreamNodes)
+        {
+            if (--inDegree[downstreamNode] <= 0)
+            {
+                nodeQueue.push_back(downstreamNode);
+            }
+        }
     }
 
     // Check if there was a cycle.
@@ -57,6 +57,13 @@ class ShaderGraph : public ShaderNode
     static ShaderGraphPtr create(const ShaderGraph* parent, const NodeGraph& nodeGraph,
                                  GenContext& context);
 
+    /// Return a copy of this graph, with the given parent and document, with
+    /// its nodes and ports allocated from the given arena, or the heap if no
+    /// arena is given. All nodes, ports and connections are copied, and node
+    /// implementations are shared with this graph. Can be used to reuse a
+    /// finalized graph as a template.
+    ShaderGraphPtr clone(const ShaderGraph* parent, ConstDocumentPtr document, GenArenaPtr arena) const;
+
     /// Return true if this node is a graph.
     bool isAGraph() const override { return true; }
 
@@ -133,6 +140,40 @@ class ShaderGraph : public ShaderNode
     /// with the output's downstream connections.
     void bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex = 0);
 
+    /// Find nodes computing identical results, i.e. nodes using the same implementation
+    /// with identical input connections and values, and re-route the downstream
+    /// connections of all duplicates to a single remaining node.
+    /// Returns the number of nodes that were made redundant.
+    size_t eliminateCommonSubexpressions(GenContext& context);
+
+    /// Merge image nodes sampling the same texture with the same sampling
+    /// state, but possibly with different output types, into a single sample
+    /// using the widest output type. Downstream connections of the merged nodes
+    /// extract their channels from the remaining sample.
+    /// Returns the number of nodes that were made redundant.
+    size_t mergeTextureSamples(GenContext& context);
+
+    /// Inline the graphs of compound nodes into this graph, replacing the
+    /// compound nodes by copies of their internal nodes. Only compound nodes
+    /// matching any of the given classifications are inlined, which must be
+    /// texture nodes and/or BSDF nodes. Shaders are never inlined.
+    /// Returns the number of compound nodes that were inlined.
+    size_t flattenSubgraphs(GenContext& context, unsigned int classification = Classification::TEXTURE);
+
+    /// Replace the connections from input sockets by the values of the sockets,
+    /// for all sockets selected by the bakeUniforms and bakedUniformNames options.
+    /// Sockets with filename type or without a value are kept.
+    /// Returns the number of sockets that were baked.
+    size_t bakeInputSockets(GenContext& context);
+
+    /// Evaluate nodes with only constant inputs at generation time, where
+    /// supported by the node implementation, and assign the resulting values
+    /// downstream. Returns the number of nodes that were folded.
+    size_t foldConstants(GenContext& context);
+
+    /// Remove all nodes that are not used by any output socket.
+    void removeUnusedNodes();
+
     /// Sort the nodes in topological order.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     void topologicalSort();
@@ -156,6 +197,10 @@ class ShaderGraph : public ShaderNode
     std::unordered_map<string, ShaderNodePtr> _nodeMap;
     std::vector<ShaderNode*> _nodeOrder;
 
+    // True once unconnected node inputs have been published
+    // as input sockets for a complete shader interface.
+    bool _inputsPublished;
+
     // Temporary storage for inputs that require color transformations
     std::unordered_map<ShaderInput*, ColorSpaceTransform> _inputColorTransformMap;
 
@@ -0,0 +1,90 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderGraphCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+
+namespace MaterialX
+{
+
+ShaderGraphCachePtr ShaderGraphCache::create()
+{
+    return ShaderGraphCachePtr(new ShaderGraphCache());
+}
+
+ShaderGraphPtr ShaderGraphCache::createGraph(const NodeGraph& nodeGraph, GenContext& context)
+{
+    const string key = getKey(nodeGraph, context);
+    auto it = _graphs.find(key);
+    if (it != _graphs.end())
+    {
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::PHASE, "ShaderGraphCache::clone");
+        _numHits++;
+        return it->second->clone(nullptr, nodeGraph.getDocument(), context.getArena());
+    }
+
+    // Create the new graph from the heap, since the template shares the
+    // implementations of its nodes, and the graphs they own, with it. The
+    // cache then outlives the arenas of the contexts using it.
+    GenArenaPtr arena = context.getArena();
+    context.setArena(nullptr);
+    ShaderGraphPtr graph;
+    try
+    {
+        graph = ShaderGraph::create(nullptr, nodeGraph, context);
+    }
+    catch (std::exception&)
+    {
+        context.setArena(arena);
+        throw;
+    }
+    context.setArena(arena);
+
+    // Store a copy of the new graph as the template, since the graph
+    // returned may be edited when creating shaders. The template holds
+    // no document, which is only needed while creating a graph.
+    _graphs[key] = graph->clone(nullptr, nullptr, nullptr);
+    return graph;
+}
+
+string ShaderGraphCache::getKey(const NodeGraph& nodeGraph, GenContext& context)
+{
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    const GenOptions& options = context.getOptions();
+    ColorManagementSystemPtr colorManagementSystem = shadergen.getColorManagementSystem();
+
+    string key = shadergen.getLanguage() + " " + shadergen.getTarget() + " ";
+    key += (colorManagementSystem ? colorManagementSystem->getName() : EMPTY_STRING) + "\n";
+    key += std::to_string(options.shaderInterfaceType) + " " +
+           std::to_string(options.fileTextureVerticalFlip) + " " +
+           options.targetColorSpaceOverride + " " +
+           std::to_string(options.hwTransparency) + " " +
+           std::to_string(options.hwSpecularEnvironmentMethod) + " " +
+           std::to_string(options.hwMaxActiveLightSources) + " " +
+           std::to_string(options.hwLightLoopHoisting) + " " +
+           std::to_string(options.optimizationLevel) + " " +
+           std::to_string(options.convolutionSamplingMethod) + " " +
+           std::to_string(options.flattenSubgraphs) + "\n";
+    key += nodeGraph.getActiveColorSpace() + "\n";
+
+    // The graph is created from the nodegraph and the interface of its nodedef.
+    for (ElementPtr elem : nodeGraph.traverseTree())
+    {
+        key += elem->asString() + "\n";
+    }
+    NodeDefPtr nodeDef = nodeGraph.getNodeDef();
+    if (nodeDef)
+    {
+        for (ElementPtr elem : nodeDef->traverseTree())
+        {
+            key += elem->asString() + "\n";
+        }
+    }
+    return key;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,85 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERGRAPHCACHE_H
+#define MATERIALX_SHADERGRAPHCACHE_H
+
+/// @file
+/// Cache of shader graphs created from nodegraphs
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXGenShader/ShaderGraph.h>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a ShaderGraphCache
+using ShaderGraphCachePtr = shared_ptr<class ShaderGraphCache>;
+
+/// @class ShaderGraphCache
+/// A cache of finalized shader graphs for nodegraph implementations.
+///
+/// When a graph cache is set on the GenContext, the graphs of nodes implemented
+/// by nodegraphs are created once and stored as templates, which are copied
+/// for later uses of the same nodegraph, instead of building the graph again
+/// from the document. This is useful when generating many shaders using the
+/// same library nodegraphs, since the cache can be kept when the context or
+/// its cached node implementations are cleared.
+///
+/// Templates are keyed by the contents of the nodegraph and its nodedef, the
+/// shader generator and the generation options. The nodes within a graph are
+/// assumed to resolve to the same definitions, so all documents using a cache
+/// should use the same data libraries. Templates are allocated from the heap
+/// and hold no document, while the graphs copied from them are allocated from
+/// the arena of the context, so a cache can be kept across documents and arenas.
+/// A cache should not be shared by contexts generating shaders concurrently.
+class ShaderGraphCache
+{
+  public:
+    /// Create a new, empty graph cache.
+    static ShaderGraphCachePtr create();
+
+    /// Return a new graph for the given nodegraph, copied from the cached
+    /// template if one exists, otherwise created from the nodegraph and
+    /// added to the cache.
+    ShaderGraphPtr createGraph(const NodeGraph& nodeGraph, GenContext& context);
+
+    /// Return the number of graph templates in the cache.
+    size_t numGraphs() const
+    {
+        return _graphs.size();
+    }
+
+    /// Return the number of graphs copied from cached templates.
+    size_t numHits() const
+    {
+        return _numHits;
+    }
+
+    /// Remove all graph templates from the cache.
+    void clear()
+    {
+        _graphs.clear();
+        _numHits = 0;
+    }
+
+  protected:
+    /// Protected constructor
+    ShaderGraphCache() :
+        _numHits(0)
+    {
+    }
+
+    /// Return the key identifying the graph for the given nodegraph and context.
+    static string getKey(const NodeGraph& nodeGraph, GenContext& context);
+
+    std::unordered_map<string, ShaderGraphPtr> _graphs;
+    size_t _numHits;
+};
+
+} // namespace MaterialX
+
+#endif
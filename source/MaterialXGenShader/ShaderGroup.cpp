@@ -0,0 +1,214 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderGroup.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/ShaderNodeImpl.h>
+
+#include <MaterialXCore/Util.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace MaterialX
+{
+
+static const string SIGNATURE_ROOT_GRAPH = "__signature__";
+
+// Return true if filenames on file texture nodes are turned
+// into texture sampler uniforms by the given generator.
+static bool hasSamplerUniforms(const ShaderGenerator& shadergen)
+{
+    return dynamic_cast<const HwShaderGenerator*>(&shadergen) != nullptr;
+}
+
+// Collect the ports of the graph that become shader uniforms,
+// in a canonical order which only depends on the graph structure.
+static void getUniformPorts(const ShaderGraph& graph, bool samplerUniforms, vector<const ShaderPort*>& ports)
+{
+    for (const ShaderGraphInputSocket* inputSocket : graph.getInputSockets())
+    {
+        if (!inputSocket->getConnections().empty() && graph.isEditable(*inputSocket))
+        {
+            ports.push_back(inputSocket);
+        }
+    }
+    if (samplerUniforms)
+    {
+        for (const ShaderNode* node : graph.getNodes())
+        {
+            if (node->hasClassification(ShaderNode::Classification::FILETEXTURE))
+            {
+                for (const ShaderInput* input : node->getInputs())
+                {
+                    if (!input->getConnection() && input->getType() == Type::FILENAME)
+                    {
+                        ports.push_back(input);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Compute the structural signature for a finalized graph. Nodes and sockets
+// are identified by their index rather than their name, and the values of
+// ports which become uniforms are left out.
+static string computeSignature(const ShaderGraph& graph, const vector<const ShaderPort*>& uniformPorts)
+{
+    const std::unordered_set<const ShaderPort*> uniforms(uniformPorts.begin(), uniformPorts.end());
+
+    std::unordered_map<const ShaderNode*, size_t> nodeIndex;
+    nodeIndex[&graph] = 0;
+    for (size_t i = 0; i < graph.getNodes().size(); ++i)
+    {
+        nodeIndex[graph.getNodes()[i]] = i + 1;
+    }
+
+    auto valueSignature = [&uniforms](const ShaderPort* port) -> string
+    {
+        if (uniforms.count(port))
+        {
+            return "<uniform>";
+        }
+        return port->getValue() ? port->getValue()->getValueString() : EMPTY_STRING;
+    };
+
+    auto connectionSignature = [&nodeIndex, &graph](const ShaderOutput* connection) -> string
+    {
+        const ShaderNode* upstream = connection->getNode();
+        size_t outputIndex = 0;
+        if (upstream == &graph)
+        {
+            const vector<ShaderGraphInputSocket*>& sockets = graph.getInputSockets();
+            outputIndex = std::find(sockets.begin(), sockets.end(), connection) - sockets.begin();
+        }
+        else
+        {
+            const vector<ShaderOutput*>& outputs = upstream->getOutputs();
+            outputIndex = std::find(outputs.begin(), outputs.end(), connection) - outputs.begin();
+        }
+        return "@" + std::to_string(nodeIndex[upstream]) + "." + std::to_string(outputIndex);
+    };
+
+    string signature;
+    for (const ShaderGraphInputSocket* inputSocket : graph.getInputSockets())
+    {
+        signature += "socket " + inputSocket->getType()->getName() + " " + valueSignature(inputSocket) + "\n";
+    }
+    for (const ShaderNode* node : graph.getNodes())
+    {
+        signature += "node " + node->getImplementation().getName() + "\n";
+        for (const ShaderInput* input : node->getInputs())
+        {
+            signature += "  " + input->getName() + " " + input->getType()->getName() + " " + input->getChannels() + " ";
+            signature += input->getConnection() ? connectionSignature(input->getConnection()) : valueSignature(input);
+            signature += "\n";
+        }
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            signature += "  " + output->getName() + " " + output->getType()->getName() + "\n";
+        }
+    }
+    for (const ShaderGraphOutputSocket* outputSocket : graph.getOutputSockets())
+    {
+        signature += "output " + outputSocket->getType()->getName() + " ";
+        signature += outputSocket->getConnection() ? connectionSignature(outputSocket->getConnection()) : valueSignature(outputSocket);
+        signature += "\n";
+    }
+
+    return signature;
+}
+
+string getStructuralSignature(ElementPtr element, GenContext& context)
+{
+    ShaderGraphPtr graph = ShaderGraph::create(nullptr, SIGNATURE_ROOT_GRAPH, element, context);
+
+    vector<const ShaderPort*> uniformPorts;
+    getUniformPorts(*graph, hasSamplerUniforms(context.getShaderGenerator()), uniformPorts);
+
+    return computeSignature(*graph, uniformPorts);
+}
+
+void generateShaderGroups(const vector<TypedElementPtr>& elements, GenContext& context,
+                          vector<ShaderGroup>& groups)
+{
+    const bool samplerUniforms = hasSamplerUniforms(context.getShaderGenerator());
+
+    // Values of the uniform ports in canonical order, for each element in each group.
+    vector<vector<vector<ValuePtr>>> groupValues;
+
+    std::unordered_map<string, size_t> groupIndex;
+    for (TypedElementPtr element : elements)
+    {
+        ShaderGraphPtr graph = ShaderGraph::create(nullptr, SIGNATURE_ROOT_GRAPH, element, context);
+
+        vector<const ShaderPort*> uniformPorts;
+        getUniformPorts(*graph, samplerUniforms, uniformPorts);
+        const string signature = computeSignature(*graph, uniformPorts);
+
+        auto it = groupIndex.find(signature);
+        if (it == groupIndex.end())
+        {
+            it = groupIndex.insert(std::make_pair(signature, groups.size())).first;
+            groups.push_back(ShaderGroup());
+            groupValues.push_back(vector<vector<ValuePtr>>());
+        }
+
+        vector<ValuePtr> values;
+        for (const ShaderPort* port : uniformPorts)
+        {
+            values.push_back(port->getValue());
+        }
+        groups[it->second].elements.push_back(element);
+        groupValues[it->second].push_back(values);
+    }
+
+    // Generate one shader per group, and map the uniform values
+    // of each element onto the uniform names of the group's shader.
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        ShaderGroup& group = groups[i];
+        TypedElementPtr first = group.elements[0];
+        group.shader = context.getShaderGenerator().generate(createValidName(first->getNamePath()), first, context);
+
+        // Uniforms may be removed during generation if they are unused,
+        // so only report values for uniforms present in the shader.
+        StringSet shaderUniforms;
+        for (size_t j = 0; j < group.shader->numStages(); ++j)
+        {
+            for (auto it : group.shader->getStage(j).getUniformBlocks())
+            {
+                const VariableBlock& block = *it.second;
+                for (size_t k = 0; k < block.size(); ++k)
+                {
+                    shaderUniforms.insert(block[k]->getVariable());
+                }
+            }
+        }
+
+        vector<const ShaderPort*> uniformPorts;
+        getUniformPorts(group.shader->getGraph(), samplerUniforms, uniformPorts);
+
+        for (const vector<ValuePtr>& values : groupValues[i])
+        {
+            UniformValueMap uniformValues;
+            for (size_t j = 0; j < uniformPorts.size(); ++j)
+            {
+                const string& variable = uniformPorts[j]->getVariable();
+                if (shaderUniforms.count(variable))
+                {
+                    uniformValues[variable] = values[j];
+                }
+            }
+            group.uniformValues.push_back(uniformValues);
+        }
+    }
+}
+
+} // namespace MaterialX
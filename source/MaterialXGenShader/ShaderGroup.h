@@ -0,0 +1,60 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERGROUP_H
+#define MATERIALX_SHADERGROUP_H
+
+/// @file
+/// Grouping of renderable elements sharing the same shader
+
+#include <MaterialXGenShader/Library.h>
+#include <MaterialXGenShader/Shader.h>
+
+#include <MaterialXCore/Element.h>
+#include <MaterialXCore/Value.h>
+
+#include <map>
+
+namespace MaterialX
+{
+
+class GenContext;
+
+/// A map of uniform values, keyed by the uniform variable name in the shader.
+using UniformValueMap = std::map<string, ValuePtr>;
+
+/// @class ShaderGroup
+/// A shader shared by a group of elements which are structurally identical,
+/// and differ only in the values of their shader uniforms.
+class ShaderGroup
+{
+  public:
+    /// The shader generated for the group.
+    ShaderPtr shader;
+
+    /// The elements sharing the shader.
+    vector<TypedElementPtr> elements;
+
+    /// Uniform values for each element, in the same order as the elements.
+    /// The values are keyed by the uniform variable names used in the shader,
+    /// so they can be bound directly to the shader program.
+    vector<UniformValueMap> uniformValues;
+};
+
+/// Return a structural signature for the shader generated for the given element.
+/// The signature ignores element names and the values of any inputs that become
+/// shader uniforms, so elements with equal signatures generate the same shader
+/// code apart from variable naming, and can share a single shader.
+string getStructuralSignature(ElementPtr element, GenContext& context);
+
+/// Group the given elements by their structural signature, and generate
+/// one shader per group. The uniform values of each element are returned
+/// in the group, keyed by the uniform names of the group's shader.
+void generateShaderGroups(const vector<TypedElementPtr>& elements, GenContext& context,
+                          vector<ShaderGroup>& groups);
+
+} // namespace MaterialX
+
+#endif
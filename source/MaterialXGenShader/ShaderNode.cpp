@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGraph.h>
 #include <MaterialXGenShader/ShaderNodeImpl.h>
 #include <MaterialXGenShader/TypeDesc.h>
 #include <MaterialXGenShader/Util.h>
@@ -14,6 +15,45 @@
 namespace MaterialX
 {
 
+namespace
+{
+    // Ports are indexed by name once a node has more than this many.
+    const size_t MAX_UNINDEXED_PORTS = 16;
+
+    template<class T> T* findPort(const string& name, const vector<T*>& ports,
+                                  const std::unordered_map<string, T*>& index)
+    {
+        if (!index.empty())
+        {
+            auto it = index.find(name);
+            return it != index.end() ? it->second : nullptr;
+        }
+        for (T* port : ports)
+        {
+            if (port->getName() == name)
+            {
+                return port;
+            }
+        }
+        return nullptr;
+    }
+
+    template<class T> void indexPort(T* port, const vector<T*>& ports, std::unordered_map<string, T*>& index)
+    {
+        if (!index.empty())
+        {
+            index[port->getName()] = port;
+        }
+        else if (ports.size() > MAX_UNINDEXED_PORTS)
+        {
+            for (T* p : ports)
+            {
+                index[p->getName()] = p;
+            }
+        }
+    }
+}
+
 //
 // ShaderPort methods
 //
@@ -124,6 +164,7 @@ ShaderNode::ShaderNode(const ShaderGraph* parent, const string& name) :
     _parent(parent),
     _name(name),
     _classification(0),
+    _arena(parent ? parent->_arena : nullptr),
     _impl(nullptr)
 {
 }
@@ -193,7 +234,7 @@ void ShaderNode::ScopeInfo::merge(const ScopeInfo &fromScope)
 
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
-    ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    ShaderNodePtr newNode = allocateShared<ShaderNode>(parent ? parent->_arena : nullptr, parent, name);
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
@@ -318,17 +359,27 @@ ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name,
     else if (groupName == TEXTURE2D_GROUPNAME || groupName == TEXTURE3D_GROUPNAME)
     {
         newNode->_classification = Classification::TEXTURE | Classification::FILETEXTURE;
+        if (nodeDef.getNodeString() == IMAGE)
+        {
+            newNode->_classification |= Classification::IMAGE;
+        }
     }
 
     // Add in group classification
     newNode->_classification |= groupClassification;
 
+    if (GenProfiler* profiler = context.getProfiler())
+    {
+        profiler->addCount("ShaderNode");
+        profiler->addCount("ShaderPort", newNode->numInputs() + newNode->numOutputs());
+    }
+
     return newNode;
 }
 
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, ShaderNodeImplPtr impl, unsigned int classification)
 {
-    ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    ShaderNodePtr newNode = allocateShared<ShaderNode>(parent ? parent->_arena : nullptr, parent, name);
     newNode->_impl = impl;
     newNode->_classification = classification;
     return newNode;
@@ -406,26 +457,22 @@ void ShaderNode::setValues(const Node& node, const NodeDef& nodeDef, GenContext&
 
 ShaderInput* ShaderNode::getInput(const string& name)
 {
-    auto it = _inputMap.find(name);
-    return it != _inputMap.end() ? it->second.get() : nullptr;
+    return findPort(name, _inputOrder, _inputIndex);
 }
 
 ShaderOutput* ShaderNode::getOutput(const string& name)
 {
-    auto it = _outputMap.find(name);
-    return it != _outputMap.end() ? it->second.get() : nullptr;
+    return findPort(name, _outputOrder, _outputIndex);
 }
 
 const ShaderInput* ShaderNode::getInput(const string& name) const
 {
-    auto it = _inputMap.find(name);
-    return it != _inputMap.end() ? it->second.get() : nullptr;
+    return const_cast<ShaderNode*>(this)->getInput(name);
 }
 
 const ShaderOutput* ShaderNode::getOutput(const string& name) const
 {
-    auto it = _outputMap.find(name);
-    return it != _outputMap.end() ? it->second.get() : nullptr;
+    return const_cast<ShaderNode*>(this)->getOutput(name);
 }
 
 ShaderInput* ShaderNode::addInput(const string& name, const TypeDesc* type)
@@ -435,9 +482,10 @@ ShaderInput* ShaderNode::addInput(const string& name, const TypeDesc* type)
         throw ExceptionShaderGenError("An input named '" + name + "' already exists on node '" + _name + "'");
     }
 
-    ShaderInputPtr input = std::make_shared<ShaderInput>(this, type, name);
-    _inputMap[name] = input;
+    ShaderInputPtr input = allocateShared<ShaderInput>(_arena, this, type, name);
+    _inputs.push_back(input);
     _inputOrder.push_back(input.get());
+    indexPort(input.get(), _inputOrder, _inputIndex);
 
     return input.get();
 }
@@ -449,9 +497,10 @@ ShaderOutput* ShaderNode::addOutput(const string& name, const TypeDesc* type)
         throw ExceptionShaderGenError("An output named '" + name + "' already exists on node '" + _name + "'");
     }
 
-    ShaderOutputPtr output = std::make_shared<ShaderOutput>(this, type, name);
-    _outputMap[name] = output;
+    ShaderOutputPtr output = allocateShared<ShaderOutput>(_arena, this, type, name);
+    _outputs.push_back(output);
     _outputOrder.push_back(output.get());
+    indexPort(output.get(), _outputOrder, _outputIndex);
 
     return output.get();
 }
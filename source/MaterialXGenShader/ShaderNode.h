@@ -11,6 +11,7 @@
 
 #include <MaterialXGenShader/Library.h>
 
+#include <MaterialXGenShader/GenArena.h>
 #include <MaterialXGenShader/ShaderNodeImpl.h>
 #include <MaterialXGenShader/TypeDesc.h>
 
@@ -43,6 +44,9 @@ class ShaderPort : public std::enable_shared_from_this<ShaderPort>
   public:
     /// Flags set on shader ports.
     static const unsigned int EMITTED = 1 << 0;
+    /// Set on graph input sockets created when publishing
+    /// node inputs for a complete shader interface.
+    static const unsigned int AUTO_PUBLISHED = 1 << 1;
 
     ShaderPort(ShaderNode* node, const TypeDesc* type, const string& name, ValuePtr value = nullptr);
 
@@ -215,6 +219,8 @@ class ShaderNode
         static const unsigned int SAMPLE2D    = 1 << 16; /// Can be sampled in 2D (uv space)
         static const unsigned int SAMPLE3D    = 1 << 17; /// Can be sampled in 3D (position)
         static const unsigned int CONVOLUTION2D = 1 << 18; /// Performs a convolution in 2D (uv space)
+        // Specific file texture types
+        static const unsigned int IMAGE       = 1 << 19; /// An image node sampling a single file texture
     };
 
     /// @struct ScopeInfo
@@ -369,16 +375,31 @@ class ShaderNode
         return (!_impl || _impl->isEditable(input));
     }
 
+    /// Returns true if the code emitted for this node reads the given input.
+    bool isUsed(const ShaderInput& input, const GenContext& context) const
+    {
+        return (!_impl || _impl->isUsed(input, context));
+    }
+
   protected:
     const ShaderGraph* _parent;
     string _name;
     unsigned int _classification;
 
-    std::unordered_map<string, ShaderInputPtr> _inputMap;
+    // Ports are few on most nodes, so they are stored in flat vectors
+    // and found by name with a linear search. Nodes with many ports,
+    // such as the sockets of a graph, also index them by name.
+    vector<ShaderInputPtr> _inputs;
     vector<ShaderInput*> _inputOrder;
+    std::unordered_map<string, ShaderInput*> _inputIndex;
 
-    std::unordered_map<string, ShaderOutputPtr> _outputMap;
+    vector<ShaderOutputPtr> _outputs;
     vector<ShaderOutput*> _outputOrder;
+    std::unordered_map<string, ShaderOutput*> _outputIndex;
+
+    // Arena used for allocating nodes and ports in this
+    // node's graph, or nullptr to allocate from the heap.
+    GenArenaPtr _arena;
 
     ShaderNodeImplPtr _impl;
     ScopeInfo _scopeInfo;
@@ -12,6 +12,7 @@
 #include <MaterialXGenShader/Library.h>
 
 #include <MaterialXCore/Util.h>
+#include <MaterialXCore/Value.h>
 
 namespace MaterialX
 {
@@ -70,6 +71,15 @@ class ShaderNodeImpl
     /// Emit function definition for the given node instance.
     virtual void emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const;
 
+    /// Return true if the function definition emitted by this implementation
+    /// only depends on the implementation itself, and not on the shader it's
+    /// used in, so it can be shared between shaders in a function library.
+    /// By default this is false.
+    virtual bool hasShareableDefinition() const
+    {
+        return false;
+    }
+
     /// Emit the function call or inline source code for given node instance in the given context.
     virtual void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const;
 
@@ -95,6 +105,25 @@ class ShaderNodeImpl
         return true;
     }
 
+    /// Returns true if the code emitted for a node reads the given input.
+    /// Inputs which are only read at generation time, such as the space of
+    /// geometric nodes, are not read by the emitted code, so a uniform
+    /// connected to them is never referenced.
+    /// By default all inputs are considered to be read.
+    virtual bool isUsed(const ShaderInput& /*input*/, const GenContext& /*context*/) const
+    {
+        return true;
+    }
+
+    /// Evaluate the output value of the given node instance at generation time.
+    /// Only called when all inputs on the node are unconnected, and used for
+    /// folding constant nodes in shader graphs. Returns nullptr if the output
+    /// can't be evaluated, which is the default.
+    virtual ValuePtr evaluateConstant(const ShaderNode& /*node*/, GenContext& /*context*/) const
+    {
+        return nullptr;
+    }
+
   protected:
     /// Protected constructor
     ShaderNodeImpl();
@@ -6,6 +6,7 @@
 #include <MaterialXGenShader/ShaderStage.h>
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderFunctionLibrary.h>
 #include <MaterialXGenShader/Syntax.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -327,7 +328,21 @@ void ShaderStage::addInclude(const string& file, GenContext& context)
             throw ExceptionShaderGenError("Could not find include file: '" + file + "'");
         }
         _includes.insert(path);
+
+        // When sharing functions through a library the same file can be included
+        // by both the library and the shader, so guard against multiple inclusion.
+        const string guard = context.getFunctionLibrary() && getName() == Stage::PIXEL ?
+                             "MX_INCLUDE_" + std::to_string(std::hash<string>{}(path)) : EMPTY_STRING;
+        if (!guard.empty())
+        {
+            addLine("#ifndef " + guard, false);
+            addLine("#define " + guard, false);
+        }
         addBlock(content, context);
+        if (!guard.empty())
+        {
+            addLine("#endif", false);
+        }
     }
 }
 
@@ -339,6 +354,33 @@ void ShaderStage::addFunctionDefinition(const ShaderNode& node, GenContext& cont
     if (!_definedFunctions.count(id))
     {
         _definedFunctions.insert(id);
+
+        // Emit shareable definitions into the function library if one is set,
+        // and include the library in this stage before its first use.
+        ShaderFunctionLibraryPtr library = context.getFunctionLibrary();
+        if (library && getName() == Stage::PIXEL && impl.hasShareableDefinition() &&
+            library->_stage.get() != this)
+        {
+            if (!library->_stage)
+            {
+                library->_stage = std::make_shared<ShaderStage>(Stage::PIXEL, _syntax);
+                library->_includeStatement = _syntax->getIncludeStatement() + " " +
+                    _syntax->getStringQuote() + library->getName() + _syntax->getStringQuote();
+            }
+            if (!_includes.count(library->getName()))
+            {
+                _includes.insert(library->getName());
+                addLine(library->_includeStatement, false);
+            }
+            library->_stage->addFunctionDefinition(node, context);
+            return;
+        }
+        if (library && library->_stage.get() == this && impl.hasShareableDefinition())
+        {
+            library->_numFunctions++;
+        }
+
+        GenProfilerScope profilerScope(context.getProfiler(), GenProfiler::FUNCTION_DEFINITION, impl.getName().c_str());
         impl.emitFunctionDefinition(node, context, *this);
     }
 }
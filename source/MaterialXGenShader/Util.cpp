@@ -579,4 +579,42 @@ ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const stri
     return valueElement;
 }
 
+string escapeJsonString(const string& str)
+{
+    string result;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (c == '\n')
+        {
+            result += "\\n";
+        }
+        else if (c == '\r')
+        {
+            result += "\\r";
+        }
+        else if (c == '\t')
+        {
+            result += "\\t";
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            // Other control characters are escaped by code point.
+            static const char* HEX_DIGITS = "0123456789abcdef";
+            result += "\\u00";
+            result += HEX_DIGITS[(c >> 4) & 0xf];
+            result += HEX_DIGITS[c & 0xf];
+        }
+        else
+        {
+            result += c;
+        }
+    }
+    return result;
+}
+
 } // namespace MaterialX
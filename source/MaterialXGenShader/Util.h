@@ -73,6 +73,10 @@ void findRenderableElements(ConstDocumentPtr doc, vector<TypedElementPtr>& eleme
 /// if the path is to a Node as definitions for Nodes can be target specific.
 ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const string& target);
 
+/// Return the given string escaped for use within a JSON string. Quotes,
+/// backslashes and all control characters are escaped.
+string escapeJsonString(const string& str);
+
 } // namespace MaterialX
 
 #endif
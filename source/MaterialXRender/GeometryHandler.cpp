@@ -83,7 +83,14 @@ bool GeometryHandler::loadGeometry(const FilePath& filePath)
         return true;
     }
 
+    if (_meshCache && _meshCache->readMeshes(filePath, _meshes))
+    {
+        computeBounds();
+        return true;
+    }
+
     bool loaded = false;
+    const size_t firstMesh = _meshes.size();
 
     std::pair <GeometryLoaderMap::iterator, GeometryLoaderMap::iterator> range;
     string extension = filePath.getExtension();
@@ -99,9 +106,22 @@ bool GeometryHandler::loadGeometry(const FilePath& filePath)
         }
     }
 
-    // Recompute bounds if load was successful
+    // Optimize and cache the new meshes and recompute bounds if load was successful
     if (loaded)
     {
+        if (_optimizeMeshes)
+        {
+            for (size_t i = firstMesh; i < _meshes.size(); i++)
+            {
+                _meshes[i]->optimizeVertexCache();
+                _meshes[i]->optimizeOverdraw();
+                _meshes[i]->optimizeVertexFetch();
+            }
+        }
+        if (_meshCache)
+        {
+            _meshCache->writeMeshes(filePath, MeshList(_meshes.begin() + firstMesh, _meshes.end()));
+        }
         computeBounds();
     }
 
@@ -11,6 +11,7 @@
 
 #include <MaterialXFormat/File.h>
 #include <MaterialXRender/Mesh.h>
+#include <MaterialXRender/MeshCache.h>
 #include <memory>
 #include <map>
 
@@ -63,7 +64,10 @@ class GeometryHandler
 {
   public:
     /// Default constructor
-    GeometryHandler() {};
+    GeometryHandler() :
+        _optimizeMeshes(false)
+    {
+    }
 
     /// Default destructor
     virtual ~GeometryHandler() {};
@@ -90,9 +94,40 @@ class GeometryHandler
     // Find all meshes loaded from a given location
     void getGeometry(MeshList& meshes, const string& location);
 
-    /// Load geometry from a given location
+    /// Load geometry from a given location. If a mesh cache is set, the
+    /// meshes are read from the cache when it holds a valid entry for the
+    /// file, and are otherwise loaded and written to the cache.
     bool loadGeometry(const FilePath& filePath);
 
+    /// Set the cache of binary meshes used when loading geometry. Defaults
+    /// to nullptr, which disables caching.
+    void setMeshCache(MeshCachePtr cache)
+    {
+        _meshCache = cache;
+    }
+
+    /// Return the cache of binary meshes used when loading geometry.
+    MeshCachePtr getMeshCache() const
+    {
+        return _meshCache;
+    }
+
+    /// Set whether newly loaded meshes are optimized for rendering, by
+    /// reordering their faces for the post-transform vertex cache and for
+    /// overdraw, and their vertices for fetching. Defaults to false.
+    /// Meshes are written to the mesh cache as optimized, so entries written
+    /// with a different setting should be removed when it changes.
+    void setOptimizeMeshes(bool enable)
+    {
+        _optimizeMeshes = enable;
+    }
+
+    /// Return true if newly loaded meshes are optimized for rendering.
+    bool getOptimizeMeshes() const
+    {
+        return _optimizeMeshes;
+    }
+
     /// Get list of meshes
     const MeshList& getMeshes() const
     {
@@ -119,6 +154,8 @@ class GeometryHandler
     MeshList _meshes;
     Vector3 _minimumBounds;
     Vector3 _maximumBounds;
+    MeshCachePtr _meshCache;
+    bool _optimizeMeshes;
 };
 
 } // namespace MaterialX
@@ -6,7 +6,16 @@
 #include <MaterialXCore/Types.h>
 #include <MaterialXGenShader/Util.h>
 #include <MaterialXRender/ImageHandler.h>
+#include <MaterialXRender/Util.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MATERIALX_USE_SSE2
+#endif
 
 namespace MaterialX
 {
@@ -30,6 +39,532 @@ void ImageDesc::freeResourceBuffer()
         }
         resourceBuffer = nullptr;
     }
+    mipBuffers.clear();
+}
+
+namespace
+{
+    // Levels with fewer pixels than this are filtered on the calling thread.
+    const size_t MIN_PARALLEL_PIXELS = 256 * 256;
+
+    // A tap of a filter downsampling by two, at an offset from the
+    // first of the two source pixels under the destination pixel.
+    struct FilterTap
+    {
+        int offset;
+        float weight;
+    };
+
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++)
+        {
+            const double halfX = x / (2.0 * k);
+            term *= halfX * halfX;
+            sum += term;
+        }
+        return sum;
+    }
+
+    vector<FilterTap> getFilterTaps(ImageDesc::MipFilter filter)
+    {
+        if (filter == ImageDesc::MipFilter::BOX)
+        {
+            return { { 0, 0.5f }, { 1, 0.5f } };
+        }
+
+        // Sinc with a cutoff at half the source frequency, windowed by a
+        // Kaiser window which covers three source pixels on each side.
+        const double PI = 3.14159265358979323846;
+        const double ALPHA = 4.0;
+        const double RADIUS = 3.0;
+        vector<FilterTap> taps;
+        double sum = 0.0;
+        vector<double> weights;
+        for (int offset = -2; offset <= 3; offset++)
+        {
+            const double x = std::abs(offset - 0.5);
+            const double sinc = std::sin(PI * x * 0.5) / (PI * x * 0.5);
+            const double t = x / RADIUS;
+            const double window = besselI0(ALPHA * std::sqrt(1.0 - t * t)) / besselI0(ALPHA);
+            weights.push_back(sinc * window);
+            sum += weights.back();
+        }
+        for (int offset = -2; offset <= 3; offset++)
+        {
+            taps.push_back({ offset, float(weights[offset + 2] / sum) });
+        }
+        return taps;
+    }
+
+    size_t getBytesPerChannel(const ImageDesc::BaseType& baseType)
+    {
+        if (baseType == ImageDesc::BASETYPE_FLOAT)
+        {
+            return 4;
+        }
+        if (baseType == ImageDesc::BASETYPE_HALF)
+        {
+            return 2;
+        }
+        return 1;
+    }
+
+    void convertToFloat(const void* source, float* dest, size_t count, const ImageDesc::BaseType& baseType)
+    {
+        if (baseType == ImageDesc::BASETYPE_FLOAT)
+        {
+            std::memcpy(dest, source, count * sizeof(float));
+        }
+        else if (baseType == ImageDesc::BASETYPE_HALF)
+        {
+            convertHalfToFloat(static_cast<const uint16_t*>(source), dest, count);
+        }
+        else
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(source);
+            size_t i = 0;
+#ifdef MATERIALX_USE_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+                const __m128i low = _mm_unpacklo_epi8(value, zero);
+                const __m128i high = _mm_unpackhi_epi8(value, zero);
+                _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+                _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+                _mm_storeu_ps(dest + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+                _mm_storeu_ps(dest + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                dest[i] = float(bytes[i]);
+            }
+        }
+    }
+
+    void convertFromFloat(const float* source, void* dest, size_t count, const ImageDesc::BaseType& baseType)
+    {
+        if (baseType == ImageDesc::BASETYPE_FLOAT)
+        {
+            std::memcpy(dest, source, count * sizeof(float));
+        }
+        else if (baseType == ImageDesc::BASETYPE_HALF)
+        {
+            convertFloatToHalf(source, static_cast<uint16_t*>(dest), count);
+        }
+        else
+        {
+            // Round to nearest even, and saturate to the range of a byte.
+            uint8_t* bytes = static_cast<uint8_t*>(dest);
+            size_t i = 0;
+#ifdef MATERIALX_USE_SSE2
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m128i a = _mm_cvtps_epi32(_mm_loadu_ps(source + i));
+                const __m128i b = _mm_cvtps_epi32(_mm_loadu_ps(source + i + 4));
+                const __m128i c = _mm_cvtps_epi32(_mm_loadu_ps(source + i + 8));
+                const __m128i d = _mm_cvtps_epi32(_mm_loadu_ps(source + i + 12));
+                const __m128i value = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), value);
+            }
+#endif
+            for (; i < count; i++)
+            {
+                bytes[i] = uint8_t(std::min(std::max(std::nearbyint(source[i]), 0.0f), 255.0f));
+            }
+        }
+    }
+
+    // Add a weighted source row to the destination row.
+    void accumulateRow(const float* source, float weight, float* dest, size_t count)
+    {
+        size_t i = 0;
+#ifdef MATERIALX_USE_SSE2
+        const __m128 weights = _mm_set1_ps(weight);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 value = _mm_mul_ps(_mm_loadu_ps(source + i), weights);
+            _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), value));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            dest[i] += source[i] * weight;
+        }
+    }
+
+    // Downsample a row horizontally by two.
+    void downsampleRow(const float* source, unsigned int sourceWidth, float* dest, unsigned int destWidth,
+                       unsigned int channelCount, const vector<FilterTap>& taps)
+    {
+        const int lastPixel = int(sourceWidth) - 1;
+#ifdef MATERIALX_USE_SSE2
+        if (channelCount == 4)
+        {
+            for (unsigned int x = 0; x < destWidth; x++)
+            {
+                __m128 sum = _mm_setzero_ps();
+                for (const FilterTap& tap : taps)
+                {
+                    const int pixel = std::min(std::max(int(2 * x) + tap.offset, 0), lastPixel);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + pixel * 4), _mm_set1_ps(tap.weight)));
+                }
+                _mm_storeu_ps(dest + x * 4, sum);
+            }
+            return;
+        }
+#endif
+        for (unsigned int x = 0; x < destWidth; x++)
+        {
+            float* destPixel = dest + x * channelCount;
+            std::fill(destPixel, destPixel + channelCount, 0.0f);
+            for (const FilterTap& tap : taps)
+            {
+                const int pixel = std::min(std::max(int(2 * x) + tap.offset, 0), lastPixel);
+                const float* sourcePixel = source + pixel * channelCount;
+                for (unsigned int c = 0; c < channelCount; c++)
+                {
+                    destPixel[c] += sourcePixel[c] * tap.weight;
+                }
+            }
+        }
+    }
+
+    // Call the function for ranges of rows, on up to the given number of threads.
+    void parallelRows(unsigned int rowCount, unsigned int numThreads, const std::function<void(unsigned int, unsigned int)>& function)
+    {
+        numThreads = std::max(std::min(numThreads, rowCount), 1u);
+        const unsigned int rowsPerThread = (rowCount + numThreads - 1) / numThreads;
+        vector<std::thread> threads;
+        for (unsigned int begin = rowsPerThread; begin < rowCount; begin += rowsPerThread)
+        {
+            threads.emplace_back(function, begin, std::min(begin + rowsPerThread, rowCount));
+        }
+        function(0, std::min(rowsPerThread, rowCount));
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+bool ImageDesc::generateMipMaps(MipFilter filter, unsigned int numThreads)
+{
+    mipBuffers.clear();
+    if (!resourceBuffer || width == 0 || height == 0 || channelCount == 0)
+    {
+        return false;
+    }
+    if (baseType != BASETYPE_UINT8 && baseType != BASETYPE_HALF && baseType != BASETYPE_FLOAT)
+    {
+        return false;
+    }
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    computeMipCount();
+
+    // Levels are filtered as floats, and each level is filtered from the
+    // float values of the level above it, before conversion to the base type.
+    const vector<FilterTap> taps = getFilterTaps(filter);
+    const size_t bytesPerChannel = getBytesPerChannel(baseType);
+    vector<float> source(size_t(width) * height * channelCount);
+    const size_t rowSize = size_t(width) * channelCount;
+    parallelRows(height, size_t(width) * height >= MIN_PARALLEL_PIXELS ? numThreads : 1,
+        [&](unsigned int begin, unsigned int end)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(resourceBuffer);
+        convertToFloat(bytes + begin * rowSize * bytesPerChannel, source.data() + begin * rowSize,
+                       (end - begin) * rowSize, baseType);
+    });
+
+    for (unsigned int level = 1; level < mipCount; level++)
+    {
+        const unsigned int sourceWidth = getMipWidth(level - 1);
+        const unsigned int sourceHeight = getMipHeight(level - 1);
+        const unsigned int destWidth = getMipWidth(level);
+        const unsigned int destHeight = getMipHeight(level);
+        const size_t sourceRowSize = size_t(sourceWidth) * channelCount;
+        const size_t destRowSize = size_t(destWidth) * channelCount;
+
+        std::shared_ptr<void> buffer(malloc(destRowSize * destHeight * bytesPerChannel), free);
+        if (!buffer)
+        {
+            mipBuffers.clear();
+            return false;
+        }
+        vector<float> dest(destRowSize * destHeight);
+
+        // Filter vertically into a row of the source width,
+        // then horizontally into the destination row.
+        parallelRows(destHeight, size_t(destWidth) * destHeight >= MIN_PARALLEL_PIXELS ? numThreads : 1,
+            [&](unsigned int begin, unsigned int end)
+        {
+            vector<float> row(sourceRowSize);
+            const int lastRow = int(sourceHeight) - 1;
+            for (unsigned int y = begin; y < end; y++)
+            {
+                std::fill(row.begin(), row.end(), 0.0f);
+                for (const FilterTap& tap : taps)
+                {
+                    const int sourceRow = std::min(std::max(int(2 * y) + tap.offset, 0), lastRow);
+                    accumulateRow(source.data() + sourceRow * sourceRowSize, tap.weight, row.data(), sourceRowSize);
+                }
+                float* destRow = dest.data() + y * destRowSize;
+                downsampleRow(row.data(), sourceWidth, destRow, destWidth, channelCount, taps);
+                convertFromFloat(destRow, static_cast<uint8_t*>(buffer.get()) + y * destRowSize * bytesPerChannel,
+                                 destRowSize, baseType);
+            }
+        });
+
+        mipBuffers.push_back(buffer);
+        source.swap(dest);
+    }
+    return true;
+}
+
+const size_t ImageBufferCache::DEFAULT_BUDGET = 512 * 1024 * 1024;
+
+ImageBufferCache::ImageBufferCache(size_t budget) :
+    _budget(budget),
+    _size(0)
+{
+}
+
+void ImageBufferCache::setBudget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budget = budget;
+    evict();
+}
+
+size_t ImageBufferCache::getBudget() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _budget;
+}
+
+size_t ImageBufferCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+size_t ImageBufferCache::numImages() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+bool ImageBufferCache::hasImage(const string& filePath) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.count(filePath) != 0;
+}
+
+void ImageBufferCache::addImage(const string& filePath, ImageDesc& imageDesc)
+{
+    if (!imageDesc.resourceBuffer)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The buffer may already be owned by the cache, if the
+    // image description was returned from it.
+    auto it = _entries.find(filePath);
+    if (it != _entries.end())
+    {
+        if (it->second.buffer.get() == imageDesc.resourceBuffer)
+        {
+            _order.splice(_order.begin(), _order, it->second.order);
+            return;
+        }
+        removeImageLocked(filePath);
+    }
+
+    Entry& entry = _entries[filePath];
+    const ImageBufferDeallocator deallocator = imageDesc.resourceBufferDeallocator;
+    entry.buffer = std::shared_ptr<void>(imageDesc.resourceBuffer, [deallocator](void* buffer)
+    {
+        if (deallocator)
+        {
+            deallocator(buffer);
+        }
+        else
+        {
+            free(buffer);
+        }
+    });
+    entry.desc = imageDesc;
+    entry.desc.resourceBuffer = nullptr;
+    entry.desc.resourceBufferDeallocator = nullptr;
+    entry.size = getBufferSize(imageDesc) + getMipBuffersSize(imageDesc);
+    _order.push_front(filePath);
+    entry.order = _order.begin();
+    _size += entry.size;
+
+    assignBuffer(entry, imageDesc);
+    evict();
+}
+
+bool ImageBufferCache::getImage(const string& filePath, ImageDesc& imageDesc, bool generateMipMaps)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(filePath);
+    if (it == _entries.end())
+    {
+        _statistics.misses++;
+        return false;
+    }
+    _statistics.hits++;
+    Entry& entry = it->second;
+    _order.splice(_order.begin(), _order, entry.order);
+    bool mipMapsAdded = false;
+    if (generateMipMaps && entry.desc.mipBuffers.empty())
+    {
+        // Generate the levels from the shared buffer, which the
+        // temporary description must not free.
+        ImageDesc mipDesc = entry.desc;
+        mipDesc.resourceBuffer = entry.buffer.get();
+        if (mipDesc.generateMipMaps())
+        {
+            entry.desc.mipBuffers = mipDesc.mipBuffers;
+            entry.desc.mipCount = mipDesc.mipCount;
+            const size_t mipSize = getMipBuffersSize(entry.desc);
+            entry.size += mipSize;
+            _size += mipSize;
+            mipMapsAdded = true;
+        }
+        mipDesc.resourceBuffer = nullptr;
+    }
+    assignBuffer(entry, imageDesc);
+    if (mipMapsAdded)
+    {
+        evict();
+    }
+    return true;
+}
+
+void ImageBufferCache::removeImage(const string& filePath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    removeImageLocked(filePath);
+}
+
+void ImageBufferCache::removeImageLocked(const string& filePath)
+{
+    auto it = _entries.find(filePath);
+    if (it != _entries.end())
+    {
+        _size -= it->second.size;
+        _order.erase(it->second.order);
+        _entries.erase(it);
+    }
+}
+
+void ImageBufferCache::setPinned(const string& filePath, bool pinned)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(filePath);
+    if (it != _entries.end())
+    {
+        it->second.pinned = pinned;
+        if (!pinned)
+        {
+            evict();
+        }
+    }
+}
+
+bool ImageBufferCache::isPinned(const string& filePath) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(filePath);
+    return it != _entries.end() && it->second.pinned;
+}
+
+void ImageBufferCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _order.clear();
+    _size = 0;
+}
+
+ImageBufferCache::Statistics ImageBufferCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void ImageBufferCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statistics = Statistics();
+}
+
+size_t ImageBufferCache::getBufferSize(const ImageDesc& imageDesc)
+{
+    size_t bytesPerChannel = 1;
+    if (imageDesc.baseType == ImageDesc::BASETYPE_FLOAT)
+    {
+        bytesPerChannel = 4;
+    }
+    else if (imageDesc.baseType == ImageDesc::BASETYPE_HALF)
+    {
+        bytesPerChannel = 2;
+    }
+    return size_t(imageDesc.width) * size_t(imageDesc.height) * size_t(imageDesc.channelCount) * bytesPerChannel;
+}
+
+size_t ImageBufferCache::getMipBuffersSize(const ImageDesc& imageDesc)
+{
+    const size_t pixelSize = getBytesPerChannel(imageDesc.baseType) * imageDesc.channelCount;
+    size_t size = 0;
+    for (unsigned int level = 1; level <= imageDesc.mipBuffers.size(); level++)
+    {
+        size += pixelSize * imageDesc.getMipWidth(level) * imageDesc.getMipHeight(level);
+    }
+    return size;
+}
+
+void ImageBufferCache::evict()
+{
+    // Walk from the least recently used image, skipping pinned images.
+    auto it = _order.end();
+    while (_size > _budget && it != _order.begin())
+    {
+        --it;
+        auto entry = _entries.find(*it);
+        if (entry->second.pinned)
+        {
+            continue;
+        }
+        _size -= entry->second.size;
+        _entries.erase(entry);
+        it = _order.erase(it);
+        _statistics.evictions++;
+    }
+}
+
+void ImageBufferCache::assignBuffer(const Entry& entry, ImageDesc& imageDesc)
+{
+    // The description holds a reference to the shared buffer,
+    // which is released when its resource buffer is freed.
+    std::shared_ptr<void> buffer = entry.buffer;
+    imageDesc = entry.desc;
+    imageDesc.resourceBuffer = buffer.get();
+    imageDesc.resourceBufferDeallocator = [buffer](void*) mutable
+    {
+        buffer.reset();
+    };
 }
 
 string ImageLoader::BMP_EXTENSION = "bmp";
@@ -102,13 +637,52 @@ bool ImageHandler::saveImage(const FilePath& filePath,
     return false;
 }
 
-bool ImageHandler::acquireImage(const FilePath& filePath, ImageDesc& imageDesc, bool /*generateMipMaps*/, const Color4* /*fallbackColor*/)
+bool ImageHandler::acquireImage(const FilePath& filePath, ImageDesc& imageDesc, bool generateMipMaps, const Color4* /*fallbackColor*/)
 {
     if (filePath.isEmpty())
     {
         return false;
     }
 
+    // Wait for the image if it is being loaded by a prefetch thread.
+    std::shared_future<bool> pendingImage;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        auto it = _pendingImages.find(filePath);
+        if (it != _pendingImages.end())
+        {
+            pendingImage = it->second;
+            _pendingImages.erase(it);
+        }
+    }
+    if (pendingImage.valid())
+    {
+        pendingImage.wait();
+    }
+
+    if (_bufferCache && _bufferCache->getImage(filePath, imageDesc, generateMipMaps))
+    {
+        return true;
+    }
+
+    if (loadImage(filePath, imageDesc, getRestrictions()))
+    {
+        if (generateMipMaps)
+        {
+            imageDesc.generateMipMaps();
+        }
+        if (_bufferCache)
+        {
+            _bufferCache->addImage(filePath, imageDesc);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool ImageHandler::loadImage(const FilePath& filePath, ImageDesc& imageDesc,
+                             const ImageDescRestrictions* restrictions)
+{
     string extension = filePath.getExtension();
     ImageLoaderMap::reverse_iterator iter;
     for (iter = _imageLoaders.rbegin(); iter != _imageLoaders.rend(); ++iter)
@@ -116,7 +690,7 @@ bool ImageHandler::acquireImage(const FilePath& filePath, ImageDesc& imageDesc,
         ImageLoaderPtr loader = iter->second;
         if (loader && loader->supportedExtensions().count(extension))
         {
-            bool acquired = loader->loadImage(filePath, imageDesc, getRestrictions());
+            bool acquired = loader->loadImage(filePath, imageDesc, restrictions);
             if (acquired)
             {
                 return true;
@@ -126,6 +700,162 @@ bool ImageHandler::acquireImage(const FilePath& filePath, ImageDesc& imageDesc,
     return false;
 }
 
+vector<std::shared_future<bool>> ImageHandler::prefetchImages(const FilePathVec& filePaths, unsigned int numThreads)
+{
+    if (!_bufferCache)
+    {
+        _bufferCache = ImageBufferCache::create();
+    }
+
+    // Shared state of the workers. Restrictions are copied, since they may
+    // be owned by a derived handler which is destroyed before the threads
+    // are joined.
+    struct PrefetchState
+    {
+        vector<std::pair<FilePath, std::promise<bool>>> images;
+        std::atomic<size_t> next;
+        ImageDescRestrictions restrictions;
+        bool hasRestrictions;
+    };
+    auto state = std::make_shared<PrefetchState>();
+    state->next = 0;
+    state->hasRestrictions = getRestrictions() != nullptr;
+    if (state->hasRestrictions)
+    {
+        state->restrictions = *getRestrictions();
+    }
+
+    vector<std::shared_future<bool>> futures;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        for (const FilePath& filePath : filePaths)
+        {
+            auto it = _pendingImages.find(filePath);
+            if (it != _pendingImages.end())
+            {
+                futures.push_back(it->second);
+                continue;
+            }
+            std::promise<bool> promise;
+            std::shared_future<bool> future = promise.get_future().share();
+            if (!filePath.isEmpty() && (_bufferCache->hasImage(filePath) || getCachedImage(filePath)))
+            {
+                promise.set_value(true);
+                futures.push_back(future);
+                continue;
+            }
+            if (_failedImages.count(filePath))
+            {
+                promise.set_value(false);
+                futures.push_back(future);
+                continue;
+            }
+            futures.push_back(future);
+            _pendingImages[filePath] = future;
+            state->images.emplace_back(filePath, std::move(promise));
+        }
+    }
+    if (state->images.empty())
+    {
+        return futures;
+    }
+
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, static_cast<unsigned int>(state->images.size()));
+
+    // Join the threads of earlier prefetches which have finished.
+    vector<std::thread> finishedThreads;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        for (auto it = _prefetchThreads.begin(); it != _prefetchThreads.end(); )
+        {
+            if (*it->second)
+            {
+                finishedThreads.push_back(std::move(it->first));
+                it = _prefetchThreads.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    for (std::thread& thread : finishedThreads)
+    {
+        thread.join();
+    }
+
+    ImageBufferCachePtr cache = _bufferCache;
+    auto worker = [this, state, cache](std::shared_ptr<std::atomic<bool>> finished)
+    {
+        const ImageDescRestrictions* restrictions = state->hasRestrictions ? &state->restrictions : nullptr;
+        for (size_t i = state->next++; i < state->images.size(); i = state->next++)
+        {
+            const FilePath& filePath = state->images[i].first;
+            ImageDesc imageDesc;
+            bool loaded = false;
+            try
+            {
+                loaded = !filePath.isEmpty() && loadImage(filePath, imageDesc, restrictions);
+            }
+            catch (std::exception&)
+            {
+                loaded = false;
+            }
+            if (loaded)
+            {
+                cache->addImage(filePath, imageDesc);
+                imageDesc.freeResourceBuffer();
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(_prefetchMutex);
+                _failedImages.insert(filePath);
+            }
+            state->images[i].second.set_value(loaded);
+        }
+        *finished = true;
+    };
+
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        _prefetchThreads.emplace_back(std::thread(worker, finished), finished);
+    }
+    return futures;
+}
+
+void ImageHandler::waitForPrefetch()
+{
+    vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> threads;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        threads.swap(_prefetchThreads);
+    }
+    for (auto& thread : threads)
+    {
+        thread.first.join();
+    }
+
+    // Images of completed loads are now in the buffer cache.
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    for (auto it = _pendingImages.begin(); it != _pendingImages.end(); )
+    {
+        if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            it = _pendingImages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 bool ImageHandler::createColorImage(const Color4& color,
                                     ImageDesc& desc)
 {
@@ -201,6 +931,9 @@ void ImageHandler::clearImageCache()
         deleteImage(iter.second);
     }
     _imageCache.clear();
+
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    _failedImages.clear();
 }
 
 } // namespace MaterialX
@@ -12,8 +12,14 @@
 #include <MaterialXCore/Types.h>
 
 #include <cmath>
+#include <future>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <array>
+#include <atomic>
+#include <thread>
 
 #include <MaterialXFormat/File.h>
 
@@ -72,13 +78,62 @@ class ImageDesc
         free(buffer);
     };
 
+    /// Filter options for generating mip map levels.
+    enum class MipFilter : int
+    {
+        /// Average of each 2x2 block of pixels
+        BOX = 0,
+        /// Kaiser windowed sinc filter over 6x6 pixels, which keeps
+        /// more detail in the lower levels than the box filter
+        KAISER = 1
+    };
+
+    /// CPU buffers of the mip map levels below the top level, starting with
+    /// level 1, in the base type and channel count of the image. Empty unless
+    /// generated by generateMipMaps().
+    vector<std::shared_ptr<void>> mipBuffers;
+
     /// Compute the number of mip map levels based on size of the image
     void computeMipCount()
     {
         mipCount = (unsigned int)std::log2(std::max(width, height)) + 1;
     }
 
-    /// Free any resource buffer memory
+    /// Generate the CPU buffers of all mip map levels from the resource buffer.
+    /// Each level is filtered from the level above it, with pixels clamped at the
+    /// edges, and levels of odd size drop their last row or column when using
+    /// the box filter.
+    /// @param filter Filter used to downsample each level.
+    /// @param numThreads Maximum number of threads used to filter large levels.
+    ///    By default the number of hardware threads is used.
+    /// @return True if the levels were generated. Returns false if there is
+    ///    no resource buffer, or the base type is not supported.
+    bool generateMipMaps(MipFilter filter = MipFilter::BOX, unsigned int numThreads = 0);
+
+    /// Return the width of the given mip map level.
+    unsigned int getMipWidth(unsigned int level) const
+    {
+        return std::max(width >> level, 1u);
+    }
+
+    /// Return the height of the given mip map level.
+    unsigned int getMipHeight(unsigned int level) const
+    {
+        return std::max(height >> level, 1u);
+    }
+
+    /// Return the CPU buffer of the given mip map level, where level 0 is the
+    /// resource buffer, or nullptr if the level has not been generated.
+    void* getMipBuffer(unsigned int level) const
+    {
+        if (level == 0)
+        {
+            return resourceBuffer;
+        }
+        return level <= mipBuffers.size() ? mipBuffers[level - 1].get() : nullptr;
+    }
+
+    /// Free any resource buffer memory, including the buffers of mip map levels
     void freeResourceBuffer();
 };
 
@@ -88,6 +143,14 @@ class ImageDescRestrictions
   public:
     /// List of base types that can be supported
     ImageDesc::BaseTypeSet supportedBaseTypes;
+
+    /// Number of channels to load images with. Zero, the default,
+    /// keeps the number of channels stored in the file.
+    unsigned int channelCount = 0;
+
+    /// Base type to load floating point images with, if supported.
+    /// Setting this to BASETYPE_HALF halves the memory used by HDR images.
+    ImageDesc::BaseType floatBaseType = ImageDesc::BASETYPE_FLOAT;
 };
 
 /// @class ImageSamplingProperties
@@ -137,6 +200,130 @@ class ImageSamplingProperties
 /// Image description cache
 using ImageDescCache = std::unordered_map<string, ImageDesc>;
 
+/// Shared pointer to an ImageBufferCache
+using ImageBufferCachePtr = std::shared_ptr<class ImageBufferCache>;
+
+/// @class ImageBufferCache
+/// A cache of CPU image buffers with a memory budget.
+///
+/// Images are keyed by file path. When the total size of the cached buffers
+/// exceeds the budget, the least recently used images which are not pinned
+/// are evicted. Buffers are shared between the cache and the image
+/// descriptions returned from it, so an evicted buffer is freed once the last
+/// description referencing it frees its resource buffer. Buffers returned from
+/// the cache are shared, and must not be modified.
+///
+class ImageBufferCache
+{
+  public:
+    /// Cache statistics
+    struct Statistics
+    {
+        /// Number of lookups finding an image in the cache
+        size_t hits = 0;
+        /// Number of lookups not finding an image in the cache
+        size_t misses = 0;
+        /// Number of images evicted to stay within the budget
+        size_t evictions = 0;
+    };
+
+    /// Default memory budget in bytes
+    static const size_t DEFAULT_BUDGET;
+
+    /// Constructor
+    ImageBufferCache(size_t budget = DEFAULT_BUDGET);
+
+    /// Static instance create function
+    static ImageBufferCachePtr create(size_t budget = DEFAULT_BUDGET)
+    {
+        return std::make_shared<ImageBufferCache>(budget);
+    }
+
+    /// Set the memory budget in bytes, evicting images if needed.
+    void setBudget(size_t budget);
+
+    /// Return the memory budget in bytes.
+    size_t getBudget() const;
+
+    /// Return the total size in bytes of the cached buffers.
+    size_t getSize() const;
+
+    /// Return the number of cached images.
+    size_t numImages() const;
+
+    /// Add an image to the cache, taking shared ownership of its resource
+    /// buffer. The given description keeps a reference to the buffer.
+    /// An image already cached with the same path is replaced.
+    void addImage(const string& filePath, ImageDesc& imageDesc);
+
+    /// Look up an image in the cache and mark it as most recently used.
+    /// @param filePath File path of the image.
+    /// @param imageDesc On success, filled out with a reference to the cached buffer.
+    /// @param generateMipMaps If true, and the cached image has no mip map
+    ///    levels, generate them once and store them with the image, counting
+    ///    their size against the budget.
+    /// @return True if the image was found.
+    bool getImage(const string& filePath, ImageDesc& imageDesc, bool generateMipMaps = false);
+
+    /// Return true if an image with the given path is cached.
+    bool hasImage(const string& filePath) const;
+
+    /// Remove an image from the cache.
+    void removeImage(const string& filePath);
+
+    /// Pin or unpin a cached image. Pinned images are never evicted,
+    /// and may keep the cache above its budget.
+    void setPinned(const string& filePath, bool pinned);
+
+    /// Return true if a cached image is pinned.
+    bool isPinned(const string& filePath) const;
+
+    /// Remove all images from the cache.
+    void clear();
+
+    /// Return the cache statistics.
+    Statistics getStatistics() const;
+
+    /// Reset the cache statistics.
+    void resetStatistics();
+
+    /// Return the size in bytes of the resource buffer for the given image
+    /// description, excluding the buffers of mip map levels.
+    static size_t getBufferSize(const ImageDesc& imageDesc);
+
+    /// Return the total size in bytes of the buffers of the mip map levels
+    /// of the given image description.
+    static size_t getMipBuffersSize(const ImageDesc& imageDesc);
+
+  protected:
+    struct Entry
+    {
+        ImageDesc desc;
+        std::shared_ptr<void> buffer;
+        size_t size = 0;
+        bool pinned = false;
+        std::list<string>::iterator order;
+    };
+
+    /// Evict least recently used images until the cache is within budget.
+    /// Must be called with the mutex locked.
+    void evict();
+
+    /// Remove an image. Must be called with the mutex locked.
+    void removeImageLocked(const string& filePath);
+
+    /// Assign a reference to the buffer of a cache entry to an image description.
+    static void assignBuffer(const Entry& entry, ImageDesc& imageDesc);
+
+    size_t _budget;
+    size_t _size;
+    Statistics _statistics;
+    std::unordered_map<string, Entry> _entries;
+    /// Cached paths, ordered from most to least recently used
+    std::list<string> _order;
+    mutable std::mutex _mutex;
+};
+
 /// Shared pointer to an ImageLoader
 using ImageLoaderPtr = std::shared_ptr<class ImageLoader>;
 
@@ -230,6 +417,7 @@ class ImageHandler
     /// Default destructor
     virtual ~ImageHandler()
     {
+        waitForPrefetch();
         clearImageCache();
     };
 
@@ -248,6 +436,8 @@ class ImageHandler
 
     /// Acquire an image from the cache or file system.  If the image is not
     /// found in the cache, then each image loader will be applied in turn.
+    /// If a buffer cache is set, the resource buffer may be shared with the
+    /// cache, and must not be modified.
     /// @param filePath File path of the image.
     /// @param imageDesc On success, this image descriptor will be filled out
     ///    and assigned ownership of a resource buffer.
@@ -263,6 +453,25 @@ class ImageHandler
                               bool generateMipMaps,
                               const Color4* fallbackColor = nullptr);
 
+    /// Start loading the given images on a pool of worker threads, using the
+    /// registered image loaders. Loaded images are added to the buffer cache,
+    /// which is created with the default budget if none is set, and are then
+    /// returned by acquireImage() without decoding on the calling thread.
+    /// If acquireImage() is called for an image which is still loading, it
+    /// waits for the load to complete. Images already in the buffer cache or
+    /// the image cache of the handler are not loaded again, nor are images
+    /// which failed to load, until the image cache is cleared. No threads
+    /// are started if there are no images to load.
+    /// @param filePaths File paths of the images to load.
+    /// @param numThreads Number of worker threads. By default the number of
+    ///    hardware threads is used.
+    /// @return A future for each file path, which is set to true once the image
+    ///    has been loaded, or to false if it could not be loaded.
+    vector<std::shared_future<bool>> prefetchImages(const FilePathVec& filePaths, unsigned int numThreads = 0);
+
+    /// Wait for all images started by prefetchImages() to finish loading.
+    void waitForPrefetch();
+
     /// Utility to create a solid color color image
     /// @param color Color to set
     /// @param imageDesc Description of image updated during load.
@@ -297,6 +506,20 @@ class ImageHandler
     /// Resolve a path to a file using the registered search paths.
     FilePath findFile(const FilePath& filePath);
 
+    /// Set a cache for the CPU buffers of images loaded by acquireImage().
+    /// By default no buffer cache is used, and each call to acquireImage()
+    /// loads the image from the file system.
+    void setBufferCache(ImageBufferCachePtr cache)
+    {
+        _bufferCache = cache;
+    }
+
+    /// Return the image buffer cache, if any.
+    ImageBufferCachePtr getBufferCache() const
+    {
+        return _bufferCache;
+    }
+
     /// Returns the bound texture location for a given resource
     virtual int getBoundTextureLocation(unsigned int)
     {
@@ -331,6 +554,11 @@ class ImageHandler
     /// an image is deleted from the handler.
     virtual void deleteImage(ImageDesc& imageDesc);
 
+    /// Load an image using the first registered image loader which
+    /// supports the file extension and succeeds.
+    bool loadImage(const FilePath& filePath, ImageDesc& imageDesc,
+                   const ImageDescRestrictions* restrictions);
+
     /// Return image description restrictions. By default nullptr is
     /// returned meaning no restrictions. Derived classes can override
     /// this to add restrictions specific to that handler.
@@ -343,6 +571,18 @@ class ImageHandler
 
     /// Filename search path
     FileSearchPath _searchPath;
+
+    /// Image buffer cache
+    ImageBufferCachePtr _bufferCache;
+
+    /// Images being loaded by prefetch threads
+    std::unordered_map<string, std::shared_future<bool>> _pendingImages;
+    /// Images which prefetch threads failed to load
+    StringSet _failedImages;
+    /// Prefetch worker threads, each with a flag set once it has finished
+    vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> _prefetchThreads;
+    /// Mutex for the prefetch state
+    std::mutex _prefetchMutex;
 };
 
 } // namespace MaterialX
@@ -5,7 +5,16 @@
 
 #include <MaterialXRender/Mesh.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <map>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MATERIALX_USE_SSE2
+#endif
 
 namespace MaterialX
 {
@@ -19,6 +28,294 @@ const string MeshStream::GEOMETRY_PROPERTY_ATTRIBUTE("geomprop");
 
 const float MAX_FLOAT = std::numeric_limits<float>::max();
 
+namespace
+{
+    // Minimum number of faces or vertices processed by each thread.
+    const size_t MIN_PARALLEL_ELEMENTS = 1 << 16;
+
+    // Call the function for ranges of elements, on up to the given number of threads.
+    void parallelRanges(size_t count, unsigned int numThreads, const std::function<void(size_t, size_t)>& function)
+    {
+        const size_t rangeCount = std::max(std::min(size_t(numThreads), count / MIN_PARALLEL_ELEMENTS), size_t(1));
+        const size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+        vector<std::thread> threads;
+        for (size_t begin = rangeSize; begin < count; begin += rangeSize)
+        {
+            threads.emplace_back(function, begin, std::min(begin + rangeSize, count));
+        }
+        function(0, std::min(rangeSize, count));
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Compute the unnormalized tangent direction of a range of faces.
+    // Based on Eric Lengyel at http://www.terathon.com/code/tangent.html
+    void computeFaceTangents(const unsigned int* indices, size_t begin, size_t end,
+                             const float* positions, unsigned int positionStride,
+                             const float* texcoords, unsigned int texcoordStride,
+                             Vector3* faceTangents)
+    {
+        const size_t FACE_VERTEX_COUNT = MeshStream::STRIDE_3D;
+        size_t f = begin;
+#ifdef MATERIALX_USE_SSE2
+        // Process four faces at a time, using the same operations as the
+        // scalar code so that the results are identical.
+        const size_t SIMD_WIDTH = 4;
+        for (; f + SIMD_WIDTH <= end; f += SIMD_WIDTH)
+        {
+            float v[FACE_VERTEX_COUNT][3][SIMD_WIDTH];
+            float w[FACE_VERTEX_COUNT][2][SIMD_WIDTH];
+            for (size_t lane = 0; lane < SIMD_WIDTH; lane++)
+            {
+                for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+                {
+                    const size_t index = indices[(f + lane) * FACE_VERTEX_COUNT + k];
+                    const float* position = positions + index * positionStride;
+                    const float* texcoord = texcoords + index * texcoordStride;
+                    v[k][0][lane] = position[0];
+                    v[k][1][lane] = position[1];
+                    v[k][2][lane] = position[2];
+                    w[k][0][lane] = texcoord[0];
+                    w[k][1][lane] = texcoord[1];
+                }
+            }
+
+            __m128 edge1[3], edge2[3];
+            for (size_t c = 0; c < 3; c++)
+            {
+                const __m128 v1 = _mm_loadu_ps(v[0][c]);
+                edge1[c] = _mm_sub_ps(_mm_loadu_ps(v[1][c]), v1);
+                edge2[c] = _mm_sub_ps(_mm_loadu_ps(v[2][c]), v1);
+            }
+            const __m128 w1s = _mm_loadu_ps(w[0][0]);
+            const __m128 w1t = _mm_loadu_ps(w[0][1]);
+            const __m128 s1 = _mm_sub_ps(_mm_loadu_ps(w[1][0]), w1s);
+            const __m128 s2 = _mm_sub_ps(_mm_loadu_ps(w[2][0]), w1s);
+            const __m128 t1 = _mm_sub_ps(_mm_loadu_ps(w[1][1]), w1t);
+            const __m128 t2 = _mm_sub_ps(_mm_loadu_ps(w[2][1]), w1t);
+
+            const __m128 denom = _mm_sub_ps(_mm_mul_ps(s1, t2), _mm_mul_ps(s2, t1));
+            const __m128 nonZero = _mm_cmpneq_ps(denom, _mm_setzero_ps());
+            const __m128 r = _mm_and_ps(nonZero, _mm_div_ps(_mm_set1_ps(1.0f), denom));
+
+            float dir[3][SIMD_WIDTH];
+            for (size_t c = 0; c < 3; c++)
+            {
+                const __m128 d = _mm_sub_ps(_mm_mul_ps(t2, edge1[c]), _mm_mul_ps(t1, edge2[c]));
+                _mm_storeu_ps(dir[c], _mm_mul_ps(d, r));
+            }
+            for (size_t lane = 0; lane < SIMD_WIDTH; lane++)
+            {
+                faceTangents[f + lane] = Vector3(dir[0][lane], dir[1][lane], dir[2][lane]);
+            }
+        }
+#endif
+        for (; f < end; f++)
+        {
+            const size_t i1 = indices[f * FACE_VERTEX_COUNT + 0];
+            const size_t i2 = indices[f * FACE_VERTEX_COUNT + 1];
+            const size_t i3 = indices[f * FACE_VERTEX_COUNT + 2];
+
+            const float* v1 = positions + i1 * positionStride;
+            const float* v2 = positions + i2 * positionStride;
+            const float* v3 = positions + i3 * positionStride;
+
+            const float* w1 = texcoords + i1 * texcoordStride;
+            const float* w2 = texcoords + i2 * texcoordStride;
+            const float* w3 = texcoords + i3 * texcoordStride;
+
+            float x1 = v2[0] - v1[0];
+            float x2 = v3[0] - v1[0];
+            float y1 = v2[1] - v1[1];
+            float y2 = v3[1] - v1[1];
+            float z1 = v2[2] - v1[2];
+            float z2 = v3[2] - v1[2];
+
+            float s1 = w2[0] - w1[0];
+            float s2 = w3[0] - w1[0];
+            float t1 = w2[1] - w1[1];
+            float t2 = w3[1] - w1[1];
+
+            float denom = s1 * t2 - s2 * t1;
+            float r = denom ? 1.0f / denom : 0.0f;
+            faceTangents[f] = Vector3((t2 * x1 - t1 * x2) * r,
+                                      (t2 * y1 - t1 * y2) * r,
+                                      (t2 * z1 - t1 * z2) * r);
+        }
+    }
+
+    // A first-in first-out post-transform vertex cache, which records the
+    // time at which each vertex was added.
+    class VertexCache
+    {
+      public:
+        VertexCache(size_t vertexCount, unsigned int cacheSize) :
+            _stamps(vertexCount, 0),
+            _time(size_t(cacheSize) + 1),
+            _cacheSize(cacheSize)
+        {
+        }
+
+        // Return the number of insertions since the vertex was added, which
+        // is larger than the cache size if the vertex is not in the cache.
+        size_t getAge(unsigned int vertex) const
+        {
+            return _time - _stamps[vertex];
+        }
+
+        // Add a vertex if it is not in the cache, returning true on a miss.
+        bool add(unsigned int vertex)
+        {
+            if (getAge(vertex) > _cacheSize)
+            {
+                _stamps[vertex] = _time++;
+                return true;
+            }
+            return false;
+        }
+
+        // Remove all vertices from the cache.
+        void flush()
+        {
+            _time += _cacheSize + 1;
+        }
+
+      private:
+        vector<size_t> _stamps;
+        size_t _time;
+        size_t _cacheSize;
+    };
+
+    const size_t FACE_VERTEX_COUNT = MeshStream::STRIDE_3D;
+
+    size_t getIndexedVertexCount(const MeshIndexBuffer& indices, size_t indexCount)
+    {
+        unsigned int maxIndex = 0;
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            maxIndex = std::max(maxIndex, indices[i]);
+        }
+        return indexCount ? size_t(maxIndex) + 1 : 0;
+    }
+
+    // Reorder the faces of a partition with the Tipsify algorithm. Faces are
+    // emitted by fanning around a vertex, and the next vertex to fan around
+    // is the most recently used vertex which is expected to remain in the
+    // cache while its remaining faces are emitted.
+    void tipsify(MeshIndexBuffer& indices, size_t faceCount, unsigned int cacheSize)
+    {
+        const size_t indexCount = faceCount * FACE_VERTEX_COUNT;
+        const size_t vertexCount = getIndexedVertexCount(indices, indexCount);
+
+        // Build the faces adjacent to each vertex.
+        vector<size_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            offsets[indices[i] + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+        vector<size_t> liveFaces(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            liveFaces[v] = offsets[v + 1] - offsets[v];
+        }
+        vector<size_t> adjacency(indexCount);
+        vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            adjacency[fill[indices[i]]++] = i / FACE_VERTEX_COUNT;
+        }
+
+        VertexCache cache(vertexCount, cacheSize);
+        vector<bool> emitted(faceCount, false);
+        vector<unsigned int> deadEnds;
+        vector<unsigned int> candidates;
+        MeshIndexBuffer output;
+        output.reserve(indices.size());
+        size_t cursor = 0;
+
+        // Return a vertex with remaining faces, preferring recently used vertices.
+        auto skipDeadEnd = [&]() -> int64_t
+        {
+            while (!deadEnds.empty())
+            {
+                const unsigned int vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveFaces[vertex] > 0)
+                {
+                    return vertex;
+                }
+            }
+            for (; cursor < vertexCount; cursor++)
+            {
+                if (liveFaces[cursor] > 0)
+                {
+                    return int64_t(cursor);
+                }
+            }
+            return -1;
+        };
+
+        int64_t fanVertex = skipDeadEnd();
+        while (fanVertex >= 0)
+        {
+            candidates.clear();
+            for (size_t a = offsets[size_t(fanVertex)]; a < offsets[size_t(fanVertex) + 1]; a++)
+            {
+                const size_t face = adjacency[a];
+                if (emitted[face])
+                {
+                    continue;
+                }
+                emitted[face] = true;
+                for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+                {
+                    const unsigned int vertex = indices[face * FACE_VERTEX_COUNT + k];
+                    output.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveFaces[vertex]--;
+                    cache.add(vertex);
+                }
+            }
+
+            // Choose the candidate which entered the cache earliest, among
+            // those which would remain in the cache while fanning around them.
+            fanVertex = -1;
+            size_t bestPriority = 0;
+            for (unsigned int vertex : candidates)
+            {
+                if (liveFaces[vertex] == 0)
+                {
+                    continue;
+                }
+                size_t priority = 0;
+                if (cache.getAge(vertex) + 2 * liveFaces[vertex] <= cacheSize)
+                {
+                    priority = cache.getAge(vertex);
+                }
+                if (fanVertex < 0 || priority > bestPriority)
+                {
+                    fanVertex = vertex;
+                    bestPriority = priority;
+                }
+            }
+            if (fanVertex < 0)
+            {
+                fanVertex = skipDeadEnd();
+            }
+        }
+
+        output.insert(output.end(), indices.begin() + indexCount, indices.end());
+        indices.swap(output);
+    }
+}
+
 Mesh::Mesh(const string& identifier) :
     _identifier(identifier),
     _minimumBounds(MAX_FLOAT, MAX_FLOAT, MAX_FLOAT),
@@ -30,7 +327,7 @@ Mesh::Mesh(const string& identifier) :
 }
 
 bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoordStream, MeshStreamPtr normalStream,
-                            MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream)
+                            MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream, unsigned int numThreads)
 {
     MeshFloatBuffer& positions = positionStream->getData();
     unsigned int positionStride = positionStream->getStride();
@@ -48,6 +345,11 @@ bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoord
         return false;
     }
 
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
     // Prepare tangent stream data
     MeshFloatBuffer& tangents = tangentStream->getData();
     tangents.resize(positions.size());
@@ -55,53 +357,72 @@ bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoord
     const unsigned int tangentStride = MeshStream::STRIDE_3D;
     tangentStream->setStride(tangentStride);
 
+    // Compute the tangent direction of each face in parallel.
+    vector<size_t> faceOffsets(getPartitionCount() + 1, 0);
     for (size_t i = 0; i < getPartitionCount(); i++)
     {
-        auto part = getPartition(i);
-
-        // Based on Eric Lengyel at http://www.terathon.com/code/tangent.html
-
-        const MeshIndexBuffer& indicies = part->getIndices();
-        for (size_t faceIndex = 0; faceIndex < part->getFaceCount(); faceIndex++)
+        faceOffsets[i + 1] = faceOffsets[i] + getPartition(i)->getFaceCount();
+    }
+    vector<Vector3> faceTangents(faceOffsets.back());
+    for (size_t i = 0; i < getPartitionCount(); i++)
+    {
+        const unsigned int* indices = getPartition(i)->getIndices().data();
+        Vector3* partitionTangents = faceTangents.data() + faceOffsets[i];
+        parallelRanges(getPartition(i)->getFaceCount(), numThreads, [&](size_t begin, size_t end)
         {
-            int i1 = indicies[faceIndex * MeshStream::STRIDE_3D + 0];
-            int i2 = indicies[faceIndex * MeshStream::STRIDE_3D + 1];
-            int i3 = indicies[faceIndex * MeshStream::STRIDE_3D + 2];
-
-            Vector3& v1 = *reinterpret_cast<Vector3*>(&(positions[i1 * positionStride]));
-            Vector3& v2 = *reinterpret_cast<Vector3*>(&(positions[i2 * positionStride]));
-            Vector3& v3 = *reinterpret_cast<Vector3*>(&(positions[i3 * positionStride]));
-
-            Vector2& w1 = *reinterpret_cast<Vector2*>(&(texcoords[i1 * texcoordStride]));
-            Vector2& w2 = *reinterpret_cast<Vector2*>(&(texcoords[i2 * texcoordStride]));
-            Vector2& w3 = *reinterpret_cast<Vector2*>(&(texcoords[i3 * texcoordStride]));
-
-            float x1 = v2[0] - v1[0];
-            float x2 = v3[0] - v1[0];
-            float y1 = v2[1] - v1[1];
-            float y2 = v3[1] - v1[1];
-            float z1 = v2[2] - v1[2];
-            float z2 = v3[2] - v1[2];
-
-            float s1 = w2[0] - w1[0];
-            float s2 = w3[0] - w1[0];
-            float t1 = w2[1] - w1[1];
-            float t2 = w3[1] - w1[1];
-
-            float denom = s1 * t2 - s2 * t1;
-            float r = denom ? 1.0f / denom : 0.0f;
-            Vector3 dir((t2 * x1 - t1 * x2) * r,
-                (t2 * y1 - t1 * y2) * r,
-                (t2 * z1 - t1 * z2) * r);
+            computeFaceTangents(indices, begin, end, positions.data(), positionStride,
+                                texcoords.data(), texcoordStride, partitionTangents);
+        });
+    }
 
-            Vector3& tan1 = *reinterpret_cast<Vector3*>(&(tangents[i1 * tangentStride]));
-            Vector3& tan2 = *reinterpret_cast<Vector3*>(&(tangents[i2 * tangentStride]));
-            Vector3& tan3 = *reinterpret_cast<Vector3*>(&(tangents[i3 * tangentStride]));
-            tan1 += dir;
-            tan2 += dir;
-            tan3 += dir;
+    // Build the faces adjacent to each vertex, in face order across all
+    // partitions.
+    vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < getPartitionCount(); i++)
+    {
+        const MeshIndexBuffer& indices = getPartition(i)->getIndices();
+        const size_t indexCount = getPartition(i)->getFaceCount() * MeshStream::STRIDE_3D;
+        for (size_t j = 0; j < indexCount; j++)
+        {
+            if (indices[j] < vertexCount)
+            {
+                offsets[indices[j] + 1]++;
+            }
         }
     }
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    vector<size_t> adjacency(offsets.back());
+    vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < getPartitionCount(); i++)
+    {
+        const MeshIndexBuffer& indices = getPartition(i)->getIndices();
+        const size_t indexCount = getPartition(i)->getFaceCount() * MeshStream::STRIDE_3D;
+        for (size_t j = 0; j < indexCount; j++)
+        {
+            if (indices[j] < vertexCount)
+            {
+                adjacency[fill[indices[j]]++] = faceOffsets[i] + j / MeshStream::STRIDE_3D;
+            }
+        }
+    }
+
+    // Accumulate the face tangents of each vertex in face order, so that the
+    // sums do not depend on the number of threads. Each thread owns a range
+    // of vertices.
+    parallelRanges(vertexCount, numThreads, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; v++)
+        {
+            Vector3& tangent = *reinterpret_cast<Vector3*>(&(tangents[v * tangentStride]));
+            for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+            {
+                tangent += faceTangents[adjacency[j]];
+            }
+        }
+    });
 
     // Prepare bitangent stream data
     MeshFloatBuffer* bitangents = nullptr;
@@ -114,28 +435,31 @@ bool Mesh::generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoord
         bitangentStride = bitangentStream->getStride();
     }
 
-    for (size_t v = 0; v < vertexCount; v++)
+    parallelRanges(vertexCount, numThreads, [&](size_t begin, size_t end)
     {
-        Vector3& n = *reinterpret_cast<Vector3*>(&(normals[v * normalStride]));
-        Vector3& t = *reinterpret_cast<Vector3*>(&(tangents[v * tangentStride]));
-        Vector3* b = bitangents ? reinterpret_cast<Vector3*>(&((*bitangents)[v * bitangentStride])) : nullptr;
-
-        // Gram-Schmidt orthogonalize
-        if (t != Vector3(0.0f))
-        {
-            t = (t - n * n.dot(t)).getNormalized();
-        }
-        else
+        for (size_t v = begin; v < end; v++)
         {
-            // Tangent vector is zero length so set a default direction
-            // to avoid sending invalid data to the renderer.
-            t = Vector3(0.0f, 0.0f, 1.0f);
-        }
-        if (b)
-        {
-            *b = n.cross(t);
+            Vector3& n = *reinterpret_cast<Vector3*>(&(normals[v * normalStride]));
+            Vector3& t = *reinterpret_cast<Vector3*>(&(tangents[v * tangentStride]));
+            Vector3* b = bitangents ? reinterpret_cast<Vector3*>(&((*bitangents)[v * bitangentStride])) : nullptr;
+
+            // Gram-Schmidt orthogonalize
+            if (t != Vector3(0.0f))
+            {
+                t = (t - n * n.dot(t)).getNormalized();
+            }
+            else
+            {
+                // Tangent vector is zero length so set a default direction
+                // to avoid sending invalid data to the renderer.
+                t = Vector3(0.0f, 0.0f, 1.0f);
+            }
+            if (b)
+            {
+                *b = n.cross(t);
+            }
         }
-    }
+    });
     return true;
 }
 
@@ -161,6 +485,211 @@ void Mesh::mergePartitions()
     addPartition(merged);
 }
 
+void Mesh::optimizeVertexCache(unsigned int cacheSize)
+{
+    for (MeshPartitionPtr part : _partitions)
+    {
+        tipsify(part->getIndices(), part->getFaceCount(), cacheSize);
+    }
+}
+
+void Mesh::optimizeOverdraw(float threshold, unsigned int cacheSize)
+{
+    MeshStreamPtr positionStream = getStream(MeshStream::POSITION_ATTRIBUTE, 0);
+    if (!positionStream)
+    {
+        return;
+    }
+    const MeshFloatBuffer& positions = positionStream->getData();
+    const unsigned int positionStride = positionStream->getStride();
+
+    for (MeshPartitionPtr part : _partitions)
+    {
+        MeshIndexBuffer& indices = part->getIndices();
+        const size_t faceCount = part->getFaceCount();
+        if (faceCount == 0)
+        {
+            continue;
+        }
+        VertexCache cache(getIndexedVertexCount(indices, faceCount * FACE_VERTEX_COUNT), cacheSize);
+        auto addFace = [&](size_t face)
+        {
+            size_t misses = 0;
+            for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+            {
+                misses += cache.add(indices[face * FACE_VERTEX_COUNT + k]) ? 1 : 0;
+            }
+            return misses;
+        };
+
+        // Split the faces at the points where the cache is flushed, when all
+        // vertices of a face are missed.
+        vector<size_t> hardBoundaries;
+        for (size_t face = 0; face < faceCount; face++)
+        {
+            if (addFace(face) == FACE_VERTEX_COUNT)
+            {
+                hardBoundaries.push_back(face);
+            }
+        }
+        hardBoundaries.push_back(faceCount);
+
+        // Split each of these clusters further, wherever the cache miss ratio
+        // of the faces since the last split is within the threshold of the
+        // ratio of the whole cluster.
+        vector<size_t> boundaries;
+        for (size_t c = 0; c + 1 < hardBoundaries.size(); c++)
+        {
+            const size_t begin = hardBoundaries[c];
+            const size_t end = hardBoundaries[c + 1];
+            cache.flush();
+            size_t clusterMisses = 0;
+            for (size_t face = begin; face < end; face++)
+            {
+                clusterMisses += addFace(face);
+            }
+            const float maxRatio = threshold * float(clusterMisses) / float(end - begin);
+
+            cache.flush();
+            boundaries.push_back(begin);
+            size_t start = begin;
+            size_t misses = 0;
+            for (size_t face = begin; face + 1 < end; face++)
+            {
+                misses += addFace(face);
+                if (float(misses) <= maxRatio * float(face + 1 - start))
+                {
+                    start = face + 1;
+                    boundaries.push_back(start);
+                    misses = 0;
+                    cache.flush();
+                }
+            }
+        }
+        boundaries.push_back(faceCount);
+
+        // Sort the clusters by how much they face away from the center of the
+        // partition, using area weighted centroids and normals.
+        struct Cluster
+        {
+            size_t begin;
+            size_t end;
+            Vector3 centroid;
+            Vector3 normal;
+            float area;
+            float sortKey;
+        };
+        vector<Cluster> clusters;
+        Vector3 center(0.0f);
+        float totalArea = 0.0f;
+        for (size_t c = 0; c + 1 < boundaries.size(); c++)
+        {
+            Cluster cluster = { boundaries[c], boundaries[c + 1], Vector3(0.0f), Vector3(0.0f), 0.0f, 0.0f };
+            for (size_t face = cluster.begin; face < cluster.end; face++)
+            {
+                Vector3 v[FACE_VERTEX_COUNT];
+                for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+                {
+                    const float* position = &positions[size_t(indices[face * FACE_VERTEX_COUNT + k]) * positionStride];
+                    v[k] = Vector3(position[0], position[1], position[2]);
+                }
+                const Vector3 normal = (v[1] - v[0]).cross(v[2] - v[0]);
+                const float area = normal.getMagnitude() * 0.5f;
+                cluster.centroid += (v[0] + v[1] + v[2]) * (area / 3.0f);
+                cluster.normal += normal;
+                cluster.area += area;
+            }
+            center += cluster.centroid;
+            totalArea += cluster.area;
+            clusters.push_back(cluster);
+        }
+        if (totalArea > 0.0f)
+        {
+            center = center / totalArea;
+        }
+        for (Cluster& cluster : clusters)
+        {
+            const float normalLength = cluster.normal.getMagnitude();
+            if (cluster.area > 0.0f && normalLength > 0.0f)
+            {
+                cluster.sortKey = (cluster.centroid / cluster.area - center).dot(cluster.normal / normalLength);
+            }
+        }
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b)
+        {
+            return a.sortKey > b.sortKey;
+        });
+
+        MeshIndexBuffer sorted;
+        sorted.reserve(indices.size());
+        for (const Cluster& cluster : clusters)
+        {
+            sorted.insert(sorted.end(), indices.begin() + cluster.begin * FACE_VERTEX_COUNT,
+                          indices.begin() + cluster.end * FACE_VERTEX_COUNT);
+        }
+        sorted.insert(sorted.end(), indices.begin() + faceCount * FACE_VERTEX_COUNT, indices.end());
+        indices.swap(sorted);
+    }
+}
+
+bool Mesh::optimizeVertexFetch()
+{
+    for (MeshStreamPtr stream : _streams)
+    {
+        if (stream->getData().size() != _vertexCount * stream->getStride())
+        {
+            return false;
+        }
+    }
+
+    // Number the vertices in order of first use.
+    const unsigned int UNUSED = std::numeric_limits<unsigned int>::max();
+    vector<unsigned int> remap(_vertexCount, UNUSED);
+    unsigned int nextVertex = 0;
+    for (MeshPartitionPtr part : _partitions)
+    {
+        for (unsigned int index : part->getIndices())
+        {
+            if (index >= _vertexCount)
+            {
+                return false;
+            }
+            if (remap[index] == UNUSED)
+            {
+                remap[index] = nextVertex++;
+            }
+        }
+    }
+    for (unsigned int& index : remap)
+    {
+        if (index == UNUSED)
+        {
+            index = nextVertex++;
+        }
+    }
+
+    for (MeshPartitionPtr part : _partitions)
+    {
+        for (unsigned int& index : part->getIndices())
+        {
+            index = remap[index];
+        }
+    }
+    for (MeshStreamPtr stream : _streams)
+    {
+        const MeshFloatBuffer& data = stream->getData();
+        const unsigned int stride = stream->getStride();
+        MeshFloatBuffer reordered(data.size());
+        for (size_t v = 0; v < _vertexCount; v++)
+        {
+            std::copy(data.begin() + v * stride, data.begin() + (v + 1) * stride,
+                      reordered.begin() + size_t(remap[v]) * stride);
+        }
+        stream->getData().swap(reordered);
+    }
+    return true;
+}
+
 void Mesh::splitByUdims()
 {
     MeshStreamPtr texcoords = getStream(MeshStream::TEXCOORD_ATTRIBUTE, 0);
@@ -206,6 +735,22 @@ void Mesh::splitByUdims()
     }
 }
 
+float MeshPartition::computeACMR(unsigned int cacheSize) const
+{
+    if (_faceCount == 0)
+    {
+        return 0.0f;
+    }
+    const size_t indexCount = _faceCount * FACE_VERTEX_COUNT;
+    VertexCache cache(getIndexedVertexCount(_indices, indexCount), cacheSize);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        misses += cache.add(_indices[i]) ? 1 : 0;
+    }
+    return float(misses) / float(_faceCount);
+}
+
 void MeshStream::transform(const Matrix44 &matrix)
 {
     unsigned int stride = getStride();
@@ -193,6 +193,16 @@ class MeshPartition
         _faceCount = val;
     }
 
+    /// Default size of the simulated post-transform vertex cache.
+    static const unsigned int DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+    /// Return the average cache miss ratio (ACMR) of the faces of the
+    /// partition, which is the number of vertices transformed per face,
+    /// simulating a first-in first-out post-transform vertex cache of
+    /// the given size. Values range from 0.5 for an ideal order of a
+    /// large regular mesh, to 3.0 when no vertices are reused.
+    float computeACMR(unsigned int cacheSize = DEFAULT_VERTEX_CACHE_SIZE) const;
+
   private:
     string _identifier;
     MeshIndexBuffer _indices;
@@ -285,6 +295,12 @@ class Mesh
         _streams.push_back(stream);
     }
 
+    /// Return all mesh streams
+    const MeshStreamList& getStreams() const
+    {
+        return _streams;
+    }
+
     /// Set vertex count
     void setVertexCount(size_t val)
     {
@@ -370,13 +386,41 @@ class Mesh
     /// @param normalStream Normals to use
     /// @param tangentStream Tangents to produce
     /// @param bitangentStream Bitangents to produce.
+    /// @param numThreads Maximum number of threads used for large meshes.
+    ///    By default the number of hardware threads is used. The results
+    ///    do not depend on the number of threads.
     /// Returns true if successful.
     bool generateTangents(MeshStreamPtr positionStream, MeshStreamPtr texcoordStream, MeshStreamPtr normalStream,
-                          MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream);
+                          MeshStreamPtr tangentStream, MeshStreamPtr bitangentStream, unsigned int numThreads = 0);
 
     /// Merge all mesh partitions into one.
     void mergePartitions();
 
+    /// Reorder the faces of each partition to improve the hit rate of the
+    /// post-transform vertex cache, using the Tipsify algorithm of Sander,
+    /// Nehab and Barczak, which runs in linear time.
+    /// @param cacheSize Size of the vertex cache to optimize for.
+    void optimizeVertexCache(unsigned int cacheSize = MeshPartition::DEFAULT_VERTEX_CACHE_SIZE);
+
+    /// Reorder clusters of faces within each partition to reduce overdraw,
+    /// drawing the clusters which face away from the center of the mesh,
+    /// and are therefore likely to occlude other clusters, first. Faces
+    /// should first be ordered with optimizeVertexCache, and are split into
+    /// clusters at the points where the vertex cache is flushed, or where
+    /// the cache miss ratio stays within the given threshold.
+    /// @param threshold Maximum ratio by which the cache miss ratio of each
+    ///    cluster may increase.
+    /// @param cacheSize Size of the vertex cache to optimize for.
+    void optimizeOverdraw(float threshold = 1.05f, unsigned int cacheSize = MeshPartition::DEFAULT_VERTEX_CACHE_SIZE);
+
+    /// Reorder the vertices of all streams in the order they are first
+    /// referenced by the partitions, to improve the locality of vertex
+    /// fetches, and update the indices to match. Vertices which are not
+    /// referenced are moved to the end.
+    /// @return False if a stream does not hold one element per vertex, in
+    ///    which case the mesh is unchanged.
+    bool optimizeVertexFetch();
+
     /// Split the mesh into a single partition per UDIM.
     void splitByUdims();
 
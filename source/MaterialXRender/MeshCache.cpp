@@ -0,0 +1,434 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/MeshCache.h>
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace MaterialX
+{
+
+const unsigned int MeshCache::VERSION = 1;
+const string MeshCache::EXTENSION = "mxmesh";
+
+namespace
+{
+    const char CACHE_MAGIC[8] = { 'M', 'X', 'M', 'E', 'S', 'H', '\0', '\0' };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const size_t BUFFER_ALIGNMENT = 16;
+    const size_t HASH_BLOCK_SIZE = 1 << 20;
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t sourceHash;
+        uint64_t meshCount;
+    };
+
+    bool getSourceInfo(const FilePath& path, uint64_t& size, int64_t& time)
+    {
+#if defined(_WIN32)
+        struct _stat64 info;
+        if (_stat64(path.asString().c_str(), &info) != 0)
+        {
+            return false;
+        }
+#else
+        struct stat info;
+        if (stat(path.asString().c_str(), &info) != 0)
+        {
+            return false;
+        }
+#endif
+        size = uint64_t(info.st_size);
+        time = int64_t(info.st_mtime);
+        return true;
+    }
+
+    // Hash the contents of a file with 64-bit FNV-1a, applied to 8 byte words.
+    bool hashFile(const FilePath& path, uint64_t& hash)
+    {
+        std::ifstream stream(path.asString(), std::ios::binary);
+        if (!stream)
+        {
+            return false;
+        }
+        hash = 14695981039346656037ull;
+        vector<char> block(HASH_BLOCK_SIZE);
+        while (stream)
+        {
+            stream.read(block.data(), std::streamsize(block.size()));
+            const size_t count = size_t(stream.gcount());
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= count; i += sizeof(uint64_t))
+            {
+                uint64_t word;
+                std::memcpy(&word, &block[i], sizeof(word));
+                hash = (hash ^ word) * 1099511628211ull;
+            }
+            for (; i < count; i++)
+            {
+                hash = (hash ^ uint8_t(block[i])) * 1099511628211ull;
+            }
+        }
+        return true;
+    }
+
+    uint64_t hashString(const string& value)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : value)
+        {
+            hash = (hash ^ uint8_t(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    class CacheWriter
+    {
+      public:
+        explicit CacheWriter(std::ostream& stream) :
+            _stream(stream),
+            _offset(0)
+        {
+        }
+
+        void write(const void* data, size_t size)
+        {
+            _stream.write(static_cast<const char*>(data), std::streamsize(size));
+            _offset += size;
+        }
+
+        template <class T> void writeValue(const T& value)
+        {
+            write(&value, sizeof(T));
+        }
+
+        void writeString(const string& value)
+        {
+            writeValue(uint64_t(value.size()));
+            write(value.data(), value.size());
+        }
+
+        void writeVector(const Vector3& value)
+        {
+            write(value.data(), sizeof(float) * 3);
+        }
+
+        // Buffers start at aligned offsets, so that the file can be mapped
+        // into memory and the buffers used in place.
+        template <class T> void writeBuffer(const vector<T>& buffer)
+        {
+            static const char padding[BUFFER_ALIGNMENT] = {};
+            writeValue(uint64_t(buffer.size()));
+            write(padding, (BUFFER_ALIGNMENT - _offset % BUFFER_ALIGNMENT) % BUFFER_ALIGNMENT);
+            write(buffer.data(), buffer.size() * sizeof(T));
+        }
+
+      private:
+        std::ostream& _stream;
+        size_t _offset;
+    };
+
+    class CacheReader
+    {
+      public:
+        CacheReader(std::istream& stream, size_t size) :
+            _stream(stream),
+            _offset(0),
+            _size(size)
+        {
+        }
+
+        bool read(void* data, size_t size)
+        {
+            if (size > _size - _offset)
+            {
+                return false;
+            }
+            _stream.read(static_cast<char*>(data), std::streamsize(size));
+            _offset += size;
+            return bool(_stream);
+        }
+
+        template <class T> bool readValue(T& value)
+        {
+            return read(&value, sizeof(T));
+        }
+
+        bool readString(string& value)
+        {
+            uint64_t size;
+            if (!readValue(size) || size > _size - _offset)
+            {
+                return false;
+            }
+            value.resize(size_t(size));
+            return read(&value[0], size_t(size));
+        }
+
+        bool readVector(Vector3& value)
+        {
+            return read(value.data(), sizeof(float) * 3);
+        }
+
+        template <class T> bool readBuffer(vector<T>& buffer)
+        {
+            uint64_t count;
+            if (!readValue(count))
+            {
+                return false;
+            }
+            const size_t padding = (BUFFER_ALIGNMENT - _offset % BUFFER_ALIGNMENT) % BUFFER_ALIGNMENT;
+            if (padding > _size - _offset || count > (_size - _offset - padding) / sizeof(T))
+            {
+                return false;
+            }
+            _stream.seekg(std::streamoff(padding), std::ios::cur);
+            _offset += padding;
+            buffer.resize(size_t(count));
+            return read(buffer.data(), buffer.size() * sizeof(T));
+        }
+
+      private:
+        std::istream& _stream;
+        size_t _offset;
+        size_t _size;
+    };
+
+    bool readMesh(CacheReader& reader, MeshPtr& mesh)
+    {
+        string identifier;
+        string sourceUri;
+        Vector3 minimumBounds, maximumBounds, sphereCenter;
+        float sphereRadius;
+        uint64_t vertexCount, streamCount, partitionCount;
+        if (!reader.readString(identifier) ||
+            !reader.readString(sourceUri) ||
+            !reader.readVector(minimumBounds) ||
+            !reader.readVector(maximumBounds) ||
+            !reader.readVector(sphereCenter) ||
+            !reader.readValue(sphereRadius) ||
+            !reader.readValue(vertexCount) ||
+            !reader.readValue(streamCount) ||
+            !reader.readValue(partitionCount))
+        {
+            return false;
+        }
+
+        mesh = Mesh::create(identifier);
+        mesh->setSourceUri(sourceUri);
+        mesh->setMinimumBounds(minimumBounds);
+        mesh->setMaximumBounds(maximumBounds);
+        mesh->setSphereCenter(sphereCenter);
+        mesh->setSphereRadius(sphereRadius);
+        mesh->setVertexCount(size_t(vertexCount));
+
+        for (uint64_t i = 0; i < streamCount; i++)
+        {
+            string name, type;
+            uint32_t index, stride;
+            if (!reader.readString(name) ||
+                !reader.readString(type) ||
+                !reader.readValue(index) ||
+                !reader.readValue(stride))
+            {
+                return false;
+            }
+            MeshStreamPtr stream = MeshStream::create(name, type, index);
+            stream->setStride(stride);
+            if (!reader.readBuffer(stream->getData()))
+            {
+                return false;
+            }
+            mesh->addStream(stream);
+        }
+
+        for (uint64_t i = 0; i < partitionCount; i++)
+        {
+            string identifier;
+            uint64_t faceCount;
+            if (!reader.readString(identifier) || !reader.readValue(faceCount))
+            {
+                return false;
+            }
+            MeshPartitionPtr partition = MeshPartition::create();
+            partition->setIdentifier(identifier);
+            partition->setFaceCount(size_t(faceCount));
+            if (!reader.readBuffer(partition->getIndices()))
+            {
+                return false;
+            }
+            mesh->addPartition(partition);
+        }
+        return true;
+    }
+
+    void writeMesh(CacheWriter& writer, const Mesh& mesh)
+    {
+        writer.writeString(mesh.getIdentifier());
+        writer.writeString(mesh.getSourceUri());
+        writer.writeVector(mesh.getMinimumBounds());
+        writer.writeVector(mesh.getMaximumBounds());
+        writer.writeVector(mesh.getSphereCenter());
+        writer.writeValue(mesh.getSphereRadius());
+        writer.writeValue(uint64_t(mesh.getVertexCount()));
+        writer.writeValue(uint64_t(mesh.getStreams().size()));
+        writer.writeValue(uint64_t(mesh.getPartitionCount()));
+
+        for (MeshStreamPtr stream : mesh.getStreams())
+        {
+            writer.writeString(stream->getName());
+            writer.writeString(stream->getType());
+            writer.writeValue(uint32_t(stream->getIndex()));
+            writer.writeValue(uint32_t(stream->getStride()));
+            writer.writeBuffer(stream->getData());
+        }
+
+        for (size_t i = 0; i < mesh.getPartitionCount(); i++)
+        {
+            MeshPartitionPtr partition = mesh.getPartition(i);
+            writer.writeString(partition->getIdentifier());
+            writer.writeValue(uint64_t(partition->getFaceCount()));
+            writer.writeBuffer(partition->getIndices());
+        }
+    }
+}
+
+//
+// MeshCache methods
+//
+
+MeshCache::MeshCache(const FilePath& directory) :
+    _directory(directory)
+{
+}
+
+FilePath MeshCache::getCachePath(const FilePath& sourcePath) const
+{
+    if (_directory.isEmpty())
+    {
+        return FilePath(sourcePath.asString() + "." + EXTENSION);
+    }
+
+    // Source files with the same name in different directories are
+    // distinguished by the hash of their absolute path.
+    const FilePath absolutePath = sourcePath.isAbsolute() ? sourcePath : FilePath::getCurrentPath() / sourcePath;
+    std::stringstream name;
+    name << sourcePath.getBaseName() << "." << std::hex << std::setw(16) << std::setfill('0')
+         << hashString(absolutePath.asString()) << "." << EXTENSION;
+    return _directory / FilePath(name.str());
+}
+
+bool MeshCache::readMeshes(const FilePath& sourcePath, MeshList& meshList)
+{
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    const FilePath cachePath = getCachePath(sourcePath);
+    std::ifstream stream(cachePath.asString(), std::ios::binary | std::ios::ate);
+    if (!stream || !getSourceInfo(sourcePath, sourceSize, sourceTime))
+    {
+        _statistics.misses++;
+        return false;
+    }
+    const size_t cacheSize = size_t(stream.tellg());
+    stream.seekg(0);
+
+    // Check the header, hashing the source file only if it was modified
+    // since the entry was written.
+    CacheReader reader(stream, cacheSize);
+    CacheHeader header;
+    uint64_t sourceHash;
+    if (!reader.readValue(header) ||
+        std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK ||
+        header.sourceSize != sourceSize ||
+        (header.sourceTime != sourceTime && (!hashFile(sourcePath, sourceHash) || header.sourceHash != sourceHash)))
+    {
+        _statistics.misses++;
+        return false;
+    }
+
+    MeshList cachedMeshes;
+    for (uint64_t i = 0; i < header.meshCount; i++)
+    {
+        MeshPtr mesh;
+        if (!readMesh(reader, mesh))
+        {
+            _statistics.misses++;
+            return false;
+        }
+        mesh->setSourceUri(sourcePath);
+        cachedMeshes.push_back(mesh);
+    }
+    meshList.insert(meshList.end(), cachedMeshes.begin(), cachedMeshes.end());
+    _statistics.hits++;
+    return true;
+}
+
+bool MeshCache::writeMeshes(const FilePath& sourcePath, const MeshList& meshList)
+{
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.meshCount = meshList.size();
+    if (!getSourceInfo(sourcePath, header.sourceSize, header.sourceTime) ||
+        !hashFile(sourcePath, header.sourceHash))
+    {
+        return false;
+    }
+
+    if (!_directory.isEmpty() && !_directory.exists())
+    {
+        FilePath directory = _directory;
+        directory.createDirectory();
+    }
+
+    // Write to a temporary file first, so that readers never see a
+    // partially written entry.
+    const FilePath cachePath = getCachePath(sourcePath);
+    const string tempPath = cachePath.asString() + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary);
+        if (!stream)
+        {
+            return false;
+        }
+        CacheWriter writer(stream);
+        writer.writeValue(header);
+        for (MeshPtr mesh : meshList)
+        {
+            writeMesh(writer, *mesh);
+        }
+        if (!stream)
+        {
+            stream.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(cachePath.asString().c_str());
+    if (std::rename(tempPath.c_str(), cachePath.asString().c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    _statistics.writes++;
+    return true;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,106 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_MESHCACHE_H
+#define MATERIALX_MESHCACHE_H
+
+/// @file
+/// Binary cache of loaded meshes
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXRender/Mesh.h>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a MeshCache
+using MeshCachePtr = std::shared_ptr<class MeshCache>;
+
+/// @class MeshCache
+/// A cache of meshes stored in a binary format, so that geometry files
+/// which have already been loaded are read back without parsing them or
+/// recomputing normals, tangents and partitions.
+///
+/// Each cache file stores the streams, partitions, bounds and bounding
+/// sphere of the meshes loaded from one source file. The buffers are stored
+/// in native byte order at 16 byte aligned offsets, and are read into the
+/// mesh buffers with a single read each. An entry is valid if the size and
+/// modification time of its source file are unchanged, or, if the source
+/// file was modified, the hash of its contents is unchanged.
+///
+/// The cache stores meshes as they were loaded, so cache files should be
+/// removed when the options of a geometry loader change.
+class MeshCache
+{
+  public:
+    /// Cache statistics
+    struct Statistics
+    {
+        /// Number of reads which found a valid entry
+        size_t hits = 0;
+        /// Number of reads which found no valid entry
+        size_t misses = 0;
+        /// Number of entries written
+        size_t writes = 0;
+    };
+
+    /// Version of the cache file format. Cache files with a different
+    /// version are ignored.
+    static const unsigned int VERSION;
+
+    /// Extension of cache files
+    static const string EXTENSION;
+
+    /// Constructor
+    /// @param directory Directory in which to store cache files. If empty,
+    ///    each cache file is stored next to its source file.
+    MeshCache(const FilePath& directory = FilePath());
+
+    /// Static instance create function
+    static MeshCachePtr create(const FilePath& directory = FilePath())
+    {
+        return std::make_shared<MeshCache>(directory);
+    }
+
+    /// Return the directory in which cache files are stored.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// Return the path of the cache file for the given source file.
+    FilePath getCachePath(const FilePath& sourcePath) const;
+
+    /// Read the meshes of a source file from the cache.
+    /// @param sourcePath Path to the source file.
+    /// @param meshList List of meshes to append the cached meshes to. Their
+    ///    source URI is set to the given source path.
+    /// @return True if the cache holds a valid entry for the file.
+    bool readMeshes(const FilePath& sourcePath, MeshList& meshList);
+
+    /// Write the meshes loaded from a source file to the cache.
+    /// @return True if the cache file was written.
+    bool writeMeshes(const FilePath& sourcePath, const MeshList& meshList);
+
+    /// Return the cache statistics.
+    const Statistics& getStatistics() const
+    {
+        return _statistics;
+    }
+
+    /// Reset the cache statistics.
+    void resetStatistics()
+    {
+        _statistics = Statistics();
+    }
+
+  protected:
+    FilePath _directory;
+    Statistics _statistics;
+};
+
+} // namespace MaterialX
+
+#endif
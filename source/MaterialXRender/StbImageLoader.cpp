@@ -25,6 +25,7 @@
 
 
 #include <MaterialXRender/StbImageLoader.h>
+#include <MaterialXRender/Util.h>
 
 namespace MaterialX
 {
@@ -57,7 +58,7 @@ bool StbImageLoader::saveImage(const FilePath& filePath,
     {
         if (extension == PNG_EXTENSION)
         {
-            returnValue = stbi_write_png(filePathName.c_str(), w, h, channels, data, w * 4);
+            returnValue = stbi_write_png(filePathName.c_str(), w, h, channels, data, w * channels);
         }
         else if (extension == BMP_EXTENSION)
         {
@@ -98,8 +99,12 @@ bool StbImageLoader::loadImage(const FilePath& filePath, ImageDesc &imageDesc,
     int ichannelCount = 0;
     void *buffer = nullptr;
 
-    // Set to 0 to mean to not override the read-in number of channels
-    const int REQUIRED_CHANNEL_COUNT = 0;
+    // Zero keeps the number of channels stored in the file
+    const int requiredChannelCount = restrictions ? static_cast<int>(restrictions->channelCount) : 0;
+    if (requiredChannelCount > 4)
+    {
+        return false;
+    }
 
     const string fileName = filePath.asString();
 
@@ -107,13 +112,48 @@ bool StbImageLoader::loadImage(const FilePath& filePath, ImageDesc &imageDesc,
     std::string extension = (fileName.substr(fileName.find_last_of(".") + 1));
     if (extension == HDR_EXTENSION)
     {
-        // Early out if base type is unsupported
-        if (restrictions && restrictions->supportedBaseTypes.count(ImageDesc::BASETYPE_FLOAT) == 0)
+        // Determine whether to store the image as half or float, and early
+        // out if neither base type is supported
+        bool useHalf = false;
+        if (restrictions)
         {
-            return false;
+            const bool supportsHalf = restrictions->supportedBaseTypes.count(ImageDesc::BASETYPE_HALF) != 0;
+            const bool supportsFloat = restrictions->supportedBaseTypes.count(ImageDesc::BASETYPE_FLOAT) != 0;
+            if (!supportsHalf && !supportsFloat)
+            {
+                return false;
+            }
+            useHalf = supportsHalf && (!supportsFloat || restrictions->floatBaseType == ImageDesc::BASETYPE_HALF);
         }
-        buffer = stbi_loadf(fileName.c_str(), &iwidth, &iheight, &ichannelCount, REQUIRED_CHANNEL_COUNT);
+        buffer = stbi_loadf(fileName.c_str(), &iwidth, &iheight, &ichannelCount, requiredChannelCount);
         imageDesc.baseType = ImageDesc::BASETYPE_FLOAT;
+
+        if (buffer && useHalf)
+        {
+            const int channelCount = requiredChannelCount ? requiredChannelCount : ichannelCount;
+            const size_t valueCount = size_t(iwidth) * size_t(iheight) * size_t(channelCount);
+            void* halfBuffer = malloc(valueCount * sizeof(uint16_t));
+            if (halfBuffer)
+            {
+                convertFloatToHalf(static_cast<float*>(buffer), static_cast<uint16_t*>(halfBuffer), valueCount);
+            }
+            stbi_image_free(buffer);
+            if (!halfBuffer)
+            {
+                return false;
+            }
+            imageDesc.resourceBuffer = halfBuffer;
+            imageDesc.width = iwidth;
+            imageDesc.height = iheight;
+            imageDesc.channelCount = channelCount;
+            imageDesc.baseType = ImageDesc::BASETYPE_HALF;
+            imageDesc.computeMipCount();
+            imageDesc.resourceBufferDeallocator = [](void* halfData)
+            {
+                free(halfData);
+            };
+            return true;
+        }
     }
     // Otherwise use fixed point reader
     else
@@ -123,7 +163,7 @@ bool StbImageLoader::loadImage(const FilePath& filePath, ImageDesc &imageDesc,
         {
             return false;
         }
-        buffer = stbi_load(fileName.c_str(), &iwidth, &iheight, &ichannelCount, REQUIRED_CHANNEL_COUNT);
+        buffer = stbi_load(fileName.c_str(), &iwidth, &iheight, &ichannelCount, requiredChannelCount);
         imageDesc.baseType = ImageDesc::BASETYPE_UINT8;
     }
     if (buffer)
@@ -131,7 +171,9 @@ bool StbImageLoader::loadImage(const FilePath& filePath, ImageDesc &imageDesc,
         imageDesc.resourceBuffer = buffer;
         imageDesc.width = iwidth;
         imageDesc.height = iheight;
-        imageDesc.channelCount = ichannelCount;
+        // The loader reports the number of channels in the file, rather
+        // than the number of channels requested.
+        imageDesc.channelCount = requiredChannelCount ? requiredChannelCount : ichannelCount;
         imageDesc.computeMipCount();
         // Set the deallocator to be the one provided with the library
         imageDesc.resourceBufferDeallocator = &stbi_image_free;
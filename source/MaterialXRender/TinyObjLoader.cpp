@@ -16,18 +16,563 @@
 #pragma GCC diagnostic pop
 #endif
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 
 namespace MaterialX
 {
+
+namespace
+{
+    // Attributes of a vertex built from a face corner, compared by their bits.
+    struct ObjVertex
+    {
+        float values[8];
+
+        bool operator==(const ObjVertex& rhs) const
+        {
+            return std::memcmp(values, rhs.values, sizeof(values)) == 0;
+        }
+    };
+
+    struct ObjVertexHash
+    {
+        size_t operator()(const ObjVertex& vertex) const
+        {
+            uint32_t bits[8];
+            std::memcpy(bits, vertex.values, sizeof(bits));
+            uint64_t hash = 14695981039346656037ull;
+            for (uint32_t value : bits)
+            {
+                hash = (hash ^ value) * 1099511628211ull;
+            }
+            return size_t(hash ^ (hash >> 32));
+        }
+    };
+
+    // A read-only view of a file mapped into memory.
+    class MappedFile
+    {
+      public:
+        explicit MappedFile(const string& filename) :
+            _data(nullptr),
+            _size(0)
+        {
+#if defined(_WIN32)
+            _file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            _mapping = nullptr;
+            LARGE_INTEGER size;
+            if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size) || size.QuadPart == 0)
+            {
+                return;
+            }
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping)
+            {
+                _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+                _size = _data ? size_t(size.QuadPart) : 0;
+            }
+#else
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return;
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    _data = static_cast<const char*>(data);
+                    _size = size_t(info.st_size);
+                }
+            }
+            close(fd);
+#endif
+        }
+
+        ~MappedFile()
+        {
+#if defined(_WIN32)
+            if (_data)
+            {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping)
+            {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(_file);
+            }
+#else
+            if (_data)
+            {
+                munmap(const_cast<char*>(_data), _size);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const
+        {
+            return _data;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+      private:
+        const char* _data;
+        size_t _size;
+#if defined(_WIN32)
+        HANDLE _file;
+        HANDLE _mapping;
+#endif
+    };
+
+    // A 'g' or 'o' line, which starts a new shape.
+    struct ObjGroupStart
+    {
+        size_t faceOffset;
+        size_t indexOffset;
+        bool hasName;
+        string name;
+    };
+
+    // Flags for the indices of a face corner which are relative to the
+    // attributes read before it.
+    const unsigned int RELATIVE_VERTEX = 1;
+    const unsigned int RELATIVE_NORMAL = 2;
+    const unsigned int RELATIVE_TEXCOORD = 4;
+
+    struct ObjRelativeCorner
+    {
+        size_t corner;
+        unsigned int flags;
+    };
+
+    // The contents of a range of whole lines of an OBJ file. Relative indices
+    // are first resolved against the attributes of the range, and offset by
+    // the attributes of the preceding ranges once all ranges are parsed.
+    struct ObjChunk
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        std::vector<tinyobj::real_t> vertices;
+        std::vector<tinyobj::real_t> normals;
+        std::vector<tinyobj::real_t> texcoords;
+        std::vector<tinyobj::vertex_index_t> corners;
+        std::vector<unsigned int> faceSizes;
+        std::vector<ObjRelativeCorner> relativeCorners;
+        std::vector<ObjGroupStart> groups;
+        std::vector<tinyobj::index_t> indices;
+        string error;
+    };
+
+    // Run a task for each index in [0, count) on up to the given number of threads.
+    void runParallel(size_t count, unsigned int threadCount, const std::function<void(size_t)>& task)
+    {
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                task(i);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < std::min(size_t(threadCount), count); t++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Parse a face corner as tinyobj::parseTriple does, flagging the indices
+    // which are relative.
+    bool parseObjCorner(const char** token, const ObjChunk& chunk, tinyobj::vertex_index_t& corner, unsigned int& relative)
+    {
+        auto parseIndex = [&](size_t count, unsigned int flag, int& index) -> bool
+        {
+            const int value = atoi(*token);
+            if (value == 0)
+            {
+                return false;
+            }
+            if (value < 0)
+            {
+                index = int(count) + value;
+                relative |= flag;
+            }
+            else
+            {
+                index = value - 1;
+            }
+            (*token) += strcspn(*token, "/ \t\r");
+            return true;
+        };
+
+        const size_t vertexCount = chunk.vertices.size() / 3;
+        const size_t normalCount = chunk.normals.size() / 3;
+        const size_t texcoordCount = chunk.texcoords.size() / 2;
+        if (!parseIndex(vertexCount, RELATIVE_VERTEX, corner.v_idx))
+        {
+            return false;
+        }
+        if ((*token)[0] != '/')
+        {
+            return true;
+        }
+        (*token)++;
+        if ((*token)[0] == '/')
+        {
+            (*token)++;
+            return parseIndex(normalCount, RELATIVE_NORMAL, corner.vn_idx);
+        }
+        if (!parseIndex(texcoordCount, RELATIVE_TEXCOORD, corner.vt_idx))
+        {
+            return false;
+        }
+        if ((*token)[0] != '/')
+        {
+            return true;
+        }
+        (*token)++;
+        return parseIndex(normalCount, RELATIVE_NORMAL, corner.vn_idx);
+    }
+
+    // Parse the attributes, faces and groups of a range of lines, with the
+    // same rules as tinyobj::LoadObj. Materials, smoothing groups, lines and
+    // tags are ignored, as they are not used to build meshes.
+    void parseObjChunk(ObjChunk& chunk)
+    {
+        string line;
+        const char* pos = chunk.begin;
+        while (pos < chunk.end)
+        {
+            // Lines end with "\n", "\r\n" or "\r", as in tinyobj::safeGetline.
+            const char* lineEnd = pos;
+            while (lineEnd < chunk.end && *lineEnd != '\n' && *lineEnd != '\r')
+            {
+                lineEnd++;
+            }
+            line.assign(pos, lineEnd);
+            pos = lineEnd;
+            if (pos < chunk.end && *pos == '\r')
+            {
+                pos++;
+            }
+            if (pos < chunk.end && *pos == '\n')
+            {
+                pos++;
+            }
+
+            const char* token = line.c_str();
+            token += strspn(token, " \t");
+            if (token[0] == 'v' && IS_SPACE(token[1]))
+            {
+                token += 2;
+                tinyobj::real_t x, y, z;
+                tinyobj::parseReal3(&x, &y, &z, &token);
+                chunk.vertices.push_back(x);
+                chunk.vertices.push_back(y);
+                chunk.vertices.push_back(z);
+            }
+            else if (token[0] == 'v' && token[1] == 'n' && IS_SPACE(token[2]))
+            {
+                token += 3;
+                tinyobj::real_t x, y, z;
+                tinyobj::parseReal3(&x, &y, &z, &token);
+                chunk.normals.push_back(x);
+                chunk.normals.push_back(y);
+                chunk.normals.push_back(z);
+            }
+            else if (token[0] == 'v' && token[1] == 't' && IS_SPACE(token[2]))
+            {
+                token += 3;
+                tinyobj::real_t x, y;
+                tinyobj::parseReal2(&x, &y, &token);
+                chunk.texcoords.push_back(x);
+                chunk.texcoords.push_back(y);
+            }
+            else if (token[0] == 'f' && IS_SPACE(token[1]))
+            {
+                token += 2;
+                token += strspn(token, " \t");
+                unsigned int faceSize = 0;
+                while (!IS_NEW_LINE(token[0]))
+                {
+                    tinyobj::vertex_index_t corner(-1);
+                    unsigned int relative = 0;
+                    if (!parseObjCorner(&token, chunk, corner, relative))
+                    {
+                        chunk.error = "Failed parse `f' line (e.g. zero value for face index): " + line;
+                        return;
+                    }
+                    if (relative)
+                    {
+                        chunk.relativeCorners.push_back({ chunk.corners.size(), relative });
+                    }
+                    chunk.corners.push_back(corner);
+                    faceSize++;
+                    token += strspn(token, " \t\r");
+                }
+                chunk.faceSizes.push_back(faceSize);
+            }
+            else if (token[0] == 'g' && IS_SPACE(token[1]))
+            {
+                // Group names are joined with spaces, and a group without a
+                // name keeps the previous name.
+                ObjGroupStart group = { chunk.faceSizes.size(), 0, false, EMPTY_STRING };
+                token += 2;
+                token += strspn(token, " \t\r");
+                while (!IS_NEW_LINE(token[0]))
+                {
+                    const string name = tinyobj::parseString(&token);
+                    group.name += group.hasName ? " " + name : name;
+                    group.hasName = true;
+                    token += strspn(token, " \t\r");
+                }
+                chunk.groups.push_back(group);
+            }
+            else if (token[0] == 'o' && IS_SPACE(token[1]))
+            {
+                chunk.groups.push_back({ chunk.faceSizes.size(), 0, true, string(token + 2) });
+            }
+        }
+    }
+
+    // Resolve the relative indices of a chunk, and triangulate its faces as
+    // tinyobj::LoadObj does, given the attributes of the whole file.
+    void triangulateObjChunk(ObjChunk& chunk, const tinyobj::attrib_t& attrib, size_t vertexOffset,
+                             size_t normalOffset, size_t texcoordOffset)
+    {
+        for (const ObjRelativeCorner& relative : chunk.relativeCorners)
+        {
+            tinyobj::vertex_index_t& corner = chunk.corners[relative.corner];
+            corner.v_idx += (relative.flags & RELATIVE_VERTEX) ? int(vertexOffset) : 0;
+            corner.vn_idx += (relative.flags & RELATIVE_NORMAL) ? int(normalOffset) : 0;
+            corner.vt_idx += (relative.flags & RELATIVE_TEXCOORD) ? int(texcoordOffset) : 0;
+        }
+
+        const int vertexCount = int(attrib.vertices.size() / 3);
+        const int normalCount = int(attrib.normals.size() / 3);
+        const int texcoordCount = int(attrib.texcoords.size() / 2);
+        for (const tinyobj::vertex_index_t& corner : chunk.corners)
+        {
+            if (corner.v_idx < 0 || corner.v_idx >= vertexCount ||
+                corner.vn_idx < -1 || corner.vn_idx >= normalCount ||
+                corner.vt_idx < -1 || corner.vt_idx >= texcoordCount)
+            {
+                chunk.error = "Face index out of range";
+                return;
+            }
+        }
+
+        // Polygons are triangulated by tinyobj::exportGroupsToShape, one at a time.
+        tinyobj::shape_t polygonShape;
+        std::vector<tinyobj::face_t> polygon(1);
+        std::vector<int> lines;
+        std::vector<tinyobj::tag_t> tags;
+
+        chunk.indices.reserve(chunk.corners.size());
+        size_t groupIndex = 0;
+        size_t cornerOffset = 0;
+        for (size_t face = 0; face < chunk.faceSizes.size(); face++)
+        {
+            for (; groupIndex < chunk.groups.size() && chunk.groups[groupIndex].faceOffset == face; groupIndex++)
+            {
+                chunk.groups[groupIndex].indexOffset = chunk.indices.size();
+            }
+            const unsigned int faceSize = chunk.faceSizes[face];
+            const tinyobj::vertex_index_t* corners = &chunk.corners[cornerOffset];
+            cornerOffset += faceSize;
+            if (faceSize == 3)
+            {
+                for (unsigned int k = 0; k < 3; k++)
+                {
+                    tinyobj::index_t index;
+                    index.vertex_index = corners[k].v_idx;
+                    index.normal_index = corners[k].vn_idx;
+                    index.texcoord_index = corners[k].vt_idx;
+                    chunk.indices.push_back(index);
+                }
+            }
+            else if (faceSize > 3)
+            {
+                polygon[0].vertex_indices.assign(corners, corners + faceSize);
+                polygonShape.mesh.indices.clear();
+                tinyobj::exportGroupsToShape(&polygonShape, polygon, lines, tags, -1, EMPTY_STRING, true, attrib.vertices);
+                chunk.indices.insert(chunk.indices.end(), polygonShape.mesh.indices.begin(), polygonShape.mesh.indices.end());
+            }
+        }
+        for (; groupIndex < chunk.groups.size(); groupIndex++)
+        {
+            chunk.groups[groupIndex].indexOffset = chunk.indices.size();
+        }
+        std::vector<tinyobj::vertex_index_t>().swap(chunk.corners);
+        std::vector<unsigned int>().swap(chunk.faceSizes);
+    }
+
+    // Parse an OBJ file on multiple threads, returning the same attributes and
+    // triangulated shapes as tinyobj::LoadObj.
+    bool loadObjParallel(const string& filename, unsigned int threadCount, tinyobj::attrib_t& attrib,
+                         std::vector<tinyobj::shape_t>& shapes, string& err)
+    {
+        MappedFile file(filename);
+        if (!file.data())
+        {
+            err = "Cannot open or map file: " + filename;
+            return false;
+        }
+
+        // Split the file into ranges of whole lines, several per thread to
+        // balance the load.
+        const size_t MIN_CHUNK_SIZE = 1 << 16;
+        const size_t CHUNKS_PER_THREAD = 4;
+        const size_t chunkCount = std::max(size_t(1), std::min(size_t(threadCount) * CHUNKS_PER_THREAD,
+                                                                 file.size() / MIN_CHUNK_SIZE));
+        std::vector<ObjChunk> chunks(chunkCount);
+        const char* fileEnd = file.data() + file.size();
+        const char* begin = file.data();
+        for (size_t i = 0; i < chunkCount; i++)
+        {
+            const char* end = fileEnd;
+            if (i + 1 < chunkCount)
+            {
+                end = std::max(begin, file.data() + file.size() * (i + 1) / chunkCount);
+                const void* newline = std::memchr(end, '\n', size_t(fileEnd - end));
+                end = newline ? static_cast<const char*>(newline) + 1 : fileEnd;
+            }
+            chunks[i].begin = begin;
+            chunks[i].end = end;
+            begin = end;
+        }
+
+        runParallel(chunkCount, threadCount, [&chunks](size_t i)
+        {
+            parseObjChunk(chunks[i]);
+        });
+
+        // Concatenate the attributes of the chunks.
+        std::vector<size_t> vertexOffsets(chunkCount + 1, 0);
+        std::vector<size_t> normalOffsets(chunkCount + 1, 0);
+        std::vector<size_t> texcoordOffsets(chunkCount + 1, 0);
+        for (size_t i = 0; i < chunkCount; i++)
+        {
+            if (!chunks[i].error.empty())
+            {
+                err = chunks[i].error;
+                return false;
+            }
+            vertexOffsets[i + 1] = vertexOffsets[i] + chunks[i].vertices.size();
+            normalOffsets[i + 1] = normalOffsets[i] + chunks[i].normals.size();
+            texcoordOffsets[i + 1] = texcoordOffsets[i] + chunks[i].texcoords.size();
+        }
+        attrib.vertices.resize(vertexOffsets[chunkCount]);
+        attrib.normals.resize(normalOffsets[chunkCount]);
+        attrib.texcoords.resize(texcoordOffsets[chunkCount]);
+        runParallel(chunkCount, threadCount, [&](size_t i)
+        {
+            ObjChunk& chunk = chunks[i];
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), attrib.vertices.begin() + vertexOffsets[i]);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), attrib.normals.begin() + normalOffsets[i]);
+            std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), attrib.texcoords.begin() + texcoordOffsets[i]);
+            std::vector<tinyobj::real_t>().swap(chunk.vertices);
+            std::vector<tinyobj::real_t>().swap(chunk.normals);
+            std::vector<tinyobj::real_t>().swap(chunk.texcoords);
+        });
+
+        runParallel(chunkCount, threadCount, [&](size_t i)
+        {
+            triangulateObjChunk(chunks[i], attrib, vertexOffsets[i] / 3, normalOffsets[i] / 3, texcoordOffsets[i] / 2);
+        });
+
+        // Build the shapes in file order. Each group line ends the current
+        // shape, which is kept if it has any triangles.
+        tinyobj::shape_t shape;
+        string name;
+        auto endShape = [&]()
+        {
+            if (!shape.mesh.indices.empty())
+            {
+                shape.name = name;
+                shapes.push_back(std::move(shape));
+            }
+            shape = tinyobj::shape_t();
+        };
+        for (ObjChunk& chunk : chunks)
+        {
+            if (!chunk.error.empty())
+            {
+                err = chunk.error;
+                return false;
+            }
+            size_t start = 0;
+            for (const ObjGroupStart& group : chunk.groups)
+            {
+                shape.mesh.indices.insert(shape.mesh.indices.end(), chunk.indices.begin() + start,
+                                          chunk.indices.begin() + group.indexOffset);
+                start = group.indexOffset;
+                endShape();
+                if (group.hasName)
+                {
+                    name = group.name;
+                }
+            }
+            shape.mesh.indices.insert(shape.mesh.indices.end(), chunk.indices.begin() + start, chunk.indices.end());
+            std::vector<tinyobj::index_t>().swap(chunk.indices);
+        }
+        endShape();
+
+        return true;
+    }
+}
+
 bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
     std::string err;
-    bool load = tinyobj::LoadObj(&attrib, &shapes, &materials, nullptr, &err,
-                                 filePath.asString().c_str(), nullptr, true, false);
+    unsigned int threadCount = _threadCount ? _threadCount : std::thread::hardware_concurrency();
+    bool load = false;
+    if (threadCount > 1)
+    {
+        load = loadObjParallel(filePath.asString(), threadCount, attrib, shapes, err);
+    }
+    else
+    {
+        std::vector<tinyobj::material_t> materials;
+        load = tinyobj::LoadObj(&attrib, &shapes, &materials, nullptr, &err,
+                                filePath.asString().c_str(), nullptr, true, false);
+    }
     if (!load)
     {
         std::cerr << err << std::endl;
@@ -59,29 +604,49 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
 
     MeshStreamPtr tangentStream = MeshStream::create("i_" + MeshStream::TANGENT_ATTRIBUTE, MeshStream::TANGENT_ATTRIBUTE, 0);
     tangentStream->setStride(MeshStream::STRIDE_3D);
-    MeshFloatBuffer& tangents = tangentStream->getData();
     mesh->addStream(tangentStream);
 
-    // Explode the geometry, since we may have unshared geometry
-    // in position, normal or uv
+    // Each face corner references its own position, normal and texture
+    // coordinate, so vertices are built per corner, and welded with any
+    // previous vertex with the same attributes unless the layout of one
+    // vertex per corner is requested.
     size_t totalIndexCount = 0;
     for (const tinyobj::shape_t& shape : shapes)
     {
         totalIndexCount += shape.mesh.indices.size();
     }
-    positions.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    normals.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    texcoords.resize(totalIndexCount * MeshStream::STRIDE_2D);
-    tangents.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    mesh->setVertexCount(totalIndexCount);
+    positions.reserve(totalIndexCount * MeshStream::STRIDE_3D);
+    normals.reserve(totalIndexCount * MeshStream::STRIDE_3D);
+    texcoords.reserve(totalIndexCount * MeshStream::STRIDE_2D);
+    std::unordered_map<ObjVertex, uint32_t, ObjVertexHash> vertexMap;
+    if (_weldVertices)
+    {
+        vertexMap.reserve(totalIndexCount);
+    }
 
     const float MAX_FLOAT = std::numeric_limits<float>::max();
     Vector3 boxMin = { MAX_FLOAT, MAX_FLOAT, MAX_FLOAT };
     Vector3 boxMax = { -MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT };
 
-    int writeIndex0 = 0;
-    int writeIndex1 = 1;
-    int writeIndex2 = 2;
+    uint32_t meshVertexCount = 0;
+    auto addVertex = [&](const Vector3& position, const Vector3& normal, const Vector2& texcoord) -> uint32_t
+    {
+        if (_weldVertices)
+        {
+            ObjVertex vertex = { { position[0], position[1], position[2],
+                                   normal[0], normal[1], normal[2],
+                                   texcoord[0], texcoord[1] } };
+            auto result = vertexMap.insert(std::make_pair(vertex, meshVertexCount));
+            if (!result.second)
+            {
+                return result.first->second;
+            }
+        }
+        positions.insert(positions.end(), position.begin(), position.end());
+        normals.insert(normals.end(), normal.begin(), normal.end());
+        texcoords.insert(texcoords.end(), texcoord.begin(), texcoord.end());
+        return meshVertexCount++;
+    };
 
     const size_t FACE_VERTEX_COUNT = 3;
     for (const tinyobj::shape_t& shape : shapes)
@@ -93,6 +658,31 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
         }
         size_t faceCount = indexCount / FACE_VERTEX_COUNT;
 
+        // Compute the normals of faces without vertex normals in parallel.
+        const size_t FACES_PER_TASK = 1 << 16;
+        vector<Vector3> faceNormals(faceCount);
+        runParallel((faceCount + FACES_PER_TASK - 1) / FACES_PER_TASK, threadCount, [&](size_t task)
+        {
+            const size_t endFace = std::min(faceCount, (task + 1) * FACES_PER_TASK);
+            for (size_t faceIndex = task * FACES_PER_TASK; faceIndex < endFace; faceIndex++)
+            {
+                const tinyobj::index_t* faceIndices = &shape.mesh.indices[faceIndex * FACE_VERTEX_COUNT];
+                if (faceIndices[0].normal_index >= 0 &&
+                    faceIndices[1].normal_index >= 0 &&
+                    faceIndices[2].normal_index >= 0)
+                {
+                    continue;
+                }
+                Vector3 v[FACE_VERTEX_COUNT];
+                for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+                {
+                    const float* position = &attrib.vertices[faceIndices[k].vertex_index * MeshStream::STRIDE_3D];
+                    v[k] = Vector3(position[0], position[1], position[2]);
+                }
+                faceNormals[faceIndex] = (v[1] - v[0]).cross(v[2] - v[0]).getNormalized();
+            }
+        });
+
         MeshPartitionPtr part = MeshPartition::create();
         part->setIdentifier(shape.name);
         MeshIndexBuffer& indices = part->getIndices();
@@ -105,11 +695,6 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
             const tinyobj::index_t& indexObj0 = shape.mesh.indices[faceIndex * 3 + 0];
             const tinyobj::index_t& indexObj1 = shape.mesh.indices[faceIndex * 3 + 1];
             const tinyobj::index_t& indexObj2 = shape.mesh.indices[faceIndex * 3 + 2];
- 
-            // Copy indices.
-            indices[faceIndex * MeshStream::STRIDE_3D + 0] = writeIndex0;
-            indices[faceIndex * MeshStream::STRIDE_3D + 1] = writeIndex1;
-            indices[faceIndex * MeshStream::STRIDE_3D + 2] = writeIndex2;
 
             // Copy positions and compute bounding box.
             Vector3 v[MeshStream::STRIDE_3D];
@@ -128,13 +713,6 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
                 boxMax[k] = std::max(v[2][k], boxMax[k]);
             }
 
-            Vector3* pos = reinterpret_cast<Vector3*>(&(positions[writeIndex0 * MeshStream::STRIDE_3D]));
-            *pos = v[0];
-            pos = reinterpret_cast<Vector3*>(&(positions[writeIndex1 * MeshStream::STRIDE_3D]));
-            *pos = v[1];
-            pos = reinterpret_cast<Vector3*>(&(positions[writeIndex2 * MeshStream::STRIDE_3D]));
-            *pos = v[2];
-
             // Copy or compute normals
             Vector3 n[3];
             if (indexObj0.normal_index >= 0 &&
@@ -150,19 +728,11 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
             }
             else
             {
-                Vector3 faceNorm = (v[1] - v[0]).cross(v[2] - v[0]).getNormalized();
-                n[0] = faceNorm;
-                n[1] = faceNorm;
-                n[2] = faceNorm;
+                n[0] = faceNormals[faceIndex];
+                n[1] = faceNormals[faceIndex];
+                n[2] = faceNormals[faceIndex];
             }
 
-            Vector3* norm = reinterpret_cast<Vector3*>(&(normals[writeIndex0 * MeshStream::STRIDE_3D]));
-            *norm = n[0];
-            norm = reinterpret_cast<Vector3*>(&(normals[writeIndex1 * MeshStream::STRIDE_3D]));
-            *norm = n[1];
-            norm = reinterpret_cast<Vector3*>(&(normals[writeIndex2 * MeshStream::STRIDE_3D]));
-            *norm = n[2];
-
             // Copy texture coordinates.
             Vector2 t[3];
             if (indexObj0.texcoord_index >= 0 &&
@@ -177,18 +747,22 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
                 }
             }
 
-            Vector2* texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex0 * MeshStream::STRIDE_2D]));
-            *texcoord = t[0];
-            texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex1 * MeshStream::STRIDE_2D]));
-            *texcoord = t[1];
-            texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex2 * MeshStream::STRIDE_2D]));
-            *texcoord = t[2];
-
-            writeIndex0 += MeshStream::STRIDE_3D;
-            writeIndex1 += MeshStream::STRIDE_3D;
-            writeIndex2 += MeshStream::STRIDE_3D;
+            // Add or reuse vertices, and copy indices.
+            for (size_t k = 0; k < FACE_VERTEX_COUNT; k++)
+            {
+                indices[faceIndex * FACE_VERTEX_COUNT + k] = addVertex(v[k], n[k], t[k]);
+            }
         }
     }
+    mesh->setVertexCount(meshVertexCount);
+
+    // Release the memory reserved for unwelded vertices.
+    if (_weldVertices)
+    {
+        positions.shrink_to_fit();
+        normals.shrink_to_fit();
+        texcoords.shrink_to_fit();
+    }
 
     mesh->setMinimumBounds(boxMin);
     mesh->setMaximumBounds(boxMax);
@@ -197,7 +771,7 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
     mesh->setSphereRadius((sphereCenter - boxMin).getMagnitude());
 
     MeshStreamPtr bitangentStream = MeshStream::create("i_" + MeshStream::BITANGENT_ATTRIBUTE, MeshStream::BITANGENT_ATTRIBUTE, 0);
-    mesh->generateTangents(positionStream, texCoordStream, normalStream, tangentStream, bitangentStream);
+    mesh->generateTangents(positionStream, texCoordStream, normalStream, tangentStream, bitangentStream, threadCount);
     mesh->addStream(bitangentStream);
 
     return true;
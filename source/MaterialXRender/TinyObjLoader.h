@@ -27,7 +27,9 @@ class TinyObjLoader : public GeometryLoader
     static TinyObjLoaderPtr create() { return std::make_shared<TinyObjLoader>(); }
 
     /// Default constructor
-    TinyObjLoader()
+    TinyObjLoader() :
+        _weldVertices(true),
+        _threadCount(0)
     {
         _extensions = { "obj", "OBJ" };
     }
@@ -37,6 +39,41 @@ class TinyObjLoader : public GeometryLoader
 
     /// Load geometry from disk
     bool load(const FilePath& filePath, MeshList& meshList) override;
+
+    /// Set whether face corners with the same position, normal and texture
+    /// coordinate share a vertex. Defaults to true. If false, each face
+    /// corner is given its own vertex.
+    void setWeldVertices(bool weld)
+    {
+        _weldVertices = weld;
+    }
+
+    /// Return whether face corners with the same attributes share a vertex.
+    bool getWeldVertices() const
+    {
+        return _weldVertices;
+    }
+
+    /// Set the number of threads used to parse OBJ files. With more than one
+    /// thread, the file is mapped into memory and split into ranges of whole
+    /// lines, which are parsed concurrently and merged in file order. Defaults
+    /// to zero, which uses the number of hardware threads. A count of one
+    /// parses the file serially with the TinyObjLoader library. The same
+    /// number of threads is used to generate face normals and tangents.
+    void setThreadCount(unsigned int count)
+    {
+        _threadCount = count;
+    }
+
+    /// Return the number of threads used to parse OBJ files.
+    unsigned int getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+  protected:
+    bool _weldVertices;
+    unsigned int _threadCount;
 };
 
 } // namespace MaterialX
@@ -0,0 +1,275 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/UdimTileSet.h>
+
+#include <MaterialXCore/Geom.h>
+#include <MaterialXCore/Util.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MaterialX
+{
+
+namespace
+{
+    const int FIRST_UDIM = 1001;
+    const size_t UDIM_DIGITS = 4;
+}
+
+UdimTileSet::UdimTileSet(const FilePath& pattern, ImageHandlerPtr imageHandler) :
+    _pattern(pattern),
+    _imageHandler(imageHandler),
+    _tilesEnumerated(false)
+{
+}
+
+bool UdimTileSet::isUdimPattern(const FilePath& filePath)
+{
+    return filePath.asString().find(UDIM_TOKEN) != string::npos;
+}
+
+string UdimTileSet::getUdim(float u, float v)
+{
+    const int udimU = (int) std::floor(u);
+    const int udimV = (int) std::floor(v);
+    return std::to_string(FIRST_UDIM + udimU + 10 * udimV);
+}
+
+StringSet UdimTileSet::getUdims(const Mesh& mesh, const MeshPartition& partition)
+{
+    StringSet udims;
+    MeshStreamPtr texcoords = mesh.getStream(MeshStream::TEXCOORD_ATTRIBUTE, 0);
+    if (!texcoords)
+    {
+        return udims;
+    }
+
+    const unsigned int FACE_VERTEX_COUNT = 3;
+    const MeshFloatBuffer& data = texcoords->getData();
+    const MeshIndexBuffer& indices = partition.getIndices();
+    for (size_t f = 0; f < partition.getFaceCount(); f++)
+    {
+        const size_t offset = size_t(indices[f * FACE_VERTEX_COUNT]) * texcoords->getStride();
+        udims.insert(getUdim(data[offset], data[offset + 1]));
+    }
+    return udims;
+}
+
+FilePath UdimTileSet::getTilePath(const string& udim) const
+{
+    StringMap substitutions;
+    substitutions[UDIM_TOKEN] = udim;
+    const FilePath tilePath = replaceSubstrings(_pattern.asString(), substitutions);
+    return _imageHandler ? _imageHandler->findFile(tilePath) : tilePath;
+}
+
+const StringVec& UdimTileSet::getTiles()
+{
+    if (_tilesEnumerated)
+    {
+        return _tiles;
+    }
+    _tilesEnumerated = true;
+
+    // Split the file name around the token, and list the files of the directory
+    // which match it with a UDIM identifier in place of the token.
+    const string fileName = _pattern.getBaseName();
+    const size_t tokenPos = fileName.find(UDIM_TOKEN);
+    if (tokenPos == string::npos)
+    {
+        return _tiles;
+    }
+    const string prefix = fileName.substr(0, tokenPos);
+    const string suffix = fileName.substr(tokenPos + UDIM_TOKEN.size());
+
+    FilePath directory = _pattern;
+    directory.pop();
+    FilePathVec directories;
+    if (directory.isAbsolute() || !_imageHandler || _imageHandler->getSearchPath().size() == 0)
+    {
+        directories.push_back(directory.isEmpty() ? FilePath::getCurrentPath() : directory);
+    }
+    else
+    {
+        for (const FilePath& path : _imageHandler->getSearchPath().paths())
+        {
+            directories.push_back(path / directory);
+        }
+    }
+
+    StringSet udims;
+    for (const FilePath& dir : directories)
+    {
+        for (const FilePath& file : dir.getFilesInDirectory(_pattern.getExtension()))
+        {
+            const string name = file.asString();
+            if (name.size() != prefix.size() + UDIM_DIGITS + suffix.size() ||
+                name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                continue;
+            }
+            const string udim = name.substr(prefix.size(), UDIM_DIGITS);
+            const bool digits = std::all_of(udim.begin(), udim.end(), [](char c)
+            {
+                return c >= '0' && c <= '9';
+            });
+            if (digits && std::stoi(udim) >= FIRST_UDIM)
+            {
+                udims.insert(udim);
+            }
+        }
+    }
+    _tiles.assign(udims.begin(), udims.end());
+    _statistics.tileCount = _tiles.size();
+    return _tiles;
+}
+
+bool UdimTileSet::hasTile(const string& udim)
+{
+    const StringVec& tiles = getTiles();
+    return std::binary_search(tiles.begin(), tiles.end(), udim);
+}
+
+bool UdimTileSet::requestTile(const string& udim, unsigned int level)
+{
+    // Levels beyond the smallest level of a resident tile are already loaded.
+    auto it = _residentTiles.find(udim);
+    if (it != _residentTiles.end())
+    {
+        const Tile& tile = it->second;
+        if (tile.level == level || (level > tile.level && tile.image.width == 1 && tile.image.height == 1))
+        {
+            return true;
+        }
+    }
+    if (!_imageHandler || !hasTile(udim))
+    {
+        _statistics.failedLoads++;
+        return false;
+    }
+
+    ImageDesc image;
+    if (!_imageHandler->acquireImage(getTilePath(udim), image, false))
+    {
+        _statistics.failedLoads++;
+        return false;
+    }
+    _statistics.loads++;
+    if (level > 0 && image.resourceBuffer && image.mipBuffers.empty())
+    {
+        image.generateMipMaps();
+    }
+
+    // Keep only the buffer of the requested level. The tile image holds a
+    // reference to the level, which is released when its buffer is freed.
+    level = std::min(level, unsigned(image.mipBuffers.size()));
+    Tile& tile = _residentTiles[udim];
+    tile.image.freeResourceBuffer();
+    tile.image = image;
+    tile.level = level;
+    if (level > 0)
+    {
+        std::shared_ptr<void> buffer = image.mipBuffers[level - 1];
+        tile.image.width = image.getMipWidth(level);
+        tile.image.height = image.getMipHeight(level);
+        tile.image.computeMipCount();
+        tile.image.resourceBuffer = buffer.get();
+        tile.image.resourceBufferDeallocator = [buffer](void*) mutable
+        {
+            buffer.reset();
+        };
+        image.freeResourceBuffer();
+    }
+    else
+    {
+        // Ownership of the buffer moves to the tile.
+        image.resourceBuffer = nullptr;
+    }
+    tile.image.mipBuffers.clear();
+    return true;
+}
+
+StringSet UdimTileSet::requestTiles(const Mesh& mesh, const vector<MeshPartitionPtr>& partitions, unsigned int level)
+{
+    StringSet udims;
+    for (MeshPartitionPtr partition : partitions)
+    {
+        for (const string& udim : getUdims(mesh, *partition))
+        {
+            if (requestTile(udim, level))
+            {
+                udims.insert(udim);
+            }
+        }
+    }
+    return udims;
+}
+
+const ImageDesc* UdimTileSet::getTileImage(const string& udim) const
+{
+    auto it = _residentTiles.find(udim);
+    return it != _residentTiles.end() ? &it->second.image : nullptr;
+}
+
+unsigned int UdimTileSet::getTileLevel(const string& udim) const
+{
+    return _residentTiles.at(udim).level;
+}
+
+void UdimTileSet::evictTile(const string& udim)
+{
+    if (_residentTiles.erase(udim))
+    {
+        _statistics.evictions++;
+    }
+}
+
+void UdimTileSet::evictTilesExcept(const StringSet& udims)
+{
+    for (auto it = _residentTiles.begin(); it != _residentTiles.end(); )
+    {
+        if (udims.count(it->first))
+        {
+            ++it;
+        }
+        else
+        {
+            it = _residentTiles.erase(it);
+            _statistics.evictions++;
+        }
+    }
+}
+
+void UdimTileSet::clear()
+{
+    evictTilesExcept(StringSet());
+}
+
+UdimTileSet::Statistics UdimTileSet::getStatistics() const
+{
+    Statistics statistics = _statistics;
+    statistics.residentTiles = _residentTiles.size();
+    statistics.residentBytes = 0;
+    for (const auto& it : _residentTiles)
+    {
+        if (it.second.image.resourceBuffer)
+        {
+            statistics.residentBytes += ImageBufferCache::getBufferSize(it.second.image);
+        }
+    }
+    return statistics;
+}
+
+void UdimTileSet::resetStatistics()
+{
+    _statistics.loads = 0;
+    _statistics.failedLoads = 0;
+    _statistics.evictions = 0;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,144 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_UDIMTILESET_H
+#define MATERIALX_UDIMTILESET_H
+
+/// @file
+/// On-demand loading of UDIM texture tiles
+
+#include <MaterialXRender/ImageHandler.h>
+#include <MaterialXRender/Mesh.h>
+
+namespace MaterialX
+{
+
+/// Shared pointer to a UdimTileSet
+using UdimTileSetPtr = std::shared_ptr<class UdimTileSet>;
+
+/// @class UdimTileSet
+/// A set of UDIM texture tiles, described by a file name pattern containing
+/// the \<UDIM\> token.
+///
+/// The tiles which exist are enumerated from the file system the first time
+/// they are queried, without decoding any images. Tiles are then loaded with
+/// the image handler only when requested, for example for the partitions of
+/// a mesh which are visible, and at a requested mip map level, so that a large
+/// tile set can be displayed without decoding all tiles at full resolution.
+class UdimTileSet
+{
+  public:
+    /// Tile residency statistics
+    struct Statistics
+    {
+        /// Number of tiles found on the file system
+        size_t tileCount = 0;
+        /// Number of tiles currently loaded
+        size_t residentTiles = 0;
+        /// Size in bytes of the buffers of the loaded tiles
+        size_t residentBytes = 0;
+        /// Number of tiles loaded from the image handler
+        size_t loads = 0;
+        /// Number of requested tiles which are missing or could not be loaded
+        size_t failedLoads = 0;
+        /// Number of tiles evicted
+        size_t evictions = 0;
+    };
+
+    /// Constructor
+    /// @param pattern File name pattern containing the \<UDIM\> token.
+    /// @param imageHandler Handler used to find and load the tiles.
+    UdimTileSet(const FilePath& pattern, ImageHandlerPtr imageHandler);
+
+    /// Static instance create function
+    static UdimTileSetPtr create(const FilePath& pattern, ImageHandlerPtr imageHandler)
+    {
+        return std::make_shared<UdimTileSet>(pattern, imageHandler);
+    }
+
+    /// Return true if the given file name contains the \<UDIM\> token.
+    static bool isUdimPattern(const FilePath& filePath);
+
+    /// Return the UDIM identifier, such as "1001", of the tile containing the
+    /// given texture coordinate.
+    static string getUdim(float u, float v);
+
+    /// Return the UDIM identifiers of the tiles referenced by the faces of a
+    /// mesh partition. As in Mesh::splitByUdims, each face is assigned to the
+    /// tile containing the texture coordinate of its first vertex.
+    static StringSet getUdims(const Mesh& mesh, const MeshPartition& partition);
+
+    /// Return the file name pattern.
+    const FilePath& getPattern() const
+    {
+        return _pattern;
+    }
+
+    /// Return the file path of the tile with the given UDIM identifier.
+    FilePath getTilePath(const string& udim) const;
+
+    /// Return the UDIM identifiers of the tiles which exist on the file system,
+    /// in ascending order. The tiles are enumerated on the first call.
+    const StringVec& getTiles();
+
+    /// Return true if the tile with the given UDIM identifier exists.
+    bool hasTile(const string& udim);
+
+    /// Load the tile with the given UDIM identifier, if it is not already
+    /// loaded at the given level.
+    /// @param udim UDIM identifier of the tile.
+    /// @param level Mip map level to load the tile at, where level 0 is the
+    ///    full resolution. Lower levels are generated on the CPU, and levels
+    ///    beyond the smallest level are clamped. Handlers which do not keep
+    ///    the CPU buffers of images, such as GLTextureHandler, load the tile
+    ///    at full resolution.
+    /// @return True if the tile is loaded.
+    bool requestTile(const string& udim, unsigned int level = 0);
+
+    /// Load the tiles referenced by the given partitions of a mesh, such as
+    /// the visible partitions, at the given level.
+    /// @return The UDIM identifiers of the tiles which are loaded.
+    StringSet requestTiles(const Mesh& mesh, const vector<MeshPartitionPtr>& partitions, unsigned int level = 0);
+
+    /// Return the image of a loaded tile, or nullptr if the tile is not loaded.
+    const ImageDesc* getTileImage(const string& udim) const;
+
+    /// Return the level a tile is loaded at. The tile must be loaded.
+    unsigned int getTileLevel(const string& udim) const;
+
+    /// Unload the tile with the given UDIM identifier.
+    void evictTile(const string& udim);
+
+    /// Unload all tiles other than the given ones, for example when the
+    /// visible partitions of a mesh change.
+    void evictTilesExcept(const StringSet& udims);
+
+    /// Unload all tiles.
+    void clear();
+
+    /// Return the residency statistics.
+    Statistics getStatistics() const;
+
+    /// Reset the load, failure and eviction counts.
+    void resetStatistics();
+
+  protected:
+    struct Tile
+    {
+        ImageDesc image;
+        unsigned int level = 0;
+    };
+
+    FilePath _pattern;
+    ImageHandlerPtr _imageHandler;
+    StringVec _tiles;
+    bool _tilesEnumerated;
+    std::map<string, Tile> _residentTiles;
+    Statistics _statistics;
+};
+
+} // namespace MaterialX
+
+#endif
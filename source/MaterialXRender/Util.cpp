@@ -8,9 +8,87 @@
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX2__)
+    #include <immintrin.h>
+    #define MATERIALX_USE_F16C
+#endif
+
 namespace MaterialX
 {
 
+namespace
+{
+    uint32_t floatToBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float bitsToFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Round to nearest even, with denormals handled by letting the
+    // floating point unit do the rounding.
+    uint16_t floatToHalf(float value)
+    {
+        const uint32_t F32_INFINITY = 255u << 23;
+        const uint32_t F16_OVERFLOW = (127u + 16u) << 23;
+        const uint32_t F16_MIN_NORMAL = (127u - 14u) << 23;
+        const uint32_t DENORMAL_MAGIC = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+        uint32_t bits = floatToBits(value);
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t result;
+        if (bits >= F16_OVERFLOW)
+        {
+            // Infinity for overflows and infinities, quiet NaN for NaNs.
+            result = bits > F32_INFINITY ? 0x7e00 : 0x7c00;
+        }
+        else if (bits < F16_MIN_NORMAL)
+        {
+            const float denormal = bitsToFloat(bits) + bitsToFloat(DENORMAL_MAGIC);
+            result = uint16_t(floatToBits(denormal) - DENORMAL_MAGIC);
+        }
+        else
+        {
+            const uint32_t mantissaOdd = (bits >> 13) & 1u;
+            bits += ((15u - 127u) << 23) + 0xfffu + mantissaOdd;
+            result = uint16_t(bits >> 13);
+        }
+        return uint16_t(result | (sign >> 16));
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        const uint32_t SHIFTED_EXPONENT = 0x7c00u << 13;
+
+        uint32_t bits = (value & 0x7fffu) << 13;
+        const uint32_t exponent = bits & SHIFTED_EXPONENT;
+        bits += (127u - 15u) << 23;
+        if (exponent == SHIFTED_EXPONENT)
+        {
+            // Infinities and NaNs
+            bits += (128u - 16u) << 23;
+        }
+        else if (exponent == 0)
+        {
+            // Zeros and denormals
+            bits += 1u << 23;
+            bits = floatToBits(bitsToFloat(bits) - bitsToFloat(113u << 23));
+        }
+        return bitsToFloat(bits | (uint32_t(value & 0x8000u) << 16));
+    }
+}
+
 ShaderPtr createShader(const string& shaderName, GenContext& context, ElementPtr elem)
 {
     return context.getShaderGenerator().generate(shaderName, elem, context);
@@ -34,6 +112,39 @@ ShaderPtr createConstantShader(GenContext& context,
     return createShader(shaderName, context, output);
 }
 
+void convertFloatToHalf(const float* source, uint16_t* dest, size_t count)
+{
+    size_t i = 0;
+#ifdef MATERIALX_USE_F16C
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i low = _mm_cvtps_ph(_mm_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+        const __m128i high = _mm_cvtps_ph(_mm_loadu_ps(source + i + 4), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_unpacklo_epi64(low, high));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dest[i] = floatToHalf(source[i]);
+    }
+}
+
+void convertHalfToFloat(const uint16_t* source, float* dest, size_t count)
+{
+    size_t i = 0;
+#ifdef MATERIALX_USE_F16C
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i half = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_ps(dest + i, _mm_cvtph_ps(half));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dest[i] = halfToFloat(source[i]);
+    }
+}
+
 unsigned int getUIProperties(ValueElementPtr nodeDefElement, UIProperties& uiProperties)
 {
     if (!nodeDefElement)
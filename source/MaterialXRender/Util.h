@@ -30,6 +30,17 @@ namespace MaterialX
                                    const string& shaderName,
                                    const Color3& color);
 
+    /// @}
+    /// @name Image utilities
+    /// @{
+
+    /// Convert an array of floats to half floats, rounding to the nearest
+    /// half float. Values outside of the half float range become infinity.
+    void convertFloatToHalf(const float* source, uint16_t* dest, size_t count);
+
+    /// Convert an array of half floats to floats.
+    void convertHalfToFloat(const uint16_t* source, float* dest, size_t count);
+
     /// @}
     /// @name User interface utilities
     /// @{ 
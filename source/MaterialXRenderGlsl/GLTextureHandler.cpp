@@ -8,6 +8,8 @@
 #include <MaterialXRenderGlsl/GlslProgram.h>
 #include <MaterialXRenderGlsl/External/GLew/glew.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 
@@ -51,7 +53,8 @@ bool GLTextureHandler::acquireImage(const FilePath& filePath,
     }
 
     bool textureLoaded = false;
-    if (ImageHandler::acquireImage(filePath, imageDesc, generateMipMaps, fallbackColor))
+    // Mip maps are generated on the GPU, rather than by the base class.
+    if (ImageHandler::acquireImage(filePath, imageDesc, false, fallbackColor))
     {
         imageDesc.resourceId = MaterialX::GlslProgram::UNDEFINED_OPENGL_RESOURCE_ID;
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -65,19 +68,24 @@ bool GLTextureHandler::acquireImage(const FilePath& filePath,
         glActiveTexture(GL_TEXTURE0 + textureUnit);
         glBindTexture(GL_TEXTURE_2D, imageDesc.resourceId);
 
-        GLint internalFormat = GL_RGBA;
+        // Use internal formats with the number of channels of the image,
+        // so that images with fewer channels use less texture memory.
+        GLint internalFormats[] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
         GLenum type = GL_UNSIGNED_BYTE;
 
         if (imageDesc.baseType == ImageDesc::BASETYPE_FLOAT)
         {
-            internalFormat = GL_RGBA32F;
+            GLint floatFormats[] = { GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F };
+            std::copy(floatFormats, floatFormats + 4, internalFormats);
             type = GL_FLOAT;
         }
         else if (imageDesc.baseType == ImageDesc::BASETYPE_HALF)
         {
-            internalFormat = GL_RGBA16F;
+            GLint halfFormats[] = { GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F };
+            std::copy(halfFormats, halfFormats + 4, internalFormats);
             type = GL_HALF_FLOAT;
         }
+        const GLint internalFormat = internalFormats[std::min(std::max(imageDesc.channelCount, 1u), 4u) - 1];
 
         GLint format = GL_RGBA;
         switch (imageDesc.channelCount)
@@ -68,6 +68,13 @@ class GLTextureHandler : public ImageHandler
     /// Returns the bound texture location for a given resource
     int getBoundTextureLocation(unsigned int resourceId) override;
 
+    /// Set the restrictions used when loading images, such as the number of
+    /// channels, or loading floating point images as half floats.
+    void setRestrictions(const ImageDescRestrictions& restrictions)
+    {
+        _restrictions = restrictions;
+    }
+
   protected:
     /// Delete an image
     /// @param imageDesc Image description indicate which image to delete.
@@ -42,7 +42,8 @@ GlslProgram::GlslProgram() :
     _shader(nullptr),
     _indexBuffer(0),
     _indexBufferSize(0),
-    _vertexArray(0)
+    _vertexArray(0),
+    _textureImageHandler(nullptr)
 {
 }
 
@@ -587,7 +588,42 @@ void GlslProgram::bindTextures(ImageHandlerPtr imageHandler)
         throw ExceptionShaderValidationError(errorType, errors);
     }
 
-    // Bind textures based on uniforms found in the program
+    // Gather the textures of the program once for each image search path,
+    // resolving their file paths and sampling properties.
+    const std::string searchPath = imageHandler->getSearchPath().asString();
+    if (_textureImageHandler != imageHandler.get() || _textureSearchPath != searchPath)
+    {
+        updateTextureList(imageHandler);
+
+        // When the handler caches image buffers, decode all textures in parallel
+        // first, so that binding only uploads the decoded buffers. Textures which
+        // are already resident, or which failed to load, are skipped by the handler.
+        if (imageHandler->getBufferCache())
+        {
+            FilePathVec filePaths;
+            for (const TextureInput& texture : _textureList)
+            {
+                filePaths.push_back(texture.filePath);
+            }
+            imageHandler->prefetchImages(filePaths);
+        }
+    }
+
+    for (const TextureInput& texture : _textureList)
+    {
+        ImageDesc desc;
+        bindTexture(texture.type, texture.location, texture.filePath, imageHandler, true, texture.samplingProperties, desc);
+    }
+    checkErrors();
+}
+
+void GlslProgram::updateTextureList(ImageHandlerPtr imageHandler)
+{
+    _textureList.clear();
+    _textureImageHandler = imageHandler.get();
+    _textureSearchPath = imageHandler->getSearchPath().asString();
+
+    // Find textures based on uniforms found in the program
     const MaterialX::GlslProgram::InputMap& uniformList = getUniformsList();
     const std::string IMAGE_SEPARATOR("_");
     for (auto uniform : uniformList)
@@ -615,7 +651,6 @@ void GlslProgram::bindTextures(ImageHandlerPtr imageHandler)
                 }
 
                 ImageSamplingProperties samplingProperties;
-
                 const int INVALID_MAPPED_INT_VALUE = -1; // Any value < 0 is not considered to be invalid
                 const std::string uaddressModeStr = root + UADDRESS_MODE_POST_FIX;
                 ValuePtr intValue = findUniformValue(uaddressModeStr, uniformList);
@@ -637,12 +672,16 @@ void GlslProgram::bindTextures(ImageHandlerPtr imageHandler)
                 samplingProperties.defaultColor[1] = defaultColor[1];
                 samplingProperties.defaultColor[2] = defaultColor[2];
                 samplingProperties.defaultColor[3] = defaultColor[3];
-                ImageDesc desc;
-                bindTexture(uniformType, uniformLocation, fileName, imageHandler, true, samplingProperties, desc);
+
+                TextureInput texture;
+                texture.type = uniformType;
+                texture.location = uniformLocation;
+                texture.filePath = imageHandler->getSearchPath().find(fileName);
+                texture.samplingProperties = samplingProperties;
+                _textureList.push_back(texture);
             }
         }
     }
-    checkErrors();
 }
 
 
@@ -1139,6 +1178,9 @@ void GlslProgram::clearInputLists()
 {
     _uniformList.clear();
     _attributeList.clear();
+    _textureList.clear();
+    _textureImageHandler = nullptr;
+    _textureSearchPath.clear();
 }
 
 const GlslProgram::InputMap& GlslProgram::getUniformsList()
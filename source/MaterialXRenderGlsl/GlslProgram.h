@@ -216,6 +216,10 @@ class GlslProgram
     /// Clear out any cached input lists
     void clearInputLists();
 
+    /// Update the list of textures bound by bindTextures(), resolving
+    /// their file paths with the search path of the given image handler
+    void updateTextureList(ImageHandlerPtr imageHandler);
+
     /// Utility to map a MaterialX type to an OpenGL type
     /// @param type MaterialX type
     /// @return OpenGL type. INVALID_OPENGL_TYPE is returned if no mapping exists. For example strings have no OpenGL type.
@@ -257,6 +261,21 @@ class GlslProgram
     /// List of program input attributes
     InputMap _attributeList;
 
+    /// A texture bound by the program, with its resolved file path
+    struct TextureInput
+    {
+        unsigned int type;
+        int location;
+        FilePath filePath;
+        ImageSamplingProperties samplingProperties;
+    };
+
+    /// List of program textures, excluding lighting textures
+    vector<TextureInput> _textureList;
+    /// Image handler and search path used to build the texture list
+    ImageHandler* _textureImageHandler;
+    string _textureSearchPath;
+
     /// Hardware shader (if any) used for program creation
     ShaderPtr _shader;
 
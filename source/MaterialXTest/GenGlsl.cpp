@@ -13,8 +13,26 @@
 #include <MaterialXFormat/File.h>
 
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#include <MaterialXGenGlsl/GlslShaderReflection.h>
 #include <MaterialXGenGlsl/GlslSyntax.h>
 
+#include <MaterialXGenShader/GenProfiler.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderFunctionLibrary.h>
+#include <MaterialXGenShader/ShaderGraphCache.h>
+#include <MaterialXGenShader/ShaderGroup.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -117,6 +135,1007 @@ TEST_CASE("GenShader: Bind Light Shaders", "[genglsl]")
     REQUIRE_NOTHROW(mx::HwShaderGenerator::bindLightShader(*spotLightShader, 66, context));
 }
 
+TEST_CASE("GenShader: GLSL Common Subexpression Elimination", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Create a graph with two identical branches.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_cse");
+    mx::NodePtr position1 = nodeGraph->addNode("position", "position1", "vector3");
+    mx::NodePtr position2 = nodeGraph->addNode("position", "position2", "vector3");
+    mx::NodePtr multiply1 = nodeGraph->addNode("multiply", "multiply1", "vector3");
+    multiply1->setConnectedNode("in1", position1);
+    multiply1->setInputValue("in2", mx::Vector3(2.0f, 2.0f, 2.0f));
+    mx::NodePtr multiply2 = nodeGraph->addNode("multiply", "multiply2", "vector3");
+    multiply2->setConnectedNode("in1", position2);
+    multiply2->setInputValue("in2", mx::Vector3(2.0f, 2.0f, 2.0f));
+    mx::NodePtr add = nodeGraph->addNode("add", "add", "vector3");
+    add->setConnectedNode("in1", multiply1);
+    add->setConnectedNode("in2", multiply2);
+    mx::NodePtr convert = nodeGraph->addNode("convert", "convert", "color3");
+    convert->setConnectedNode("in", add);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(convert);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // With a reduced interface the duplicate branch is merged.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("cse_reduced", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(shader->getGraph().getNodes().size() == 4);
+    const bool positionMerged = !shader->getGraph().getNode("position1") || !shader->getGraph().getNode("position2");
+    const bool multiplyMerged = !shader->getGraph().getNode("multiply1") || !shader->getGraph().getNode("multiply2");
+    REQUIRE(positionMerged);
+    REQUIRE(multiplyMerged);
+
+    // With a complete interface the nodes with unconnected inputs are published
+    // as separate uniforms, so they must be kept.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shader = context.getShaderGenerator().generate("cse_complete", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(shader->getGraph().getNodes().size() == 6);
+}
+
+static size_t countImageCalls(const std::string& code)
+{
+    // Count image function calls, excluding the function definitions.
+    const std::string imageFunction = "mx_image_";
+    const std::string definition = "void " + imageFunction;
+    size_t count = 0;
+    for (size_t pos = code.find(imageFunction); pos != std::string::npos; pos = code.find(imageFunction, pos + 1))
+    {
+        if (pos < definition.size() - imageFunction.size() ||
+            code.compare(pos + imageFunction.size() - definition.size(), definition.size(), definition) != 0)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+TEST_CASE("GenShader: GLSL Texture Sample Merging", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Create a graph sampling the same texture through
+    // image nodes of different types.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_samples");
+    mx::NodePtr image1 = nodeGraph->addNode("image", "image1", "color3");
+    image1->setParameterValue("file", std::string("layer.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr image2 = nodeGraph->addNode("image", "image2", "float");
+    image2->setParameterValue("file", std::string("layer.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr image3 = nodeGraph->addNode("image", "image3", "color4");
+    image3->setParameterValue("file", std::string("layer.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr image4 = nodeGraph->addNode("image", "image4", "color3");
+    image4->setParameterValue("file", std::string("other.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply", "color3");
+    multiply->setConnectedNode("in1", image1);
+    multiply->setConnectedNode("in2", image2);
+    mx::NodePtr add1 = nodeGraph->addNode("add", "add1", "color3");
+    add1->setConnectedNode("in1", multiply);
+    mx::InputPtr in2 = add1->addInput("in2", "color3");
+    in2->setConnectedNode(image3);
+    in2->setChannels("bgr");
+    mx::NodePtr add2 = nodeGraph->addNode("add", "add2", "color3");
+    add2->setConnectedNode("in1", add1);
+    add2->setConnectedNode("in2", image4);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(add2);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+
+    // Without optimization the texture is sampled once per image node.
+    context.getOptions().optimizationLevel = 0;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("samples_unmerged", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(countImageCalls(shader->getSourceCode(mx::Stage::PIXEL)) == 4);
+
+    // With optimization the samples of the same texture are merged
+    // into a single color4 sample, with channels extracted downstream.
+    context.getOptions().optimizationLevel = 1;
+    shader = context.getShaderGenerator().generate("samples_merged", output, context);
+    REQUIRE(shader != nullptr);
+    const std::string& code = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(countImageCalls(code) == 2);
+    REQUIRE(shader->getGraph().getNode("image3"));
+    REQUIRE(shader->getGraph().getNode("image4"));
+    REQUIRE(!shader->getGraph().getNode("image1"));
+    REQUIRE(!shader->getGraph().getNode("image2"));
+    REQUIRE(code.find("vec3(image3_out.x, image3_out.y, image3_out.z) * image3_out.x") != std::string::npos);
+    REQUIRE(code.find("vec3(image3_out.z, image3_out.y, image3_out.x)") != std::string::npos);
+
+    // With a complete interface the sampling state of each node
+    // is published separately, so the samples must be kept.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shader = context.getShaderGenerator().generate("samples_complete", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(countImageCalls(shader->getSourceCode(mx::Stage::PIXEL)) == 4);
+}
+
+TEST_CASE("GenShader: GLSL Separable Convolution", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Create a graph blurring a texture with the largest kernel.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_blur");
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr blur = nodeGraph->addNode("blur", "blur1", "color3");
+    blur->setConnectedNode("in", image);
+    blur->setParameterValue("size", 1.0f);
+    blur->setParameterValue("filtertype", std::string("gaussian"));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(blur);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+
+    // By default the upstream texture is sampled for every kernel weight.
+    // Note that the image node is also emitted on its own, adding one call.
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("blur_full", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(countImageCalls(shader->getSourceCode(mx::Stage::PIXEL)) == 49 + 1);
+
+    // With separable sampling the weights are baked into the code, and pairs
+    // of samples are merged into single linearly filtered samples when they
+    // are one texel apart. As this depends on the screen derivatives, both
+    // the merged and the unmerged samples are generated.
+    context.getOptions().convolutionSamplingMethod = mx::CONVOLUTION_SAMPLING_SEPARABLE;
+    shader = context.getShaderGenerator().generate("blur_separable", output, context);
+    REQUIRE(shader != nullptr);
+    std::string code = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(countImageCalls(code) == 16 + 49 + 1);
+    REQUIRE(code.find("if (mx_is_texel_aligned(") != std::string::npos);
+    REQUIRE(code.find("c_gaussian_filter_weights, ") == std::string::npos);
+    REQUIRE(code.find("vec3 blur1_out_row3 = ") != std::string::npos);
+    REQUIRE(code.find("0.285714") == std::string::npos); // merged box weights
+
+    // Texels can not be merged if the texture is not linearly filtered.
+    image->setParameterValue("filtertype", std::string("closest"));
+    shader = context.getShaderGenerator().generate("blur_separable_closest", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(countImageCalls(shader->getSourceCode(mx::Stage::PIXEL)) == 49 + 1);
+    image->setParameterValue("filtertype", std::string("linear"));
+
+    // With a complete interface the filter type of the blur is a uniform,
+    // so both filters are generated and selected at runtime. The filter
+    // type of the image is also a uniform, so texels are never merged.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shader = context.getShaderGenerator().generate("blur_separable_complete", output, context);
+    REQUIRE(shader != nullptr);
+    code = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(countImageCalls(code) == 2 * 49 + 1);
+    REQUIRE(code.find("if (blur1_filtertype == 1)") != std::string::npos);
+    REQUIRE(code.find("mx_is_texel_aligned(") == code.rfind("mx_is_texel_aligned("));
+}
+
+TEST_CASE("GenShader: GLSL Graph Flattening", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Create a graph with two nodegraph implemented nodes sharing
+    // part of their internal computation.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_flatten");
+    mx::NodePtr position = nodeGraph->addNode("position", "position", "vector3");
+    mx::NodePtr contrast1 = nodeGraph->addNode("contrast", "contrast1", "vector3");
+    contrast1->setConnectedNode("in", position);
+    contrast1->setParameterValue("amount", mx::Vector3(2.0f, 2.0f, 2.0f));
+    mx::NodePtr contrast2 = nodeGraph->addNode("contrast", "contrast2", "vector3");
+    contrast2->setConnectedNode("in", position);
+    contrast2->setParameterValue("amount", mx::Vector3(3.0f, 3.0f, 3.0f));
+    mx::NodePtr add = nodeGraph->addNode("add", "add", "vector3");
+    add->setConnectedNode("in1", contrast1);
+    add->setConnectedNode("in2", contrast2);
+    mx::NodePtr convert = nodeGraph->addNode("convert", "convert", "color3");
+    convert->setConnectedNode("in", add);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(convert);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("compound", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(shader->getGraph().getNodes().size() == 5);
+    REQUIRE(shader->getSourceCode().find("NG_contrast_vector3") != std::string::npos);
+
+    // With flattening the compounds are inlined and their
+    // identical subtract nodes are merged.
+    context.getOptions().flattenSubgraphs = true;
+    shader = context.getShaderGenerator().generate("flattened", output, context);
+    REQUIRE(shader != nullptr);
+    REQUIRE(shader->getGraph().getNode("contrast1") == nullptr);
+    REQUIRE(shader->getGraph().getNodes().size() == 8);
+    REQUIRE(shader->getSourceCode().find("NG_contrast_vector3") == std::string::npos);
+
+    // Make sure the test suite generates with flattening enabled.
+    const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    const mx::FileSearchPath srcSearchPath(searchPath.asString());
+    const mx::FilePath logPath("genglsl_glsl400_flatten_generate_test.txt");
+    GlslShaderGeneratorTester tester(mx::GlslShaderGenerator::create(), { testRootPath }, searchPath, srcSearchPath, logPath);
+
+    mx::GenOptions genOptions;
+    genOptions.flattenSubgraphs = true;
+    tester.validate(genOptions, testRootPath / mx::FilePath("_options.mtlx"));
+}
+
+TEST_CASE("GenShader: GLSL Optimization Levels", "[genglsl]")
+{
+    const mx::FilePath libSearchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    std::ofstream logFile("genglsl_glsl400_optimization_levels.txt");
+
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, libSearchPath, libraries);
+    GenShaderUtil::loadLibrary(libSearchPath / mx::FilePath("bxdf/standard_surface.mtlx"), libraries);
+
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::StringVec errorLog;
+    mx::loadDocuments(testRootPath, mx::StringSet(), mx::StringSet(), documents, documentPaths, errorLog);
+
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : documents)
+    {
+        doc->importLibrary(libraries);
+        try
+        {
+            mx::findRenderableElements(doc, elements);
+        }
+        catch (mx::Exception& e)
+        {
+            logFile << "Renderables search errors: " << e.what() << std::endl;
+        }
+    }
+    REQUIRE(!elements.empty());
+
+    // Return true if the code contains the given identifier.
+    auto hasIdentifier = [](const std::string& code, const std::string& identifier)
+    {
+        auto isIdentifierChar = [](char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        };
+        for (size_t pos = code.find(identifier); pos != std::string::npos; pos = code.find(identifier, pos + 1))
+        {
+            const size_t end = pos + identifier.size();
+            if ((pos == 0 || !isIdentifierChar(code[pos - 1])) && (end == code.size() || !isIdentifierChar(code[end])))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Generate all test suite elements at each optimization level,
+    // measuring generation time, total size of the generated code
+    // and total number of public uniforms. Uniforms removed at the
+    // highest level must not be referenced by the generated code.
+    std::vector<size_t> codeSize;
+    std::vector<size_t> uniformCount;
+    std::map<std::string, mx::StringVec> level1Uniforms;
+    size_t removedReferenced = 0;
+    for (int level = 0; level <= 2; ++level)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(libSearchPath);
+        context.getOptions().optimizationLevel = level;
+
+        size_t size = 0;
+        size_t uniforms = 0;
+        size_t failures = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (mx::TypedElementPtr element : elements)
+        {
+            try
+            {
+                mx::ShaderPtr shader = context.getShaderGenerator().generate(mx::createValidName(element->getNamePath()), element, context);
+                size += shader->getSourceCode(mx::Stage::VERTEX).size() + shader->getSourceCode(mx::Stage::PIXEL).size();
+                const mx::VariableBlock& publicUniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+                uniforms += publicUniforms.size();
+                if (level == 1)
+                {
+                    mx::StringVec& variables = level1Uniforms[element->getNamePath()];
+                    for (size_t i = 0; i < publicUniforms.size(); ++i)
+                    {
+                        variables.push_back(publicUniforms[i]->getVariable());
+                    }
+                }
+                else if (level == 2)
+                {
+                    mx::StringSet variables;
+                    for (size_t i = 0; i < publicUniforms.size(); ++i)
+                    {
+                        variables.insert(publicUniforms[i]->getVariable());
+                    }
+                    for (const std::string& variable : level1Uniforms[element->getNamePath()])
+                    {
+                        if (!variables.count(variable) && hasIdentifier(shader->getSourceCode(mx::Stage::PIXEL), variable))
+                        {
+                            logFile << "Removed uniform '" << variable << "' is referenced by '" << element->getNamePath() << "'" << std::endl;
+                            ++removedReferenced;
+                        }
+                    }
+                }
+            }
+            catch (mx::Exception& e)
+            {
+                logFile << "Level " << level << ": failed to generate '" << element->getNamePath() << "': " << e.what() << std::endl;
+                ++failures;
+            }
+        }
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+        logFile << "Level " << level << ": " << elements.size() << " elements generated in " << duration.count()
+                << " ms, total code size " << size << " bytes, " << uniforms << " public uniforms" << std::endl;
+        CHECK(failures == 0);
+        codeSize.push_back(size);
+        uniformCount.push_back(uniforms);
+    }
+
+    REQUIRE(codeSize[1] <= codeSize[0]);
+    REQUIRE(codeSize[2] <= codeSize[1]);
+    REQUIRE(uniformCount[2] < uniformCount[1]);
+    REQUIRE(removedReferenced == 0);
+}
+
+static mx::OutputPtr addTextureGraph(mx::DocumentPtr doc, const std::string& graphName, const std::string& prefix,
+                                     const std::string& operation, const std::string& filename, float scale)
+{
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph(graphName);
+    mx::NodePtr image = nodeGraph->addNode("image", prefix + "_image", "color3");
+    image->setParameterValue("file", filename, mx::FILENAME_TYPE_STRING);
+    mx::NodePtr op = nodeGraph->addNode(operation, prefix + "_" + operation, "color3");
+    op->setConnectedNode("in1", image);
+    op->setInputValue("in2", mx::Color3(scale, scale, scale));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(op);
+    return output;
+}
+
+TEST_CASE("GenShader: GLSL Shader Groups", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Two graphs with the same structure but different names and values,
+    // and a third graph with a different structure.
+    std::vector<mx::TypedElementPtr> elements;
+    elements.push_back(addTextureGraph(doc, "NG_group1", "a", "multiply", "a.png", 0.5f));
+    elements.push_back(addTextureGraph(doc, "NG_group2", "b", "multiply", "b.png", 0.8f));
+    elements.push_back(addTextureGraph(doc, "NG_group3", "c", "add", "a.png", 0.5f));
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // With a complete interface values become uniforms,
+    // so the first two elements can share a shader.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    const std::string signature1 = mx::getStructuralSignature(elements[0], context);
+    REQUIRE(signature1 == mx::getStructuralSignature(elements[1], context));
+    REQUIRE(signature1 != mx::getStructuralSignature(elements[2], context));
+
+    std::vector<mx::ShaderGroup> groups;
+    mx::generateShaderGroups(elements, context, groups);
+    REQUIRE(groups.size() == 2);
+    REQUIRE(groups[0].elements.size() == 2);
+    REQUIRE(groups[0].uniformValues.size() == 2);
+    REQUIRE(groups[1].elements.size() == 1);
+    REQUIRE(groups[0].shader != nullptr);
+    REQUIRE(groups[1].shader != nullptr);
+
+    // The uniform tables use the uniform names of the shared shader.
+    const mx::UniformValueMap& values1 = groups[0].uniformValues[0];
+    const mx::UniformValueMap& values2 = groups[0].uniformValues[1];
+    REQUIRE(values1.size() == values2.size());
+    REQUIRE(values1.count("a_multiply_in2"));
+    REQUIRE(values2.count("a_multiply_in2"));
+    REQUIRE(values1.at("a_multiply_in2")->asA<mx::Color3>() == mx::Color3(0.5f, 0.5f, 0.5f));
+    REQUIRE(values2.at("a_multiply_in2")->asA<mx::Color3>() == mx::Color3(0.8f, 0.8f, 0.8f));
+    bool foundFilenames = false;
+    for (auto it : values1)
+    {
+        if (it.second && it.second->getValueString() == "a.png")
+        {
+            REQUIRE(values2.at(it.first)->getValueString() == "b.png");
+            foundFilenames = true;
+        }
+    }
+    REQUIRE(foundFilenames);
+
+    // With a reduced interface values are baked into the code,
+    // so every element needs its own shader.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    groups.clear();
+    mx::generateShaderGroups(elements, context, groups);
+    REQUIRE(groups.size() == 3);
+}
+
+// Return the signatures of all function definitions in the given code.
+static std::vector<std::string> getFunctionSignatures(const std::string& code)
+{
+    std::vector<std::string> signatures;
+    const std::regex definition("^[A-Za-z_]\\w*\\s+[A-Za-z_]\\w*\\([^;{}]*\\)\\s*\\{", std::regex::multiline);
+    for (auto it = std::sregex_iterator(code.begin(), code.end(), definition); it != std::sregex_iterator(); ++it)
+    {
+        std::string signature = it->str();
+        signature.erase(std::remove_if(signature.begin(), signature.end(), ::isspace), signature.end());
+        signatures.push_back(signature);
+    }
+    return signatures;
+}
+
+// Return the given code with the blocks skipped by include guards removed.
+static std::string applyIncludeGuards(const std::string& code)
+{
+    std::string result;
+    std::set<std::string> defines;
+    std::vector<bool> skipping = { false };
+    std::istringstream stream(code);
+    for (std::string line; std::getline(stream, line); )
+    {
+        if (line.compare(0, 8, "#ifndef ") == 0)
+        {
+            skipping.push_back(skipping.back() || defines.count(line.substr(8)) > 0);
+        }
+        else if (line.compare(0, 6, "#endif") == 0)
+        {
+            skipping.pop_back();
+        }
+        else if (!skipping.back())
+        {
+            if (line.compare(0, 8, "#define ") == 0)
+            {
+                defines.insert(line.substr(8));
+            }
+            result += line + "\n";
+        }
+    }
+    return result;
+}
+
+TEST_CASE("GenShader: GLSL Function Overloads", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // Create two implementations using overloads of the
+    // same function, defined in separate source files.
+    const std::vector<std::pair<std::string, std::string>> overloads = { { "float", "float" }, { "vector3", "vec3" } };
+    for (const auto& overload : overloads)
+    {
+        const std::string filename = "mx_overload_" + overload.first + ".glsl";
+        std::ofstream file(filename);
+        file << "void mx_overload(" << overload.second << " in1, out " << overload.second << " result)\n"
+             << "{\n    result = in1 * 2.0;\n}\n";
+        file.close();
+
+        mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_overload_" + overload.first, overload.first, "overload");
+        nodeDef->addInput("in1", overload.first);
+        mx::ImplementationPtr impl = doc->addImplementation("IM_overload_" + overload.first + "_genglsl");
+        impl->setNodeDef(nodeDef);
+        impl->setFile(filename);
+        impl->setFunction("mx_overload");
+        impl->setLanguage(mx::GlslShaderGenerator::LANGUAGE);
+    }
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_overload");
+    mx::NodePtr overloadFloat = nodeGraph->addNode("overload", "overload_float", "float");
+    mx::NodePtr overloadVector = nodeGraph->addNode("overload", "overload_vector3", "vector3");
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply", "vector3");
+    multiply->setConnectedNode("in1", overloadVector);
+    multiply->setConnectedNode("in2", overloadFloat);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "vector3");
+    output->setConnectedNode(multiply);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(mx::FilePath::getCurrentPath());
+
+    // Both overloads must be defined, even though they share a function name.
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("overload", output, context);
+    REQUIRE(shader != nullptr);
+    const std::vector<std::string> signatures = getFunctionSignatures(shader->getSourceCode(mx::Stage::PIXEL));
+    REQUIRE(std::count(signatures.begin(), signatures.end(), "voidmx_overload(floatin1,outfloatresult){") == 1);
+    REQUIRE(std::count(signatures.begin(), signatures.end(), "voidmx_overload(vec3in1,outvec3result){") == 1);
+}
+
+TEST_CASE("GenShader: GLSL Function Library", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+
+    // Create a batch of materials using different texture graphs
+    // feeding into standard surface shaders.
+    const std::vector<std::string> operations = { "multiply", "add", "multiply", "subtract" };
+    std::vector<mx::OutputPtr> outputs;
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        const std::string suffix = std::to_string(i);
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_library" + suffix);
+        mx::NodePtr image = nodeGraph->addNode("image", "image" + suffix, "color3");
+        image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+        mx::NodePtr op = nodeGraph->addNode(operations[i], operations[i] + suffix, "color3");
+        op->setConnectedNode("in1", image);
+        op->setInputValue("in2", mx::Color3(0.5f, 0.5f, 0.5f));
+        mx::NodePtr surface = nodeGraph->addNode("standard_surface", "surface" + suffix, "surfaceshader");
+        surface->setConnectedNode("base_color", op);
+        mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+        output->setConnectedNode(surface);
+        outputs.push_back(output);
+    }
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    std::ofstream logFile("genglsl_glsl400_function_library.txt");
+
+    // Generate the batch without a function library.
+    std::vector<std::string> referenceCode;
+    size_t referenceSize = 0;
+    for (mx::OutputPtr output : outputs)
+    {
+        mx::ShaderPtr shader = context.getShaderGenerator().generate(output->getParent()->getName(), output, context);
+        REQUIRE(shader != nullptr);
+        referenceCode.push_back(shader->getSourceCode(mx::Stage::PIXEL));
+        referenceSize += referenceCode.back().size();
+    }
+
+    // Generate the batch sharing function definitions through a library.
+    mx::ShaderFunctionLibraryPtr library = mx::ShaderFunctionLibrary::create("mx_function_library.glsl");
+    context.setFunctionLibrary(library);
+    std::vector<std::string> libraryCode;
+    size_t librarySize = 0;
+    for (mx::OutputPtr output : outputs)
+    {
+        mx::ShaderPtr shader = context.getShaderGenerator().generate(output->getParent()->getName(), output, context);
+        REQUIRE(shader != nullptr);
+        libraryCode.push_back(shader->getSourceCode(mx::Stage::PIXEL));
+        librarySize += libraryCode.back().size();
+    }
+    context.setFunctionLibrary(nullptr);
+    librarySize += library->getSourceCode().size();
+
+    logFile << "Pixel shader source for " << outputs.size() << " materials: " << referenceSize << " bytes, "
+            << librarySize << " bytes with a function library of " << library->numFunctions() << " functions" << std::endl;
+    REQUIRE(library->numFunctions() > 0);
+    REQUIRE(librarySize < referenceSize);
+
+    // Each shader must include the library once. With the library source
+    // inserted, it must define the same functions as the shader generated
+    // without the library, and define each of them once.
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        const std::string& code = libraryCode[i];
+        const std::string include = "#include \"mx_function_library.glsl\"";
+        REQUIRE(code.find(include) != std::string::npos);
+        REQUIRE(code.find(include) == code.rfind(include));
+        REQUIRE(code.find("void mx_image_color3(") == std::string::npos);
+
+        std::vector<std::string> resolved = getFunctionSignatures(applyIncludeGuards(library->resolveSourceCode(code)));
+        std::vector<std::string> reference = getFunctionSignatures(referenceCode[i]);
+        std::sort(resolved.begin(), resolved.end());
+        std::sort(reference.begin(), reference.end());
+        REQUIRE(std::adjacent_find(resolved.begin(), resolved.end()) == resolved.end());
+        REQUIRE(std::includes(resolved.begin(), resolved.end(), reference.begin(), reference.end()));
+    }
+}
+
+// Return the range of the body for the scope starting at the given position.
+static std::pair<size_t, size_t> findScope(const std::string& code, size_t pos)
+{
+    const size_t begin = code.find('{', pos);
+    int depth = 0;
+    for (size_t i = begin; i < code.size(); ++i)
+    {
+        depth += (code[i] == '{') - (code[i] == '}');
+        if (depth == 0)
+        {
+            return std::make_pair(begin, i);
+        }
+    }
+    return std::make_pair(begin, code.size());
+}
+
+// Estimate the number of statements executed per pixel by the given pixel shader
+// code, including the statements of all functions called. Statements inside the
+// light loop are counted once per light source.
+static size_t estimateStatementCount(const std::string& code, size_t numLights)
+{
+    // Find the body of all function definitions.
+    std::map<std::string, std::pair<size_t, size_t>> functions;
+    const std::regex definition("^[A-Za-z_]\\w* ([A-Za-z_]\\w*)\\(.*\\)\\n\\{", std::regex::multiline);
+    for (auto it = std::sregex_iterator(code.begin(), code.end(), definition); it != std::sregex_iterator(); ++it)
+    {
+        functions[(*it)[1]] = findScope(code, it->position());
+    }
+
+    // Count the statements in a range, adding the cost of any function calls.
+    std::map<std::string, size_t> functionCost;
+    std::function<size_t(size_t, size_t)> countRange = [&](size_t begin, size_t end) -> size_t
+    {
+        const std::string range = code.substr(begin, end - begin);
+        size_t count = std::count(range.begin(), range.end(), ';');
+        const std::regex call("([A-Za-z_]\\w*)\\(");
+        for (auto it = std::sregex_iterator(range.begin(), range.end(), call); it != std::sregex_iterator(); ++it)
+        {
+            const std::string name = (*it)[1];
+            auto function = functions.find(name);
+            if (function != functions.end())
+            {
+                if (!functionCost.count(name))
+                {
+                    functionCost[name] = countRange(function->second.first, function->second.second);
+                }
+                count += functionCost[name];
+            }
+        }
+        return count;
+    };
+
+    const std::pair<size_t, size_t> main = functions["main"];
+    const size_t loopPos = code.find("for (int activeLightIndex", main.first);
+    if (loopPos == std::string::npos || loopPos > main.second)
+    {
+        return countRange(main.first, main.second);
+    }
+    const std::pair<size_t, size_t> loop = findScope(code, loopPos);
+    return countRange(main.first, loop.first) + countRange(loop.second, main.second) +
+           numLights * countRange(loop.first, loop.second);
+}
+
+TEST_CASE("GenShader: GLSL Light Loop Hoisting", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+    std::ofstream logFile("genglsl_glsl400_light_loop_hoisting.txt");
+
+    // Create a BSDF node implemented by a nodegraph, with
+    // light-independent texture nodes inside the graph.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_tintbsdf", "BSDF", "tintbsdf");
+    nodeDef->setInputValue("color", mx::Color3(0.8f, 0.2f, 0.1f));
+    nodeDef->setInputValue("amount", 0.5f);
+    mx::NodeGraphPtr impl = doc->addNodeGraph("IMP_tintbsdf");
+    impl->setNodeDef(nodeDef);
+    mx::NodePtr multiply = impl->addNode("multiply", "multiply1", "color3");
+    multiply->addInput("in1", "color3")->setInterfaceName("color");
+    multiply->addInput("in2", "float")->setInterfaceName("amount");
+    mx::NodePtr power = impl->addNode("power", "power1", "color3");
+    power->setConnectedNode("in1", multiply);
+    power->setInputValue("in2", 2.2f);
+    mx::NodePtr diffuse = impl->addNode("diffuse_brdf", "diffuse_brdf1", "BSDF");
+    diffuse->setConnectedNode("color", power);
+    impl->addOutput("out", "BSDF")->setConnectedNode(diffuse);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_hoisting");
+    mx::NodePtr bsdf = nodeGraph->addNode("tintbsdf", "tintbsdf1", "BSDF");
+    mx::NodePtr surface = nodeGraph->addNode("surface", "surface1", "surfaceshader");
+    surface->setConnectedNode("bsdf", bsdf);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+    output->setConnectedNode(surface);
+
+    mx::NodeGraphPtr standardSurfaceGraph = doc->addNodeGraph("NG_standard_surface_hoisting");
+    mx::NodePtr standardSurface = standardSurfaceGraph->addNode("standard_surface", "standard_surface1", "surfaceshader");
+    mx::OutputPtr standardSurfaceOutput = standardSurfaceGraph->addOutput("out", "surfaceshader");
+    standardSurfaceOutput->setConnectedNode(standardSurface);
+
+    const size_t numLights = 8;
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().hwMaxActiveLightSources = numLights;
+
+    // Without hoisting the texture nodes are evaluated
+    // inside the BSDF function called for each light.
+    context.getOptions().hwLightLoopHoisting = false;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("hoisting_off", output, context);
+    REQUIRE(shader != nullptr);
+    const std::string codeOff = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(codeOff.find("IMP_tintbsdf_reflection(L, V, ") != std::string::npos);
+    const size_t countOff = estimateStatementCount(codeOff, numLights);
+
+    // With hoisting the BSDF graph is inlined and the texture
+    // nodes are evaluated once before the light loop.
+    context.getOptions().hwLightLoopHoisting = true;
+    shader = context.getShaderGenerator().generate("hoisting_on", output, context);
+    REQUIRE(shader != nullptr);
+    const std::string codeOn = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(codeOn.find("IMP_tintbsdf") == std::string::npos);
+    const size_t lightLoop = codeOn.find("// Light loop");
+    const size_t multiplyPos = codeOn.find("vec3 tintbsdf1_multiply1_out = ");
+    const size_t powerPos = codeOn.find("vec3 tintbsdf1_power1_out = ");
+    const size_t diffusePos = codeOn.find("mx_diffuse_brdf_reflection(L, V, ");
+    REQUIRE(lightLoop != std::string::npos);
+    REQUIRE(multiplyPos < lightLoop);
+    REQUIRE(powerPos < lightLoop);
+    REQUIRE(diffusePos != std::string::npos);
+    REQUIRE(diffusePos > lightLoop);
+    REQUIRE(codeOn.find("tintbsdf1_power1_out", diffusePos) != std::string::npos);
+    const size_t countOn = estimateStatementCount(codeOn, numLights);
+
+    logFile << "Layered BSDF graph, " << numLights << " lights: " << countOff << " statements without hoisting, "
+            << countOn << " statements with hoisting" << std::endl;
+    REQUIRE(countOn < countOff);
+
+    // Compare standard surface as well, which is implemented by a surface
+    // shader graph with texture nodes already evaluated before the light loop.
+    context.getOptions().hwLightLoopHoisting = false;
+    shader = context.getShaderGenerator().generate("standard_surface_off", standardSurfaceOutput, context);
+    const size_t standardSurfaceOff = estimateStatementCount(shader->getSourceCode(mx::Stage::PIXEL), numLights);
+    context.getOptions().hwLightLoopHoisting = true;
+    shader = context.getShaderGenerator().generate("standard_surface_on", standardSurfaceOutput, context);
+    const size_t standardSurfaceOn = estimateStatementCount(shader->getSourceCode(mx::Stage::PIXEL), numLights);
+
+    logFile << "Standard surface, " << numLights << " lights: " << standardSurfaceOff << " statements without hoisting, "
+            << standardSurfaceOn << " statements with hoisting" << std::endl;
+    REQUIRE(standardSurfaceOn <= standardSurfaceOff);
+}
+
+TEST_CASE("GenShader: GLSL Generation Profiler", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_profiler");
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr surface = nodeGraph->addNode("standard_surface", "surface1", "surfaceshader");
+    surface->setConnectedNode("base_color", image);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+    output->setConnectedNode(surface);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("profiler_off", output, context);
+    REQUIRE(shader != nullptr);
+    const std::string referenceCode = shader->getSourceCode(mx::Stage::PIXEL);
+
+    // Profiling must not change the generated code. Clear the cached
+    // implementations so their creation is profiled as well.
+    context.clearNodeImplementations();
+    mx::GenProfilerPtr profiler = mx::GenProfiler::create();
+    context.setProfiler(profiler);
+    shader = context.getShaderGenerator().generate("profiler_off", output, context);
+    context.setProfiler(nullptr);
+    REQUIRE(shader != nullptr);
+    REQUIRE(shader->getSourceCode(mx::Stage::PIXEL) == referenceCode);
+
+    const std::string summary = profiler->getSummary();
+    for (const char* name : { "GlslShaderGenerator::generate", "ShaderGraph::create", "ShaderGraph::finalize",
+                                     "ShaderGraph::topologicalSort", "GlslShaderGenerator::emitPixelStage",
+                                     "IM_image_color3_genglsl" })
+    {
+        REQUIRE(summary.find(name) != std::string::npos);
+    }
+
+    // All events must be closed, and nested within the generate event.
+    const std::vector<mx::GenProfiler::Event>& events = profiler->getEvents();
+    REQUIRE(!events.empty());
+    const mx::GenProfiler::Event& generate = events.back();
+    REQUIRE(generate.name == "GlslShaderGenerator::generate");
+    REQUIRE(generate.depth == 0);
+    for (const mx::GenProfiler::Event& event : events)
+    {
+        REQUIRE(event.start >= generate.start);
+        REQUIRE(event.start + event.duration <= generate.start + generate.duration + 1e-3);
+    }
+
+    const std::map<std::string, size_t>& counters = profiler->getCounters();
+    for (const char* name : { "ShaderGraph", "ShaderNode", "ShaderPort", "ShaderNodeImpl" })
+    {
+        REQUIRE(counters.count(name));
+        REQUIRE(counters.at(name) > 0);
+    }
+
+    const std::string trace = profiler->getChromeTrace();
+    REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+    REQUIRE(trace.find("\"name\":\"ShaderGraph::finalize\"") != std::string::npos);
+
+    std::ofstream logFile("genglsl_glsl400_profiler.txt");
+    logFile << summary;
+    std::ofstream traceFile("genglsl_glsl400_profiler_trace.json");
+    traceFile << trace;
+}
+
+// Return the lines of the given code in sorted order, for comparing
+// code where the order of function definitions may differ.
+static std::vector<std::string> getSortedLines(const std::string& code)
+{
+    std::vector<std::string> lines;
+    std::istringstream stream(code);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        lines.push_back(line);
+    }
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+TEST_CASE("GenShader: GLSL Graph Cache", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+
+    // Use library nodes implemented by nodegraphs.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_graph_cache");
+    mx::NodePtr image = nodeGraph->addNode("tiledimage", "tiledimage1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr surface = nodeGraph->addNode("standard_surface", "surface1", "surfaceshader");
+    surface->setConnectedNode("base_color", image);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+    output->setConnectedNode(surface);
+
+    // Generate with a new context for each shader, as when generating
+    // in batches, and count the shader graphs created from the document.
+    // The order of function definitions may differ between contexts.
+    auto generate = [&](mx::ShaderGraphCachePtr cache, int optimizationLevel, size_t& numGraphs)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().optimizationLevel = optimizationLevel;
+        context.setGraphCache(cache);
+        mx::GenProfilerPtr profiler = mx::GenProfiler::create();
+        context.setProfiler(profiler);
+        mx::ShaderPtr shader = context.getShaderGenerator().generate("graph_cache", output, context);
+        REQUIRE(shader != nullptr);
+        numGraphs = profiler->getCounters().at("ShaderGraph");
+        return getSortedLines(shader->getSourceCode(mx::Stage::PIXEL));
+    };
+
+    size_t numReference = 0;
+    const std::vector<std::string> referenceCode = generate(nullptr, 1, numReference);
+
+    // The first use of the cache creates all graphs and stores templates
+    // for the nodegraphs, which are reused by the following contexts.
+    mx::ShaderGraphCachePtr cache = mx::ShaderGraphCache::create();
+    size_t numFirst = 0;
+    REQUIRE(generate(cache, 1, numFirst) == referenceCode);
+    REQUIRE(numFirst == numReference);
+    const size_t numTemplates = cache->numGraphs();
+    REQUIRE(numTemplates > 0);
+
+    size_t numCached = 0;
+    REQUIRE(generate(cache, 1, numCached) == referenceCode);
+    REQUIRE(numCached == numReference - numTemplates);
+    REQUIRE(cache->numGraphs() == numTemplates);
+
+    // Templates are not shared between different generation options.
+    size_t numOptimized = 0;
+    const std::vector<std::string> optimizedCode = generate(nullptr, 2, numOptimized);
+    REQUIRE(generate(cache, 2, numOptimized) == optimizedCode);
+    REQUIRE(cache->numGraphs() > numTemplates);
+
+    std::ofstream logFile("genglsl_glsl400_graph_cache.txt");
+    logFile << "Shader graphs created: " << numReference << " without a cache, "
+            << numCached << " with " << numTemplates << " cached templates" << std::endl;
+}
+
+TEST_CASE("GenShader: GLSL Generation Arena", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_arena");
+    mx::NodePtr image = nodeGraph->addNode("tiledimage", "tiledimage1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr surface = nodeGraph->addNode("standard_surface", "surface1", "surfaceshader");
+    surface->setConnectedNode("base_color", image);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+    output->setConnectedNode(surface);
+
+    // Generate a batch of shaders with a new context for each shader,
+    // optionally allocating all shader graphs from a single arena.
+    const size_t numShaders = 20;
+    auto generate = [&](mx::GenArenaPtr arena, std::vector<mx::ShaderPtr>& shaders)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numShaders; i++)
+        {
+            mx::GenContext context(mx::GlslShaderGenerator::create());
+            context.registerSourceCodeSearchPath(searchPath);
+            context.setArena(arena);
+            shaders.push_back(context.getShaderGenerator().generate("arena", output, context));
+            REQUIRE(shaders.back() != nullptr);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    std::vector<mx::ShaderPtr> referenceShaders;
+    const double referenceTime = generate(nullptr, referenceShaders);
+
+    mx::GenArenaPtr arena = mx::GenArena::create();
+    std::vector<mx::ShaderPtr> arenaShaders;
+    const double arenaTime = generate(arena, arenaShaders);
+    REQUIRE(getSortedLines(arenaShaders[0]->getSourceCode(mx::Stage::PIXEL)) ==
+            getSortedLines(referenceShaders[0]->getSourceCode(mx::Stage::PIXEL)));
+    REQUIRE(arena->numAllocations() > 0);
+    REQUIRE(arena->numBlocks() * 100 < arena->numAllocations());
+
+    std::ofstream logFile("genglsl_glsl400_arena.txt");
+    logFile << numShaders << " shaders: " << referenceTime << " seconds with heap allocation, " << arenaTime
+            << " seconds with " << arena->numAllocations() << " allocations (" << arena->numBytes()
+            << " bytes) made from " << arena->numBlocks() << " arena blocks" << std::endl;
+
+    // The arena is kept alive by the shader graphs allocated from it.
+    std::weak_ptr<mx::GenArena> arenaRef = arena;
+    arena = nullptr;
+    REQUIRE(!arenaRef.expired());
+    REQUIRE(arenaShaders.back()->getGraph().getOutputSocket()->getConnection() != nullptr);
+    arenaShaders.clear();
+    REQUIRE(arenaRef.expired());
+
+    // A graph cache shared by generations using different arenas allocates
+    // the graphs copied from its templates from the arena of each generation,
+    // and does not keep the arena of the first generation alive.
+    mx::ShaderGraphCachePtr cache = mx::ShaderGraphCache::create();
+    auto generateCached = [&](mx::GenArenaPtr cacheArena)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        context.setArena(cacheArena);
+        context.setGraphCache(cache);
+        mx::ShaderPtr shader = context.getShaderGenerator().generate("arena", output, context);
+        REQUIRE(shader != nullptr);
+        return shader;
+    };
+
+    mx::GenArenaPtr firstArena = mx::GenArena::create();
+    mx::ShaderPtr firstShader = generateCached(firstArena);
+    REQUIRE(cache->numGraphs() > 0);
+    std::weak_ptr<mx::GenArena> firstArenaRef = firstArena;
+    firstArena = nullptr;
+    firstShader = nullptr;
+    REQUIRE(firstArenaRef.expired());
+
+    mx::GenArenaPtr secondArena = mx::GenArena::create();
+    mx::ShaderPtr secondShader = generateCached(secondArena);
+    REQUIRE(cache->numHits() > 0);
+    REQUIRE(secondArena->numAllocations() > 0);
+    REQUIRE(getSortedLines(secondShader->getSourceCode(mx::Stage::PIXEL)) ==
+            getSortedLines(referenceShaders[0]->getSourceCode(mx::Stage::PIXEL)));
+    std::weak_ptr<mx::GenArena> secondArenaRef = secondArena;
+    secondArena = nullptr;
+    secondShader = nullptr;
+    REQUIRE(secondArenaRef.expired());
+}
+
 static void generateGlslCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
@@ -135,6 +1154,131 @@ static void generateGlslCode()
     tester.validate(genOptions, optionsFilePath);
 }
 
+TEST_CASE("GenShader: GLSL Shader Reflection", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    GenShaderUtil::loadLibrary(searchPath / mx::FilePath("bxdf/standard_surface.mtlx"), doc);
+    std::ofstream logFile("genglsl_glsl400_shader_reflection.txt");
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_reflection");
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr surface = nodeGraph->addNode("standard_surface", "surface1", "surfaceshader");
+    surface->setConnectedNode("base_color", image);
+    mx::NodePtr controlImage = nodeGraph->addNode("image", "image2", "color3");
+    controlImage->setParameterValue("file", std::string("grid\t\"2\"\n\x01.png"), mx::FILENAME_TYPE_STRING);
+    surface->setConnectedNode("specular_color", controlImage);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "surfaceshader");
+    output->setConnectedNode(surface);
+
+    const unsigned int numLights = 3;
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().hwMaxActiveLightSources = numLights;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("reflection", output, context);
+    REQUIRE(shader != nullptr);
+
+    mx::GlslShaderReflectionPtr reflection = mx::GlslShaderReflection::create(*shader, context);
+    const std::string json = reflection->asJson();
+    logFile << json;
+    REQUIRE(json.find("\"uniformBlocks\"") != std::string::npos);
+
+    // Quotes and control characters in strings are escaped.
+    REQUIRE(json.find("grid\\t\\\"2\\\"\\n\\u0001.png") != std::string::npos);
+    bool hasControlCharacter = false;
+    for (char c : json)
+    {
+        if (static_cast<unsigned char>(c) < 0x20 && c != '\n')
+        {
+            hasControlCharacter = true;
+        }
+    }
+    REQUIRE(!hasControlCharacter);
+
+    // Check the std140 rules for the base types.
+    size_t size = 0, alignment = 0, arraySize = 0;
+    REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::Type::FLOAT, nullptr, size, alignment, arraySize));
+    REQUIRE((size == 4 && alignment == 4 && arraySize == 0));
+    REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::Type::VECTOR2, nullptr, size, alignment, arraySize));
+    REQUIRE((size == 8 && alignment == 8));
+    REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::Type::COLOR3, nullptr, size, alignment, arraySize));
+    REQUIRE((size == 12 && alignment == 16));
+    REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::Type::MATRIX33, nullptr, size, alignment, arraySize));
+    REQUIRE((size == 48 && alignment == 16));
+    mx::ValuePtr arrayValue = mx::Value::createValue(std::vector<float>{ 1.0f, 2.0f, 3.0f });
+    REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::Type::FLOATARRAY, arrayValue, size, alignment, arraySize));
+    REQUIRE((size == 48 && alignment == 16 && arraySize == 3));
+    REQUIRE(!mx::GlslShaderReflection::getStd140Layout(mx::Type::SURFACESHADER, nullptr, size, alignment, arraySize));
+
+    // Uniforms must be laid out in order without overlaps, and be
+    // declared in the source code of their stage.
+    bool foundLightData = false;
+    for (const mx::GlslShaderReflection::UniformBlock& block : reflection->getUniformBlocks())
+    {
+        const std::string& code = shader->getSourceCode(block.stage);
+        size_t end = 0;
+        for (const mx::GlslShaderReflection::Uniform& uniform : block.uniforms)
+        {
+            REQUIRE(code.find(" " + uniform.name) != std::string::npos);
+            REQUIRE(uniform.offset != mx::GlslShaderReflection::INVALID_OFFSET);
+            REQUIRE(mx::GlslShaderReflection::getStd140Layout(mx::TypeDesc::get(uniform.type), nullptr, size, alignment, arraySize));
+            REQUIRE(uniform.offset % alignment == 0);
+            REQUIRE(uniform.offset >= end);
+            end = uniform.offset + uniform.size;
+        }
+        REQUIRE(block.size >= end);
+        REQUIRE(block.size % 16 == 0);
+        if (block.name == mx::HW::LIGHT_DATA)
+        {
+            REQUIRE(block.stage == mx::Stage::PIXEL);
+            REQUIRE(block.arraySize == numLights);
+            foundLightData = true;
+        }
+    }
+    REQUIRE(foundLightData);
+
+    const mx::GlslShaderReflection::Uniform* worldMatrix = reflection->findUniform(mx::Stage::VERTEX, "u_worldMatrix");
+    REQUIRE(worldMatrix != nullptr);
+    REQUIRE(worldMatrix->type == "matrix44");
+    REQUIRE(worldMatrix->size == 64);
+
+    // Uniforms published from the graph record the path of their input.
+    bool foundPath = false;
+    for (const mx::GlslShaderReflection::UniformBlock& block : reflection->getUniformBlocks())
+    {
+        for (const mx::GlslShaderReflection::Uniform& uniform : block.uniforms)
+        {
+            foundPath = foundPath || uniform.path == "NG_reflection/surface1/metalness";
+        }
+    }
+    REQUIRE(foundPath);
+
+    const std::vector<mx::GlslShaderReflection::Texture>& textures = reflection->getTextures();
+    size_t numImages = 0;
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        REQUIRE(textures[i].unit == i);
+        REQUIRE(shader->getSourceCode(textures[i].stage).find("uniform sampler2D " + textures[i].name) != std::string::npos);
+        if (textures[i].value == "resources/Images/grid.png")
+        {
+            REQUIRE(textures[i].path == "NG_reflection/image1/file");
+            numImages++;
+        }
+    }
+    REQUIRE(numImages == 1);
+
+    const std::vector<mx::GlslShaderReflection::VertexInput>& vertexInputs = reflection->getVertexInputs();
+    REQUIRE(!vertexInputs.empty());
+    for (size_t i = 0; i < vertexInputs.size(); i++)
+    {
+        REQUIRE(vertexInputs[i].location == i);
+        REQUIRE(shader->getSourceCode(mx::Stage::VERTEX).find("in " + mx::GlslSyntax::create()->getTypeName(mx::TypeDesc::get(vertexInputs[i].type)) + " " + vertexInputs[i].name) != std::string::npos);
+    }
+}
+
 TEST_CASE("GenShader: GLSL Shader Generation", "[genglsl]")
 {
     generateGlslCode();
@@ -16,8 +16,11 @@
 
 #include <MaterialXGenShader/DefaultColorManagementSystem.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <fstream>
+
 
 namespace mx = MaterialX;
 
@@ -110,6 +113,72 @@ TEST_CASE("GenShader: OSL Unique Names", "[genosl]")
     GenShaderUtil::testUniqueNames(context, mx::Stage::PIXEL);
 }
 
+TEST_CASE("GenShader: OSL Baked Uniforms", "[genosl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+
+    // Create a graph with a conditional controlled by an interface input,
+    // which is constant once the value of the input is known.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_baked");
+    nodeGraph->addInput("threshold", "float")->setValue(0.8f);
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", image);
+    multiply->setInputValue("in2", mx::Color3(0.25f, 0.5f, 0.75f));
+    mx::NodePtr compare = nodeGraph->addNode("compare", "compare1", "color3");
+    compare->addInput("intest", "float")->setInterfaceName("threshold");
+    compare->setParameterValue("cutoff", 0.5f);
+    compare->setConnectedNode("in1", image);
+    compare->setConnectedNode("in2", multiply);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(compare);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+    std::ofstream logFile("genosl_vanilla_baked_uniforms.txt");
+
+    auto generate = [&](bool bakeUniforms, const mx::StringSet& bakedUniformNames)
+    {
+        context.getOptions().bakeUniforms = bakeUniforms;
+        context.getOptions().bakedUniformNames = bakedUniformNames;
+        mx::ShaderPtr shader = context.getShaderGenerator().generate("baked", output, context);
+        REQUIRE(shader != nullptr);
+        logFile << shader->getSourceCode() << std::endl;
+        return shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::OSL::UNIFORMS);
+    };
+
+    // With uniforms the conditional is evaluated at runtime.
+    const mx::VariableBlock& uniforms = generate(false, {});
+    REQUIRE(uniforms.find("threshold") != nullptr);
+    REQUIRE(uniforms.find("multiply1_in2") != nullptr);
+    REQUIRE(uniforms.find("image1_file") != nullptr);
+
+    // Baking all uniforms removes the conditional and the branch not taken,
+    // but keeps the filename uniform.
+    context.getOptions().bakeUniforms = true;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("baked", output, context);
+    REQUIRE(shader != nullptr);
+    const std::string bakedCode = shader->getSourceCode();
+    logFile << bakedCode << std::endl;
+    const mx::VariableBlock& bakedUniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::OSL::UNIFORMS);
+    REQUIRE(bakedUniforms.find("threshold") == nullptr);
+    REQUIRE(bakedUniforms.find("multiply1_in2") == nullptr);
+    REQUIRE(bakedUniforms.find("image1_file") != nullptr);
+    REQUIRE(bakedCode.find("compare1_out") == std::string::npos);
+    REQUIRE(bakedCode.find("color(0.25, 0.5, 0.75)") != std::string::npos);
+
+    // Baking selected uniforms keeps the others.
+    const mx::VariableBlock& selectedUniforms = generate(true, { "threshold" });
+    REQUIRE(selectedUniforms.find("threshold") == nullptr);
+    REQUIRE(selectedUniforms.find("multiply1_in2") != nullptr);
+    REQUIRE(selectedUniforms.find("image1_file") != nullptr);
+}
+
 static void generateOslCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
@@ -12,12 +12,15 @@
 #include <MaterialXFormat/File.h>
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Nodes/ConvolutionNode.h>
 #include <MaterialXGenShader/Nodes/SwizzleNode.h>
 #include <MaterialXGenShader/TypeDesc.h>
 #include <MaterialXGenShader/Util.h>
 
 #include <MaterialXTest/GenShaderUtil.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -196,3 +199,87 @@ TEST_CASE("GenShader: OSL Reference Implementation Check", "[genshader]")
     // To enable once this is true
     //REQUIRE(missing == 0);
 }
+
+TEST_CASE("GenShader: Separable Convolution Samples", "[genshader]")
+{
+    // Create a texture with random texel values, which
+    // is linearly interpolated between the texels.
+    const int size = 32;
+    std::vector<float> texels(size * size);
+    std::srand(1);
+    for (float& texel : texels)
+    {
+        texel = float(std::rand()) / float(RAND_MAX);
+    }
+    auto sampleTexture = [&texels](float x, float y) -> float
+    {
+        const int x0 = int(std::floor(x));
+        const int y0 = int(std::floor(y));
+        const float fx = x - float(x0);
+        const float fy = y - float(y0);
+        auto texel = [&texels](int i, int j) { return texels[j * size + i]; };
+        return (1.0f - fy) * ((1.0f - fx) * texel(x0, y0) + fx * texel(x0 + 1, y0)) +
+               fy * ((1.0f - fx) * texel(x0, y0 + 1) + fx * texel(x0 + 1, y0 + 1));
+    };
+
+    // Return the largest difference between filtering with the given samples,
+    // spaced by the given number of texels and offset from the texel centers.
+    auto maxDifference = [&sampleTexture](const std::vector<float>& offsets, const std::vector<float>& weights,
+                                          const std::vector<float>& mergedOffsets, const std::vector<float>& mergedWeights,
+                                          float spacing, float centerOffset)
+    {
+        auto filter = [&](const std::vector<float>& sampleOffsets, const std::vector<float>& sampleWeights, float x, float y)
+        {
+            float result = 0.0f;
+            for (size_t row = 0; row < sampleOffsets.size(); row++)
+            {
+                for (size_t col = 0; col < sampleOffsets.size(); col++)
+                {
+                    result += sampleWeights[row] * sampleWeights[col] *
+                              sampleTexture(x + sampleOffsets[col] * spacing, y + sampleOffsets[row] * spacing);
+                }
+            }
+            return result;
+        };
+        float difference = 0.0f;
+        for (int y = 8; y < size - 8; y++)
+        {
+            for (int x = 8; x < size - 8; x++)
+            {
+                const float cx = float(x) + centerOffset;
+                const float cy = float(y) + centerOffset;
+                difference = std::max(difference, std::abs(filter(offsets, weights, cx, cy) -
+                                                           filter(mergedOffsets, mergedWeights, cx, cy)));
+            }
+        }
+        return difference;
+    };
+
+    for (unsigned int filterWidth : { 3u, 5u, 7u })
+    {
+        std::vector<float> gaussianWeights;
+        mx::ConvolutionNode::getGaussianWeights(filterWidth, gaussianWeights);
+        REQUIRE(gaussianWeights.size() == filterWidth);
+        const std::vector<float> boxWeights(filterWidth, 1.0f / float(filterWidth));
+
+        for (const std::vector<float>& weights : { gaussianWeights, boxWeights })
+        {
+            std::vector<float> offsets, sampleWeights;
+            std::vector<float> mergedOffsets, mergedWeights;
+            mx::ConvolutionNode::computeSeparableSamples(weights, false, offsets, sampleWeights);
+            mx::ConvolutionNode::computeSeparableSamples(weights, true, mergedOffsets, mergedWeights);
+            REQUIRE(offsets.size() == filterWidth);
+            REQUIRE(mergedOffsets.size() == (filterWidth + 1) / 2);
+
+            // The merged samples match the full kernel when samples are one
+            // texel apart and centered on texels.
+            REQUIRE(maxDifference(offsets, sampleWeights, mergedOffsets, mergedWeights, 1.0f, 0.0f) < 1e-5f);
+
+            // They don't otherwise, which is why generated shaders check
+            // the sample spacing at runtime before using them.
+            REQUIRE(maxDifference(offsets, sampleWeights, mergedOffsets, mergedWeights, 1.5f, 0.0f) > 1e-3f);
+            REQUIRE(maxDifference(offsets, sampleWeights, mergedOffsets, mergedWeights, 2.0f, 0.0f) > 1e-3f);
+            REQUIRE(maxDifference(offsets, sampleWeights, mergedOffsets, mergedWeights, 1.0f, 0.5f) > 1e-3f);
+        }
+    }
+}
@@ -12,6 +12,8 @@
 
 #include <MaterialXFormat/File.h>
 
+#include <chrono>
+
 namespace mx = MaterialX;
 
 namespace GenShaderUtil
@@ -593,9 +595,18 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
     context.getOptions() = generateOptions;
     context.registerSourceCodeSearchPath(_srcSearchPath);
 
+    // Allocate the shader graphs for each document from an arena,
+    // and record the allocations and total generation time.
+    size_t numArenaAllocations = 0;
+    size_t numArenaBlocks = 0;
+    double generationTime = 0.0;
+
     size_t documentIndex = 0;
     for (auto doc : _documents)
     {
+        mx::GenArenaPtr arena = mx::GenArena::create();
+        context.setArena(arena);
+
         // Add in dependent libraries
         doc->importLibrary(_dependLib);
 
@@ -675,7 +686,9 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
 
                     _logFile << "------------ Run validation with element: " << namePath << "------------" << std::endl;
                     mx::StringVec sourceCode;
+                    auto startTime = std::chrono::steady_clock::now();
                     bool generatedCode = generateCode(context, elementName, element, _logFile, _testStages, sourceCode);
+                    generationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
                     if (!generatedCode)
                     {
                         _logFile << ">> Failed to generate code for nodedef: " << nodeDefName << std::endl;
@@ -698,7 +711,15 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
         CHECK(missingNodeDefs == 0);
         CHECK(missingImplementations == 0);
         CHECK(codeGenerationFailures == 0);
+
+        numArenaAllocations += arena->numAllocations();
+        numArenaBlocks += arena->numBlocks();
     }
+    context.setArena(nullptr);
+
+    _logFile << "---------------------------------------------------" << std::endl;
+    _logFile << "Generation time: " << generationTime << " seconds, with " << numArenaAllocations
+             << " graph allocations made from " << numArenaBlocks << " arena blocks" << std::endl;
 
     if (options.checkImplCount)
     {
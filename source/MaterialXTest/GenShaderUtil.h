@@ -89,10 +89,10 @@ class TestSuiteOptions
     // Check the count of number of implementations used
     bool checkImplCount = true;
 
-    // Run using a set of interfaces:
-    // - 3 = run complete + reduced.
-    // - 2 = run complete only (default)
-    // - 1 = run reduced only.
+    // Run using a set of interfaces, combining:
+    // - 1 = run reduced.
+    // - 2 = run complete (default)
+    // - 4 = run complete with all uniforms baked into constants.
     int shaderInterfaces = 2;
 
     // Validate element before attempting to generate code. Default is false.
@@ -26,12 +26,19 @@
 
 #include <MaterialXRender/GeometryHandler.h>
 #include <MaterialXRender/TinyObjLoader.h>
+#include <MaterialXRender/UdimTileSet.h>
 
+#include <array>
 #include <fstream>
 #include <iostream>
 #include <unordered_set>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <ctime>
+#include <limits>
+#include <random>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -154,6 +161,633 @@ void testImageHandler(ImageHandlerTestOptions& options)
     CHECK(loadFailed == 0);
 }
 
+TEST_CASE("Render: OBJ Vertex Welding", "[rendercore]")
+{
+    std::ofstream logFile("render_obj_welding_test.txt");
+
+    // Welded meshes have the same faces as meshes with a vertex per face corner.
+    mx::TinyObjLoaderPtr loader = mx::TinyObjLoader::create();
+    REQUIRE(loader->getWeldVertices());
+    const mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry");
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        mx::MeshList weldedList;
+        mx::MeshList cornerList;
+        loader->setWeldVertices(true);
+        REQUIRE(loader->load(geomPath / file, weldedList));
+        loader->setWeldVertices(false);
+        REQUIRE(loader->load(geomPath / file, cornerList));
+        mx::MeshPtr welded = weldedList[0];
+        mx::MeshPtr corners = cornerList[0];
+        REQUIRE(welded->getPartitionCount() == corners->getPartitionCount());
+        REQUIRE(welded->getVertexCount() < corners->getVertexCount());
+        REQUIRE(welded->getMinimumBounds() == corners->getMinimumBounds());
+        REQUIRE(welded->getMaximumBounds() == corners->getMaximumBounds());
+
+        size_t mismatches = 0;
+        for (const std::string& attribute : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE,
+                                              mx::MeshStream::TEXCOORD_ATTRIBUTE })
+        {
+            mx::MeshStreamPtr weldedStream = welded->getStream(attribute, 0);
+            mx::MeshStreamPtr cornerStream = corners->getStream(attribute, 0);
+            REQUIRE(weldedStream->getData().size() == welded->getVertexCount() * weldedStream->getStride());
+            const unsigned int stride = weldedStream->getStride();
+            for (size_t p = 0; p < welded->getPartitionCount(); p++)
+            {
+                const mx::MeshIndexBuffer& weldedIndices = welded->getPartition(p)->getIndices();
+                const mx::MeshIndexBuffer& cornerIndices = corners->getPartition(p)->getIndices();
+                REQUIRE(weldedIndices.size() == cornerIndices.size());
+                for (size_t i = 0; i < weldedIndices.size(); i++)
+                {
+                    const float* weldedValue = &weldedStream->getData()[weldedIndices[i] * stride];
+                    const float* cornerValue = &cornerStream->getData()[cornerIndices[i] * stride];
+                    if (!std::equal(weldedValue, weldedValue + stride, cornerValue))
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        REQUIRE(mismatches == 0);
+        logFile << file.asString() << ": " << welded->getVertexCount() << " welded vertices, "
+                << corners->getVertexCount() << " face corners" << std::endl;
+    }
+
+    // Time the loading of a grid of twenty thousand triangles.
+    const unsigned int GRID_SIZE = 100;
+    const mx::FilePath gridPath = mx::FilePath::getCurrentPath() / mx::FilePath("render_obj_welding_grid.obj");
+    {
+        std::ofstream gridFile(gridPath.asString());
+        gridFile << "vn 0 0 1\n";
+        for (unsigned int y = 0; y <= GRID_SIZE; y++)
+        {
+            for (unsigned int x = 0; x <= GRID_SIZE; x++)
+            {
+                const float u = float(x) / GRID_SIZE;
+                const float v = float(y) / GRID_SIZE;
+                gridFile << "v " << u << " " << v << " 0\nvt " << u << " " << v << "\n";
+            }
+        }
+        for (unsigned int y = 0; y < GRID_SIZE; y++)
+        {
+            for (unsigned int x = 0; x < GRID_SIZE; x++)
+            {
+                const unsigned int i = y * (GRID_SIZE + 1) + x + 1;
+                const unsigned int corners[] = { i, i + 1, i + GRID_SIZE + 2, i + GRID_SIZE + 1 };
+                gridFile << "f";
+                for (unsigned int corner : corners)
+                {
+                    gridFile << " " << corner << "/" << corner << "/1";
+                }
+                gridFile << "\n";
+            }
+        }
+    }
+    for (bool weld : { false, true })
+    {
+        loader->setWeldVertices(weld);
+        mx::MeshList meshList;
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(loader->load(gridPath, meshList));
+        const double loadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        mx::MeshPtr mesh = meshList[0];
+        REQUIRE(mesh->getPartition(0)->getFaceCount() == 2 * GRID_SIZE * GRID_SIZE);
+        REQUIRE(mesh->getVertexCount() == (weld ? (GRID_SIZE + 1) * (GRID_SIZE + 1) : 6 * GRID_SIZE * GRID_SIZE));
+        size_t streamBytes = 0;
+        for (const std::string& attribute : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE,
+                                              mx::MeshStream::TEXCOORD_ATTRIBUTE, mx::MeshStream::TANGENT_ATTRIBUTE,
+                                              mx::MeshStream::BITANGENT_ATTRIBUTE })
+        {
+            streamBytes += mesh->getStream(attribute, 0)->getData().size() * sizeof(float);
+        }
+        logFile << "Grid of " << mesh->getPartition(0)->getFaceCount() << " triangles " << (weld ? "with" : "without")
+                << " welding: " << mesh->getVertexCount() << " vertices, " << streamBytes << " bytes of vertex streams, loaded in "
+                << loadTime << " seconds" << std::endl;
+    }
+    std::remove(gridPath.asString().c_str());
+}
+
+TEST_CASE("Render: OBJ Parallel Loading", "[rendercore]")
+{
+    std::ofstream logFile("render_obj_parallel_test.txt");
+
+    const unsigned int THREAD_COUNT = 4;
+    mx::TinyObjLoaderPtr serialLoader = mx::TinyObjLoader::create();
+    serialLoader->setThreadCount(1);
+    mx::TinyObjLoaderPtr parallelLoader = mx::TinyObjLoader::create();
+    parallelLoader->setThreadCount(THREAD_COUNT);
+
+    // Meshes loaded in parallel are identical to meshes loaded serially.
+    auto compareMeshes = [](mx::MeshPtr serial, mx::MeshPtr parallel)
+    {
+        REQUIRE(serial->getVertexCount() == parallel->getVertexCount());
+        REQUIRE(serial->getPartitionCount() == parallel->getPartitionCount());
+        REQUIRE(serial->getMinimumBounds() == parallel->getMinimumBounds());
+        REQUIRE(serial->getMaximumBounds() == parallel->getMaximumBounds());
+        for (size_t p = 0; p < serial->getPartitionCount(); p++)
+        {
+            REQUIRE(serial->getPartition(p)->getIdentifier() == parallel->getPartition(p)->getIdentifier());
+            REQUIRE(serial->getPartition(p)->getIndices() == parallel->getPartition(p)->getIndices());
+        }
+        for (const std::string& attribute : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE,
+                                              mx::MeshStream::TEXCOORD_ATTRIBUTE, mx::MeshStream::TANGENT_ATTRIBUTE,
+                                              mx::MeshStream::BITANGENT_ATTRIBUTE })
+        {
+            const mx::MeshFloatBuffer& serialData = serial->getStream(attribute, 0)->getData();
+            const mx::MeshFloatBuffer& parallelData = parallel->getStream(attribute, 0)->getData();
+            REQUIRE(serialData.size() == parallelData.size());
+            REQUIRE(std::memcmp(serialData.data(), parallelData.data(), serialData.size() * sizeof(float)) == 0);
+        }
+    };
+
+    const mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry");
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        mx::MeshList serialList;
+        mx::MeshList parallelList;
+        REQUIRE(serialLoader->load(geomPath / file, serialList));
+        REQUIRE(parallelLoader->load(geomPath / file, parallelList));
+        compareMeshes(serialList[0], parallelList[0]);
+        logFile << file.asString() << ": " << parallelList[0]->getPartitionCount() << " partitions, "
+                << parallelList[0]->getVertexCount() << " vertices" << std::endl;
+    }
+
+    // Write a grid spanning many chunks, with objects and groups, quads with
+    // absolute and relative indices, triangles, comments and mixed line endings.
+    const unsigned int GRID_SIZE = 400;
+    const unsigned int ROWS_PER_GROUP = 50;
+    const mx::FilePath gridPath = mx::FilePath::getCurrentPath() / mx::FilePath("render_obj_parallel_grid.obj");
+    {
+        std::ofstream gridFile(gridPath.asString(), std::ios::binary);
+        gridFile << "# Parallel loading test\r\no grid\r\nvn 0 0 1\n";
+        for (unsigned int y = 0; y <= GRID_SIZE; y++)
+        {
+            for (unsigned int x = 0; x <= GRID_SIZE; x++)
+            {
+                const float u = float(x) / GRID_SIZE;
+                const float v = float(y) / GRID_SIZE;
+                gridFile << "v " << u << " " << v << " " << u * v << (y % 2 ? "\r\n" : "\n")
+                         << "vt " << u << " " << v << "\n";
+            }
+        }
+        const int vertexCount = int((GRID_SIZE + 1) * (GRID_SIZE + 1));
+        for (unsigned int y = 0; y < GRID_SIZE; y++)
+        {
+            if (y % ROWS_PER_GROUP == 0)
+            {
+                gridFile << "g row " << y << "\n";
+            }
+            for (unsigned int x = 0; x < GRID_SIZE; x++)
+            {
+                const int i = int(y * (GRID_SIZE + 1) + x + 1);
+                const int corners[] = { i, i + 1, i + int(GRID_SIZE) + 2, i + int(GRID_SIZE) + 1 };
+                if (x % 8 == 7)
+                {
+                    gridFile << "f " << corners[0] << "/" << corners[0] << "/1 " << corners[1] << "/" << corners[1] << "/1 "
+                             << corners[2] << "/" << corners[2] << "/1\n";
+                    gridFile << "f " << corners[0] << "//1 " << corners[2] << "//1 " << corners[3] << "//1\n";
+                    continue;
+                }
+                gridFile << "f";
+                for (int corner : corners)
+                {
+                    const int index = (y % 2) ? corner - vertexCount - 1 : corner;
+                    gridFile << " " << index << "/" << index << "/-1";
+                }
+                gridFile << "\n";
+            }
+        }
+        gridFile << "o empty\ng\n";
+    }
+    const size_t fileSize = std::ifstream(gridPath.asString(), std::ios::binary | std::ios::ate).tellg();
+
+    double loadTimes[2] = { 0.0, 0.0 };
+    mx::MeshList gridLists[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        mx::TinyObjLoaderPtr loader = i ? parallelLoader : serialLoader;
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(loader->load(gridPath, gridLists[i]));
+        loadTimes[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    mx::MeshPtr gridMesh = gridLists[1][0];
+    REQUIRE(gridMesh->getPartitionCount() == GRID_SIZE / ROWS_PER_GROUP);
+    REQUIRE(gridMesh->getPartition(1)->getIdentifier() == "row " + std::to_string(ROWS_PER_GROUP));
+    REQUIRE(gridMesh->getPartition(0)->getFaceCount() == 2 * GRID_SIZE * ROWS_PER_GROUP);
+    compareMeshes(gridLists[0][0], gridMesh);
+    std::remove(gridPath.asString().c_str());
+
+    const double megabytes = double(fileSize) / (1024.0 * 1024.0);
+    logFile << "Grid of " << fileSize << " bytes loaded serially in " << loadTimes[0] << " seconds ("
+            << megabytes / loadTimes[0] << " MB/s), and with " << THREAD_COUNT << " threads in "
+            << loadTimes[1] << " seconds (" << megabytes / loadTimes[1] << " MB/s) on "
+            << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+}
+
+TEST_CASE("Render: Mesh Cache", "[rendercore]")
+{
+    std::ofstream logFile("render_mesh_cache_test.txt");
+
+    const mx::FilePath cacheDirectory = mx::FilePath::getCurrentPath() / mx::FilePath("render_mesh_cache");
+    if (cacheDirectory.exists())
+    {
+        for (const mx::FilePath& file : cacheDirectory.getFilesInDirectory(mx::MeshCache::EXTENSION))
+        {
+            std::remove((cacheDirectory / file).asString().c_str());
+        }
+    }
+    mx::MeshCachePtr cache = mx::MeshCache::create(cacheDirectory);
+
+    auto createHandler = [cache]()
+    {
+        mx::GeometryHandlerPtr handler = mx::GeometryHandler::create();
+        handler->addLoader(mx::TinyObjLoader::create());
+        handler->setMeshCache(cache);
+        return handler;
+    };
+
+    // Cached meshes are identical to loaded meshes.
+    auto compareMeshes = [](mx::MeshPtr loaded, mx::MeshPtr cached)
+    {
+        REQUIRE(loaded->getIdentifier() == cached->getIdentifier());
+        REQUIRE(loaded->getSourceUri() == cached->getSourceUri());
+        REQUIRE(loaded->getVertexCount() == cached->getVertexCount());
+        REQUIRE(loaded->getMinimumBounds() == cached->getMinimumBounds());
+        REQUIRE(loaded->getMaximumBounds() == cached->getMaximumBounds());
+        REQUIRE(loaded->getSphereCenter() == cached->getSphereCenter());
+        REQUIRE(loaded->getSphereRadius() == cached->getSphereRadius());
+        REQUIRE(loaded->getStreams().size() == cached->getStreams().size());
+        for (size_t i = 0; i < loaded->getStreams().size(); i++)
+        {
+            mx::MeshStreamPtr loadedStream = loaded->getStreams()[i];
+            mx::MeshStreamPtr cachedStream = cached->getStreams()[i];
+            REQUIRE(loadedStream->getName() == cachedStream->getName());
+            REQUIRE(loadedStream->getType() == cachedStream->getType());
+            REQUIRE(loadedStream->getIndex() == cachedStream->getIndex());
+            REQUIRE(loadedStream->getStride() == cachedStream->getStride());
+            const bool dataMatches = loadedStream->getData() == cachedStream->getData();
+            REQUIRE(dataMatches);
+        }
+        REQUIRE(loaded->getPartitionCount() == cached->getPartitionCount());
+        for (size_t i = 0; i < loaded->getPartitionCount(); i++)
+        {
+            REQUIRE(loaded->getPartition(i)->getIdentifier() == cached->getPartition(i)->getIdentifier());
+            REQUIRE(loaded->getPartition(i)->getFaceCount() == cached->getPartition(i)->getFaceCount());
+            const bool indicesMatch = loaded->getPartition(i)->getIndices() == cached->getPartition(i)->getIndices();
+            REQUIRE(indicesMatch);
+        }
+    };
+
+    const mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry");
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        mx::GeometryHandlerPtr coldHandler = createHandler();
+        REQUIRE(coldHandler->loadGeometry(geomPath / file));
+        mx::GeometryHandlerPtr warmHandler = createHandler();
+        REQUIRE(warmHandler->loadGeometry(geomPath / file));
+        REQUIRE(warmHandler->hasGeometry(geomPath / file));
+        REQUIRE(warmHandler->getMinimumBounds() == coldHandler->getMinimumBounds());
+        REQUIRE(warmHandler->getMaximumBounds() == coldHandler->getMaximumBounds());
+        compareMeshes(coldHandler->getMeshes()[0], warmHandler->getMeshes()[0]);
+    }
+    const size_t fileCount = geomPath.getFilesInDirectory("obj").size();
+    REQUIRE(cache->getStatistics().misses == fileCount);
+    REQUIRE(cache->getStatistics().writes == fileCount);
+    REQUIRE(cache->getStatistics().hits == fileCount);
+
+    // Write a grid, and benchmark cold and warm loads.
+    const unsigned int GRID_SIZE = 400;
+    const mx::FilePath gridPath = mx::FilePath::getCurrentPath() / mx::FilePath("render_mesh_cache_grid.obj");
+    auto writeGrid = [&gridPath](unsigned int gridSize)
+    {
+        std::ofstream gridFile(gridPath.asString());
+        for (unsigned int y = 0; y <= gridSize; y++)
+        {
+            for (unsigned int x = 0; x <= gridSize; x++)
+            {
+                const float u = float(x) / gridSize;
+                const float v = float(y) / gridSize;
+                gridFile << "v " << u << " " << v << " " << u * v << "\nvt " << u << " " << v << "\n";
+            }
+        }
+        for (unsigned int y = 0; y < gridSize; y++)
+        {
+            for (unsigned int x = 0; x < gridSize; x++)
+            {
+                const unsigned int i = y * (gridSize + 1) + x + 1;
+                gridFile << "f " << i << "/" << i << " " << i + 1 << "/" << i + 1 << " "
+                         << i + gridSize + 2 << "/" << i + gridSize + 2 << " "
+                         << i + gridSize + 1 << "/" << i + gridSize + 1 << "\n";
+            }
+        }
+    };
+    writeGrid(GRID_SIZE);
+
+    cache->resetStatistics();
+    double loadTimes[2] = { 0.0, 0.0 };
+    mx::GeometryHandlerPtr gridHandlers[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        gridHandlers[i] = createHandler();
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(gridHandlers[i]->loadGeometry(gridPath));
+        loadTimes[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    REQUIRE(cache->getStatistics().hits == 1);
+    compareMeshes(gridHandlers[0]->getMeshes()[0], gridHandlers[1]->getMeshes()[0]);
+    logFile << "Grid of " << gridHandlers[1]->getMeshes()[0]->getPartition(0)->getFaceCount() << " triangles loaded in "
+            << loadTimes[0] << " seconds cold, and " << loadTimes[1] << " seconds from the cache" << std::endl;
+
+    // Modifying the source file invalidates its entry.
+    writeGrid(GRID_SIZE / 2);
+    mx::GeometryHandlerPtr modifiedHandler = createHandler();
+    REQUIRE(modifiedHandler->loadGeometry(gridPath));
+    REQUIRE(cache->getStatistics().misses == 2);
+    REQUIRE(cache->getStatistics().writes == 2);
+    REQUIRE(modifiedHandler->getMeshes()[0]->getPartition(0)->getFaceCount() == GRID_SIZE * GRID_SIZE / 2);
+
+    // Corrupt entries are ignored.
+    {
+        std::ofstream cacheFile(cache->getCachePath(gridPath).asString(), std::ios::binary | std::ios::in);
+        cacheFile.seekp(100);
+        cacheFile << "corrupt";
+    }
+    std::remove(gridPath.asString().c_str());
+    mx::MeshList meshes;
+    REQUIRE(!cache->readMeshes(gridPath, meshes));
+    REQUIRE(meshes.empty());
+
+    for (const mx::FilePath& file : cacheDirectory.getFilesInDirectory(mx::MeshCache::EXTENSION))
+    {
+        std::remove((cacheDirectory / file).asString().c_str());
+    }
+}
+
+TEST_CASE("Render: Tangent Generation", "[rendercore]")
+{
+    std::ofstream logFile("render_tangent_generation_test.txt");
+
+    // Build a grid with perturbed positions and texture coordinates, and a
+    // row of faces with degenerate texture coordinates. The grid is large
+    // enough for its faces and vertices to be split into several ranges
+    // when generating on multiple threads.
+    const unsigned int GRID_SIZE = 400;
+    auto createGrid = []()
+    {
+        mx::MeshPtr mesh = mx::Mesh::create("grid");
+        mx::MeshStreamPtr positions = mx::MeshStream::create("i_position", mx::MeshStream::POSITION_ATTRIBUTE, 0);
+        mx::MeshStreamPtr normals = mx::MeshStream::create("i_normal", mx::MeshStream::NORMAL_ATTRIBUTE, 0);
+        mx::MeshStreamPtr texcoords = mx::MeshStream::create("i_texcoord_0", mx::MeshStream::TEXCOORD_ATTRIBUTE, 0);
+        texcoords->setStride(mx::MeshStream::STRIDE_2D);
+        for (unsigned int y = 0; y <= GRID_SIZE; y++)
+        {
+            for (unsigned int x = 0; x <= GRID_SIZE; x++)
+            {
+                const float u = float(x) / GRID_SIZE;
+                const float v = float(y) / GRID_SIZE;
+                const float height = 0.1f * std::sin(20.0f * u) * std::cos(13.0f * v);
+                positions->getData().insert(positions->getData().end(), { u, v, height });
+                const mx::Vector3 normal = mx::Vector3(-height, height * 0.5f, 1.0f).getNormalized();
+                normals->getData().insert(normals->getData().end(), normal.begin(), normal.end());
+                texcoords->getData().insert(texcoords->getData().end(), { y == 1 ? 0.5f : u + 0.01f * height, v });
+            }
+        }
+        mx::MeshPartitionPtr partition = mx::MeshPartition::create();
+        for (unsigned int y = 0; y < GRID_SIZE; y++)
+        {
+            for (unsigned int x = 0; x < GRID_SIZE; x++)
+            {
+                const unsigned int i = y * (GRID_SIZE + 1) + x;
+                partition->getIndices().insert(partition->getIndices().end(),
+                    { i, i + 1, i + GRID_SIZE + 2, i, i + GRID_SIZE + 2, i + GRID_SIZE + 1 });
+            }
+        }
+        partition->setFaceCount(partition->getIndices().size() / 3);
+        mesh->addPartition(partition);
+        mesh->addStream(positions);
+        mesh->addStream(normals);
+        mesh->addStream(texcoords);
+        mesh->setVertexCount(positions->getData().size() / 3);
+        return mesh;
+    };
+
+    // Reference implementation, accumulating the tangents of each face in turn.
+    auto referenceTangents = [](mx::MeshPtr mesh)
+    {
+        const mx::MeshFloatBuffer& positions = mesh->getStream(mx::MeshStream::POSITION_ATTRIBUTE, 0)->getData();
+        const mx::MeshFloatBuffer& normals = mesh->getStream(mx::MeshStream::NORMAL_ATTRIBUTE, 0)->getData();
+        const mx::MeshFloatBuffer& texcoords = mesh->getStream(mx::MeshStream::TEXCOORD_ATTRIBUTE, 0)->getData();
+        std::vector<mx::Vector3> tangents(mesh->getVertexCount(), mx::Vector3(0.0f));
+        const mx::MeshIndexBuffer& indices = mesh->getPartition(0)->getIndices();
+        for (size_t f = 0; f < mesh->getPartition(0)->getFaceCount(); f++)
+        {
+            const unsigned int i[3] = { indices[f * 3], indices[f * 3 + 1], indices[f * 3 + 2] };
+            const mx::Vector3 e1(positions[i[1] * 3] - positions[i[0] * 3], positions[i[1] * 3 + 1] - positions[i[0] * 3 + 1],
+                                 positions[i[1] * 3 + 2] - positions[i[0] * 3 + 2]);
+            const mx::Vector3 e2(positions[i[2] * 3] - positions[i[0] * 3], positions[i[2] * 3 + 1] - positions[i[0] * 3 + 1],
+                                 positions[i[2] * 3 + 2] - positions[i[0] * 3 + 2]);
+            const float s1 = texcoords[i[1] * 2] - texcoords[i[0] * 2];
+            const float s2 = texcoords[i[2] * 2] - texcoords[i[0] * 2];
+            const float t1 = texcoords[i[1] * 2 + 1] - texcoords[i[0] * 2 + 1];
+            const float t2 = texcoords[i[2] * 2 + 1] - texcoords[i[0] * 2 + 1];
+            const float denom = s1 * t2 - s2 * t1;
+            const float r = denom ? 1.0f / denom : 0.0f;
+            const mx::Vector3 dir = (e1 * t2 - e2 * t1) * r;
+            for (unsigned int index : i)
+            {
+                tangents[index] += dir;
+            }
+        }
+        for (size_t v = 0; v < tangents.size(); v++)
+        {
+            const mx::Vector3 n(normals[v * 3], normals[v * 3 + 1], normals[v * 3 + 2]);
+            tangents[v] = (tangents[v] != mx::Vector3(0.0f)) ? (tangents[v] - n * n.dot(tangents[v])).getNormalized() :
+                                                                 mx::Vector3(0.0f, 0.0f, 1.0f);
+        }
+        return tangents;
+    };
+
+    mx::MeshPtr mesh = createGrid();
+    const std::vector<mx::Vector3> reference = referenceTangents(mesh);
+    mx::MeshFloatBuffer results[2];
+    double times[2];
+    const unsigned int threadCounts[2] = { 1, 4 };
+    for (size_t i = 0; i < 2; i++)
+    {
+        mx::MeshStreamPtr tangents = mx::MeshStream::create("i_tangent", mx::MeshStream::TANGENT_ATTRIBUTE, 0);
+        mx::MeshStreamPtr bitangents = mx::MeshStream::create("i_bitangent", mx::MeshStream::BITANGENT_ATTRIBUTE, 0);
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(mesh->generateTangents(mesh->getStream(mx::MeshStream::POSITION_ATTRIBUTE, 0),
+                                       mesh->getStream(mx::MeshStream::TEXCOORD_ATTRIBUTE, 0),
+                                       mesh->getStream(mx::MeshStream::NORMAL_ATTRIBUTE, 0),
+                                       tangents, bitangents, threadCounts[i]));
+        times[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        results[i] = tangents->getData();
+        REQUIRE(bitangents->getData().size() == results[i].size());
+    }
+
+    // Results are identical for any number of threads, and match the reference.
+    REQUIRE(results[0].size() == results[1].size());
+    REQUIRE(std::memcmp(results[0].data(), results[1].data(), results[0].size() * sizeof(float)) == 0);
+    const float EPSILON = 1e-5f;
+    size_t mismatches = 0;
+    size_t bitwiseMatches = 0;
+    for (size_t v = 0; v < reference.size(); v++)
+    {
+        const mx::Vector3 tangent(results[0][v * 3], results[0][v * 3 + 1], results[0][v * 3 + 2]);
+        if ((tangent - reference[v]).getMagnitude() > EPSILON)
+        {
+            mismatches++;
+        }
+        if (std::memcmp(tangent.data(), reference[v].data(), sizeof(float) * 3) == 0)
+        {
+            bitwiseMatches++;
+        }
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(bitwiseMatches == reference.size());
+    logFile << "Tangents of " << mesh->getPartition(0)->getFaceCount() << " triangles generated in " << times[0]
+            << " seconds on one thread, and " << times[1] << " seconds on " << threadCounts[1] << " threads on "
+            << std::thread::hardware_concurrency() << " hardware threads. " << bitwiseMatches << " of "
+            << reference.size() << " tangents match the reference bitwise." << std::endl;
+}
+
+TEST_CASE("Render: Mesh Optimization", "[rendercore]")
+{
+    std::ofstream logFile("render_mesh_optimization_test.txt");
+
+    // Return the positions of the faces of a mesh, in sorted order.
+    using FacePositions = std::array<float, 9>;
+    auto getFacePositions = [](mx::MeshPtr mesh)
+    {
+        const mx::MeshFloatBuffer& positions = mesh->getStream(mx::MeshStream::POSITION_ATTRIBUTE, 0)->getData();
+        std::vector<FacePositions> faces;
+        for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+        {
+            mx::MeshPartitionPtr partition = mesh->getPartition(p);
+            const mx::MeshIndexBuffer& indices = partition->getIndices();
+            for (size_t f = 0; f < partition->getFaceCount(); f++)
+            {
+                FacePositions face;
+                for (size_t k = 0; k < 9; k++)
+                {
+                    face[k] = positions[indices[f * 3 + k / 3] * 3 + k % 3];
+                }
+                faces.push_back(face);
+            }
+        }
+        std::sort(faces.begin(), faces.end());
+        return faces;
+    };
+
+    // Return true if vertices are first referenced in increasing order.
+    auto isFetchOrdered = [](mx::MeshPtr mesh)
+    {
+        unsigned int nextVertex = 0;
+        for (size_t p = 0; p < mesh->getPartitionCount(); p++)
+        {
+            for (unsigned int index : mesh->getPartition(p)->getIndices())
+            {
+                if (index > nextVertex)
+                {
+                    return false;
+                }
+                if (index == nextVertex)
+                {
+                    nextVertex++;
+                }
+            }
+        }
+        return true;
+    };
+
+    // Build a grid whose faces are in random order.
+    const unsigned int GRID_SIZE = 200;
+    mx::MeshPtr grid = mx::Mesh::create("grid");
+    mx::MeshStreamPtr positions = mx::MeshStream::create("i_position", mx::MeshStream::POSITION_ATTRIBUTE, 0);
+    for (unsigned int y = 0; y <= GRID_SIZE; y++)
+    {
+        for (unsigned int x = 0; x <= GRID_SIZE; x++)
+        {
+            const float u = float(x) / GRID_SIZE;
+            const float v = float(y) / GRID_SIZE;
+            positions->getData().insert(positions->getData().end(), { u, v, 0.1f * std::sin(10.0f * u) });
+        }
+    }
+    std::vector<std::array<unsigned int, 3>> faces;
+    for (unsigned int y = 0; y < GRID_SIZE; y++)
+    {
+        for (unsigned int x = 0; x < GRID_SIZE; x++)
+        {
+            const unsigned int i = y * (GRID_SIZE + 1) + x;
+            faces.push_back({ i, i + 1, i + GRID_SIZE + 2 });
+            faces.push_back({ i, i + GRID_SIZE + 2, i + GRID_SIZE + 1 });
+        }
+    }
+    std::shuffle(faces.begin(), faces.end(), std::mt19937(7));
+    mx::MeshPartitionPtr partition = mx::MeshPartition::create();
+    for (const auto& face : faces)
+    {
+        partition->getIndices().insert(partition->getIndices().end(), face.begin(), face.end());
+    }
+    partition->setFaceCount(faces.size());
+    grid->addPartition(partition);
+    grid->addStream(positions);
+    grid->setVertexCount(positions->getData().size() / 3);
+
+    const std::vector<FacePositions> gridFaces = getFacePositions(grid);
+    const float shuffledACMR = partition->computeACMR();
+    auto startTime = std::chrono::steady_clock::now();
+    grid->optimizeVertexCache();
+    const float cacheACMR = partition->computeACMR();
+    grid->optimizeOverdraw();
+    const float overdrawACMR = partition->computeACMR();
+    REQUIRE(grid->optimizeVertexFetch());
+    const double optimizeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    logFile << "Grid of " << faces.size() << " shuffled triangles optimized in " << optimizeTime
+            << " seconds. ACMR: " << shuffledACMR << " shuffled, " << cacheACMR << " after vertex cache optimization, "
+            << overdrawACMR << " after overdraw optimization." << std::endl;
+    REQUIRE(cacheACMR < 0.5f * shuffledACMR);
+    REQUIRE(overdrawACMR <= cacheACMR * 1.05f + 0.01f);
+    REQUIRE(partition->computeACMR() == overdrawACMR);
+    bool facesMatch = getFacePositions(grid) == gridFaces;
+    REQUIRE(facesMatch);
+    REQUIRE(isFetchOrdered(grid));
+
+    // Optimizing the meshes of the geometry resources does not noticeably
+    // increase their cache miss ratios, and preserves their faces.
+    mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry/");
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        mx::GeometryHandlerPtr handlers[2];
+        for (size_t i = 0; i < 2; i++)
+        {
+            handlers[i] = mx::GeometryHandler::create();
+            handlers[i]->addLoader(mx::TinyObjLoader::create());
+            handlers[i]->setOptimizeMeshes(i == 1);
+            REQUIRE(handlers[i]->loadGeometry(geomPath / file));
+        }
+        const mx::MeshList& original = handlers[0]->getMeshes();
+        const mx::MeshList& optimized = handlers[1]->getMeshes();
+        REQUIRE(original.size() == optimized.size());
+        for (size_t m = 0; m < original.size(); m++)
+        {
+            REQUIRE(original[m]->getPartitionCount() == optimized[m]->getPartitionCount());
+            for (size_t p = 0; p < original[m]->getPartitionCount(); p++)
+            {
+                const float originalACMR = original[m]->getPartition(p)->computeACMR();
+                const float optimizedACMR = optimized[m]->getPartition(p)->computeACMR();
+                logFile << original[m]->getIdentifier() << ", partition " << p
+                        << ": ACMR " << originalACMR << " loaded, " << optimizedACMR << " optimized." << std::endl;
+                CHECK(optimizedACMR <= originalACMR * 1.05f + 0.01f);
+            }
+            facesMatch = getFacePositions(original[m]) == getFacePositions(optimized[m]);
+            CHECK(facesMatch);
+            CHECK(isFetchOrdered(optimized[m]));
+        }
+    }
+}
+
 TEST_CASE("Render: Image Handler Load", "[rendercore]")
 {
     std::ofstream imageHandlerLog;
@@ -212,3 +846,554 @@ TEST_CASE("Render: Image Handler Load", "[rendercore]")
     CHECK(imagesLoaded);
     imageHandlerLog.close();
 }
+
+TEST_CASE("Render: Image Prefetch", "[rendercore]")
+{
+    std::ofstream logFile("render_image_prefetch_test.txt");
+
+    const mx::FilePath imagePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Images");
+    mx::StbImageLoaderPtr loader = mx::StbImageLoader::create();
+    mx::FilePathVec filePaths;
+    for (const std::string& extension : loader->supportedExtensions())
+    {
+        for (const mx::FilePath& file : imagePath.getFilesInDirectory(extension))
+        {
+            filePaths.push_back(imagePath / file);
+        }
+    }
+    REQUIRE(!filePaths.empty());
+
+    // Load all images serially on this thread.
+    std::vector<mx::ImageDesc> serialImages(filePaths.size());
+    mx::ImageHandlerPtr serialHandler = mx::ImageHandler::create(loader);
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < filePaths.size(); i++)
+    {
+        REQUIRE(serialHandler->acquireImage(filePaths[i], serialImages[i], false));
+    }
+    const double serialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // Prefetch the images on worker threads, and acquire the decoded buffers.
+    const unsigned int numThreads = std::max(4u, std::thread::hardware_concurrency());
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(loader);
+    startTime = std::chrono::steady_clock::now();
+    std::vector<std::shared_future<bool>> futures = imageHandler->prefetchImages(filePaths, numThreads);
+    REQUIRE(futures.size() == filePaths.size());
+    for (std::shared_future<bool>& future : futures)
+    {
+        REQUIRE(future.get());
+    }
+    const double prefetchTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    mx::ImageBufferCachePtr cache = imageHandler->getBufferCache();
+    REQUIRE(cache);
+    REQUIRE(cache->numImages() == filePaths.size());
+    for (size_t i = 0; i < filePaths.size(); i++)
+    {
+        mx::ImageDesc desc;
+        REQUIRE(imageHandler->acquireImage(filePaths[i], desc, false));
+        const mx::ImageDesc& serialDesc = serialImages[i];
+        REQUIRE((desc.width == serialDesc.width && desc.height == serialDesc.height));
+        REQUIRE((desc.channelCount == serialDesc.channelCount && desc.baseType == serialDesc.baseType));
+        REQUIRE(std::memcmp(desc.resourceBuffer, serialDesc.resourceBuffer, mx::ImageBufferCache::getBufferSize(desc)) == 0);
+        desc.freeResourceBuffer();
+        serialImages[i].freeResourceBuffer();
+    }
+    REQUIRE(cache->getStatistics().hits == filePaths.size());
+    REQUIRE(cache->getStatistics().misses == 0);
+
+    // Prefetching cached images completes immediately.
+    futures = imageHandler->prefetchImages(filePaths, numThreads);
+    for (std::shared_future<bool>& future : futures)
+    {
+        REQUIRE(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        REQUIRE(future.get());
+    }
+
+    // Missing images report failure, and acquiring an image while it is
+    // being loaded waits for the load.
+    mx::ImageHandlerPtr pendingHandler = mx::ImageHandler::create(loader);
+    futures = pendingHandler->prefetchImages({ imagePath / mx::FilePath("missing.png"), filePaths[0] }, numThreads);
+    mx::ImageDesc desc;
+    REQUIRE(pendingHandler->acquireImage(filePaths[0], desc, false));
+    desc.freeResourceBuffer();
+    REQUIRE(!futures[0].get());
+    pendingHandler->waitForPrefetch();
+    REQUIRE(pendingHandler->getBufferCache()->getStatistics().misses == 0);
+
+    // Images which failed to load are not loaded again until the image
+    // cache is cleared.
+    futures = pendingHandler->prefetchImages({ imagePath / mx::FilePath("missing.png") }, numThreads);
+    REQUIRE(futures[0].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    REQUIRE(!futures[0].get());
+    pendingHandler->clearImageCache();
+    futures = pendingHandler->prefetchImages({ imagePath / mx::FilePath("missing.png") }, numThreads);
+    REQUIRE(!futures[0].get());
+    pendingHandler->waitForPrefetch();
+
+    logFile << "Loaded " << filePaths.size() << " images serially in " << serialTime << " seconds, and with "
+            << numThreads << " prefetch threads in " << prefetchTime << " seconds. Speedup: "
+            << serialTime / prefetchTime << std::endl;
+}
+
+TEST_CASE("Render: Image Buffer Cache", "[rendercore]")
+{
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+    mx::ImageBufferCachePtr cache = mx::ImageBufferCache::create();
+    imageHandler->setBufferCache(cache);
+
+    const mx::FilePath imagePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Images");
+    const mx::FilePath grid = imagePath / mx::FilePath("grid.png");
+    const mx::FilePath cloth = imagePath / mx::FilePath("cloth.png");
+    const mx::FilePath marble = imagePath / mx::FilePath("marble.png");
+
+    // The first acquire loads the image, and later ones share the cached buffer.
+    mx::ImageDesc desc1;
+    REQUIRE(imageHandler->acquireImage(grid, desc1, false));
+    mx::ImageDesc desc2;
+    REQUIRE(imageHandler->acquireImage(grid, desc2, false));
+    REQUIRE(desc2.resourceBuffer == desc1.resourceBuffer);
+    REQUIRE((desc2.width == desc1.width && desc2.height == desc1.height && desc2.channelCount == desc1.channelCount));
+    REQUIRE(cache->numImages() == 1);
+    REQUIRE(cache->getSize() == mx::ImageBufferCache::getBufferSize(desc1));
+    REQUIRE(cache->getStatistics().hits == 1);
+    REQUIRE(cache->getStatistics().misses == 1);
+    desc1.freeResourceBuffer();
+    desc2.freeResourceBuffer();
+    REQUIRE(cache->hasImage(grid));
+
+    // Limit the budget to the grid and cloth images, so loading a third
+    // image evicts the least recently used one.
+    mx::ImageDesc clothDesc;
+    REQUIRE(imageHandler->acquireImage(cloth, clothDesc, false));
+    cache->setBudget(cache->getSize());
+    REQUIRE(imageHandler->acquireImage(grid, desc1, false));
+    desc1.freeResourceBuffer();
+    mx::ImageDesc marbleDesc;
+    REQUIRE(imageHandler->acquireImage(marble, marbleDesc, false));
+    REQUIRE(cache->getStatistics().evictions >= 1);
+    REQUIRE(!cache->hasImage(cloth));
+    REQUIRE(cache->getSize() <= cache->getBudget());
+
+    // An evicted buffer stays valid until the last reference is freed.
+    const unsigned char* clothPixels = static_cast<const unsigned char*>(clothDesc.resourceBuffer);
+    REQUIRE(clothPixels != nullptr);
+    volatile unsigned char pixel = clothPixels[0];
+    (void) pixel;
+    clothDesc.freeResourceBuffer();
+    marbleDesc.freeResourceBuffer();
+
+    // Pinned images are never evicted.
+    cache->clear();
+    cache->resetStatistics();
+    cache->setBudget(mx::ImageBufferCache::DEFAULT_BUDGET);
+    REQUIRE(imageHandler->acquireImage(grid, desc1, false));
+    desc1.freeResourceBuffer();
+    cache->setPinned(grid, true);
+    REQUIRE(cache->isPinned(grid));
+    cache->setBudget(0);
+    REQUIRE(cache->hasImage(grid));
+    REQUIRE(cache->getStatistics().evictions == 0);
+    REQUIRE(imageHandler->acquireImage(cloth, clothDesc, false));
+    clothDesc.freeResourceBuffer();
+    REQUIRE(!cache->hasImage(cloth));
+    REQUIRE(cache->getStatistics().evictions == 1);
+    cache->setPinned(grid, false);
+    REQUIRE(cache->numImages() == 0);
+    REQUIRE(cache->getSize() == 0);
+    REQUIRE(cache->getStatistics().evictions == 2);
+}
+
+TEST_CASE("Render: Image Load Restrictions", "[rendercore]")
+{
+    std::ofstream logFile("render_image_restrictions_test.txt");
+
+    // Conversion of special values to half float and back.
+    const float infinity = std::numeric_limits<float>::infinity();
+    const std::vector<float> values = { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 1.0e6f, -infinity,
+                                        6.1035156e-5f, 5.9604645e-8f, 1.0e-9f, 0.1f, 3.14159f };
+    const std::vector<float> expected = { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, infinity, -infinity,
+                                          6.1035156e-5f, 5.9604645e-8f, 0.0f, 0.099975586f, 3.140625f };
+    std::vector<uint16_t> halfValues(values.size());
+    std::vector<float> roundTrip(values.size());
+    mx::convertFloatToHalf(values.data(), halfValues.data(), values.size());
+    mx::convertHalfToFloat(halfValues.data(), roundTrip.data(), values.size());
+    REQUIRE(roundTrip == expected);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    mx::convertFloatToHalf(&nan, halfValues.data(), 1);
+    mx::convertHalfToFloat(halfValues.data(), roundTrip.data(), 1);
+    REQUIRE(roundTrip[0] != roundTrip[0]);
+
+    // Load the images with all channels expanded to four channels of floats,
+    // with their native channel count, and with HDR images as half floats.
+    mx::ImageDescRestrictions expanded;
+    expanded.supportedBaseTypes = { mx::ImageDesc::BASETYPE_UINT8, mx::ImageDesc::BASETYPE_FLOAT };
+    expanded.channelCount = 4;
+    mx::ImageDescRestrictions native;
+    native.supportedBaseTypes = { mx::ImageDesc::BASETYPE_UINT8, mx::ImageDesc::BASETYPE_HALF, mx::ImageDesc::BASETYPE_FLOAT };
+    mx::ImageDescRestrictions half = native;
+    half.floatBaseType = mx::ImageDesc::BASETYPE_HALF;
+
+    const mx::FilePath imagePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Images");
+    mx::StbImageLoaderPtr loader = mx::StbImageLoader::create();
+    size_t expandedSize = 0;
+    size_t nativeSize = 0;
+    size_t halfSize = 0;
+    for (const std::string& extension : loader->supportedExtensions())
+    {
+        for (const mx::FilePath& file : imagePath.getFilesInDirectory(extension))
+        {
+            mx::ImageDesc expandedDesc;
+            mx::ImageDesc nativeDesc;
+            mx::ImageDesc halfDesc;
+            REQUIRE(loader->loadImage(imagePath / file, expandedDesc, &expanded));
+            REQUIRE(loader->loadImage(imagePath / file, nativeDesc, &native));
+            REQUIRE(loader->loadImage(imagePath / file, halfDesc, &half));
+            REQUIRE(expandedDesc.channelCount == 4);
+            REQUIRE(halfDesc.channelCount == nativeDesc.channelCount);
+            REQUIRE(nativeDesc.baseType == expandedDesc.baseType);
+
+            if (nativeDesc.baseType == mx::ImageDesc::BASETYPE_FLOAT)
+            {
+                REQUIRE(halfDesc.baseType == mx::ImageDesc::BASETYPE_HALF);
+                const size_t count = size_t(halfDesc.width) * halfDesc.height * halfDesc.channelCount;
+                std::vector<float> converted(count);
+                mx::convertHalfToFloat(static_cast<uint16_t*>(halfDesc.resourceBuffer), converted.data(), count);
+                const float* source = static_cast<float*>(nativeDesc.resourceBuffer);
+                for (size_t i = 0; i < count; i++)
+                {
+                    REQUIRE(std::abs(converted[i] - source[i]) <= std::abs(source[i]) / 1024.0f + 1.0e-7f);
+                }
+            }
+            else
+            {
+                REQUIRE(halfDesc.baseType == nativeDesc.baseType);
+            }
+
+            const size_t sizes[] = { mx::ImageBufferCache::getBufferSize(expandedDesc),
+                                     mx::ImageBufferCache::getBufferSize(nativeDesc),
+                                     mx::ImageBufferCache::getBufferSize(halfDesc) };
+            logFile << file.asString() << ": " << nativeDesc.channelCount << " channels, "
+                    << sizes[0] << " bytes as four channels, " << sizes[1] << " bytes with native channels, "
+                    << sizes[2] << " bytes with half floats" << std::endl;
+            expandedSize += sizes[0];
+            nativeSize += sizes[1];
+            halfSize += sizes[2];
+        }
+    }
+    REQUIRE(nativeSize <= expandedSize);
+    REQUIRE(halfSize < nativeSize);
+
+    logFile << "Total: " << expandedSize << " bytes as four channels, " << nativeSize << " bytes with native channels ("
+            << 100.0 * (1.0 - double(nativeSize) / double(expandedSize)) << "% saved), " << halfSize
+            << " bytes with half floats (" << 100.0 * (1.0 - double(halfSize) / double(expandedSize)) << "% saved)" << std::endl;
+
+    // Restrictions without float support load HDR images as half floats.
+    mx::ImageDescRestrictions halfOnly;
+    halfOnly.supportedBaseTypes = { mx::ImageDesc::BASETYPE_HALF };
+    mx::ImageDesc hdrDesc;
+    REQUIRE(loader->loadImage(imagePath / mx::FilePath("san_giuseppe_bridge_diffuse.hdr"), hdrDesc, &halfOnly));
+    REQUIRE(hdrDesc.baseType == mx::ImageDesc::BASETYPE_HALF);
+    REQUIRE(!loader->loadImage(imagePath / mx::FilePath("grid.png"), hdrDesc, &halfOnly));
+}
+
+namespace
+{
+
+// Scalar reference for a mip level, filtered in two dimensions in double precision.
+std::vector<double> filterMipLevel(const std::vector<double>& source, unsigned int width, unsigned int height,
+                                   unsigned int channelCount, const std::vector<std::pair<int, double>>& taps)
+{
+    const unsigned int destWidth = std::max(width / 2, 1u);
+    const unsigned int destHeight = std::max(height / 2, 1u);
+    std::vector<double> dest(size_t(destWidth) * destHeight * channelCount, 0.0);
+    for (unsigned int y = 0; y < destHeight; y++)
+    {
+        for (unsigned int x = 0; x < destWidth; x++)
+        {
+            for (const auto& tapY : taps)
+            {
+                const int sourceY = std::min(std::max(int(2 * y) + tapY.first, 0), int(height) - 1);
+                for (const auto& tapX : taps)
+                {
+                    const int sourceX = std::min(std::max(int(2 * x) + tapX.first, 0), int(width) - 1);
+                    for (unsigned int c = 0; c < channelCount; c++)
+                    {
+                        dest[(size_t(y) * destWidth + x) * channelCount + c] +=
+                            tapY.second * tapX.second * source[(size_t(sourceY) * width + sourceX) * channelCount + c];
+                    }
+                }
+            }
+        }
+    }
+    return dest;
+}
+
+std::vector<double> getMipLevelValues(const mx::ImageDesc& desc, unsigned int level)
+{
+    const size_t count = size_t(desc.getMipWidth(level)) * desc.getMipHeight(level) * desc.channelCount;
+    std::vector<float> values(count);
+    const void* buffer = desc.getMipBuffer(level);
+    if (desc.baseType == mx::ImageDesc::BASETYPE_FLOAT)
+    {
+        std::memcpy(values.data(), buffer, count * sizeof(float));
+    }
+    else if (desc.baseType == mx::ImageDesc::BASETYPE_HALF)
+    {
+        mx::convertHalfToFloat(static_cast<const uint16_t*>(buffer), values.data(), count);
+    }
+    else
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+        std::copy(bytes, bytes + count, values.begin());
+    }
+    return std::vector<double>(values.begin(), values.end());
+}
+
+} // anonymous namespace
+
+TEST_CASE("Render: Image Mip Maps", "[rendercore]")
+{
+    // Kaiser windowed sinc over three source pixels on each side,
+    // with a cutoff at half the source frequency.
+    std::vector<std::pair<int, double>> kaiserTaps;
+    double kaiserSum = 0.0;
+    for (int offset = -2; offset <= 3; offset++)
+    {
+        auto besselI0 = [](double x)
+        {
+            double sum = 0.0;
+            double factorial = 1.0;
+            for (int k = 0; k < 32; k++)
+            {
+                factorial *= k > 0 ? k : 1;
+                sum += std::pow(x / 2.0, 2 * k) / (factorial * factorial);
+            }
+            return sum;
+        };
+        const double PI = 3.14159265358979323846;
+        const double x = std::abs(offset - 0.5);
+        const double sinc = std::sin(PI * x / 2.0) / (PI * x / 2.0);
+        const double window = besselI0(4.0 * std::sqrt(1.0 - (x / 3.0) * (x / 3.0))) / besselI0(4.0);
+        kaiserTaps.push_back({ offset, sinc * window });
+        kaiserSum += sinc * window;
+    }
+    for (auto& tap : kaiserTaps)
+    {
+        tap.second /= kaiserSum;
+    }
+    const std::vector<std::pair<int, double>> boxTaps = { { 0, 0.5 }, { 1, 0.5 } };
+
+    mx::ImageDescRestrictions halfRestrictions;
+    halfRestrictions.supportedBaseTypes = { mx::ImageDesc::BASETYPE_UINT8, mx::ImageDesc::BASETYPE_HALF };
+    const mx::FilePath imagePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Images");
+    const std::vector<std::pair<std::string, const mx::ImageDescRestrictions*>> images =
+    {
+        { "grid.png", nullptr },
+        { "cloth.jpg", nullptr },
+        { "brass_roughness.jpg", nullptr },
+        { "san_giuseppe_bridge_diffuse.hdr", nullptr },
+        { "san_giuseppe_bridge_diffuse.hdr", &halfRestrictions }
+    };
+
+    mx::StbImageLoaderPtr loader = mx::StbImageLoader::create();
+    for (const auto& image : images)
+    {
+        for (mx::ImageDesc::MipFilter filter : { mx::ImageDesc::MipFilter::BOX, mx::ImageDesc::MipFilter::KAISER })
+        {
+            mx::ImageDesc desc;
+            REQUIRE(loader->loadImage(imagePath / image.first, desc, image.second));
+            REQUIRE(desc.generateMipMaps(filter, 4));
+            REQUIRE(desc.mipBuffers.size() == desc.mipCount - 1);
+            REQUIRE(desc.getMipWidth(desc.mipCount - 1) == 1);
+            REQUIRE(desc.getMipHeight(desc.mipCount - 1) == 1);
+            REQUIRE(!desc.getMipBuffer(desc.mipCount));
+
+            // Generating the levels on a single thread gives the same result.
+            mx::ImageDesc serialDesc;
+            REQUIRE(loader->loadImage(imagePath / image.first, serialDesc, image.second));
+            REQUIRE(serialDesc.generateMipMaps(filter, 1));
+            const size_t pixelSize = mx::ImageBufferCache::getBufferSize(desc) / (size_t(desc.width) * desc.height);
+            for (unsigned int level = 1; level < desc.mipCount; level++)
+            {
+                const size_t size = pixelSize * desc.getMipWidth(level) * desc.getMipHeight(level);
+                REQUIRE(std::memcmp(desc.getMipBuffer(level), serialDesc.getMipBuffer(level), size) == 0);
+            }
+
+            // Compare each level with the scalar reference, cascading from the
+            // unquantized values of the level above as the image does.
+            const auto& taps = filter == mx::ImageDesc::MipFilter::BOX ? boxTaps : kaiserTaps;
+            std::vector<double> reference = getMipLevelValues(desc, 0);
+            for (unsigned int level = 1; level < desc.mipCount; level++)
+            {
+                reference = filterMipLevel(reference, desc.getMipWidth(level - 1), desc.getMipHeight(level - 1),
+                                           desc.channelCount, taps);
+                const std::vector<double> values = getMipLevelValues(desc, level);
+                REQUIRE(values.size() == reference.size());
+                size_t mismatches = 0;
+                for (size_t i = 0; i < values.size(); i++)
+                {
+                    double expected = reference[i];
+                    double tolerance = 1.0e-4 * std::max(std::abs(expected), 1.0);
+                    if (desc.baseType == mx::ImageDesc::BASETYPE_UINT8)
+                    {
+                        expected = std::min(std::max(expected, 0.0), 255.0);
+                        tolerance += 0.5;
+                    }
+                    else if (desc.baseType == mx::ImageDesc::BASETYPE_HALF)
+                    {
+                        tolerance += std::abs(expected) / 1024.0;
+                    }
+                    if (std::abs(values[i] - expected) > tolerance)
+                    {
+                        mismatches++;
+                    }
+                }
+                REQUIRE(mismatches == 0);
+            }
+
+            desc.freeResourceBuffer();
+            REQUIRE(desc.mipBuffers.empty());
+        }
+    }
+
+    // Images acquired with mip maps keep their levels in the buffer cache.
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(loader);
+    mx::ImageBufferCachePtr cache = mx::ImageBufferCache::create();
+    imageHandler->setBufferCache(cache);
+    const mx::FilePath grid = imagePath / mx::FilePath("grid.png");
+    mx::ImageDesc desc;
+    REQUIRE(imageHandler->acquireImage(grid, desc, true));
+    REQUIRE(desc.mipBuffers.size() == desc.mipCount - 1);
+    REQUIRE(cache->getSize() > mx::ImageBufferCache::getBufferSize(desc));
+    mx::ImageDesc cachedDesc;
+    REQUIRE(imageHandler->acquireImage(grid, cachedDesc, true));
+    REQUIRE(cachedDesc.getMipBuffer(1) == desc.getMipBuffer(1));
+    desc.freeResourceBuffer();
+    cachedDesc.freeResourceBuffer();
+
+    // Levels of an image cached without mip maps are generated once, on the
+    // first acquire with mip maps, and are counted against the budget.
+    cache->clear();
+    REQUIRE(imageHandler->acquireImage(grid, desc, false));
+    REQUIRE(desc.mipBuffers.empty());
+    const size_t baseSize = cache->getSize();
+    desc.freeResourceBuffer();
+    REQUIRE(imageHandler->acquireImage(grid, desc, true));
+    REQUIRE(desc.mipBuffers.size() == desc.mipCount - 1);
+    REQUIRE(cache->getSize() == baseSize + mx::ImageBufferCache::getMipBuffersSize(desc));
+    REQUIRE(imageHandler->acquireImage(grid, cachedDesc, true));
+    REQUIRE(cachedDesc.mipBuffers == desc.mipBuffers);
+    REQUIRE(cache->getSize() == baseSize + mx::ImageBufferCache::getMipBuffersSize(desc));
+    desc.freeResourceBuffer();
+    cachedDesc.freeResourceBuffer();
+}
+
+TEST_CASE("Render: UDIM Tile Set", "[rendercore]")
+{
+    std::ofstream logFile("render_udim_tile_set_test.txt");
+
+    // Write a synthetic set of 10x10 tiles, each filled with its index,
+    // along with files which do not match the pattern.
+    mx::FilePath tilePath = mx::FilePath::getCurrentPath() / mx::FilePath("udim_tile_set_test");
+    tilePath.createDirectory();
+    mx::StbImageLoaderPtr loader = mx::StbImageLoader::create();
+    const unsigned int TILE_SIZE = 64;
+    for (unsigned int i = 0; i < 100; i++)
+    {
+        mx::ImageDesc desc;
+        desc.width = desc.height = TILE_SIZE;
+        desc.channelCount = 4;
+        std::vector<uint8_t> pixels(TILE_SIZE * TILE_SIZE * 4, uint8_t(i));
+        desc.resourceBuffer = pixels.data();
+        desc.resourceBufferDeallocator = [](void*) { };
+        const std::string udim = std::to_string(1001 + i);
+        REQUIRE(loader->saveImage(tilePath / mx::FilePath("tile_" + udim + ".png"), desc));
+        if (i == 0)
+        {
+            REQUIRE(loader->saveImage(tilePath / mx::FilePath("tile_" + udim + "_mask.png"), desc));
+            REQUIRE(loader->saveImage(tilePath / mx::FilePath("tile_abcd.png"), desc));
+        }
+    }
+
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(loader);
+    imageHandler->setSearchPath(mx::FileSearchPath(tilePath));
+    REQUIRE(mx::UdimTileSet::isUdimPattern(mx::FilePath("tile_<UDIM>.png")));
+    REQUIRE(!mx::UdimTileSet::isUdimPattern(mx::FilePath("tile_1001.png")));
+    mx::UdimTileSetPtr tileSet = mx::UdimTileSet::create(mx::FilePath("tile_<UDIM>.png"), imageHandler);
+    REQUIRE(tileSet->getStatistics().tileCount == 0);
+    REQUIRE(tileSet->getTiles().size() == 100);
+    REQUIRE(tileSet->getTiles().front() == "1001");
+    REQUIRE(tileSet->getTiles().back() == "1100");
+    REQUIRE(tileSet->getTilePath("1042") == tilePath / mx::FilePath("tile_1042.png"));
+    REQUIRE(tileSet->getStatistics().tileCount == 100);
+    REQUIRE(tileSet->getStatistics().loads == 0);
+
+    // Create a mesh with one triangle in each of three tiles, split by UDIM.
+    REQUIRE(mx::UdimTileSet::getUdim(0.5f, 0.5f) == "1001");
+    REQUIRE(mx::UdimTileSet::getUdim(2.5f, 4.25f) == "1043");
+    mx::MeshPtr mesh = mx::Mesh::create("udimMesh");
+    mx::MeshStreamPtr texcoords = mx::MeshStream::create("i_texcoord_0", mx::MeshStream::TEXCOORD_ATTRIBUTE, 0);
+    texcoords->setStride(mx::MeshStream::STRIDE_2D);
+    mx::MeshPartitionPtr partition = mx::MeshPartition::create();
+    const std::vector<std::pair<float, float>> tileOrigins = { { 0.0f, 0.0f }, { 2.0f, 4.0f }, { 9.0f, 9.0f } };
+    for (const auto& origin : tileOrigins)
+    {
+        for (const auto& corner : std::vector<std::pair<float, float>>{ { 0.1f, 0.1f }, { 0.9f, 0.1f }, { 0.1f, 0.9f } })
+        {
+            partition->getIndices().push_back(uint32_t(texcoords->getData().size() / 2));
+            texcoords->getData().push_back(origin.first + corner.first);
+            texcoords->getData().push_back(origin.second + corner.second);
+        }
+        partition->setFaceCount(partition->getFaceCount() + 1);
+    }
+    mesh->addStream(texcoords);
+    mesh->setVertexCount(texcoords->getData().size() / 2);
+    mesh->addPartition(partition);
+    REQUIRE(mx::UdimTileSet::getUdims(*mesh, *partition) == mx::StringSet({ "1001", "1043", "1100" }));
+    mesh->splitByUdims();
+    REQUIRE(mesh->getPartitionCount() == 3);
+
+    // Only the tiles of the visible partitions are loaded, at the requested level.
+    std::vector<mx::MeshPartitionPtr> visible = { mesh->getPartition(1) };
+    REQUIRE(tileSet->requestTiles(*mesh, visible, 2) == mx::StringSet({ "1043" }));
+    mx::UdimTileSet::Statistics statistics = tileSet->getStatistics();
+    REQUIRE(statistics.loads == 1);
+    REQUIRE(statistics.residentTiles == 1);
+    REQUIRE(statistics.residentBytes == (TILE_SIZE / 4) * (TILE_SIZE / 4) * 4);
+    const mx::ImageDesc* image = tileSet->getTileImage("1043");
+    REQUIRE(image);
+    REQUIRE(tileSet->getTileLevel("1043") == 2);
+    REQUIRE((image->width == TILE_SIZE / 4 && image->height == TILE_SIZE / 4));
+    REQUIRE(static_cast<const uint8_t*>(image->resourceBuffer)[0] == 42);
+    REQUIRE(!tileSet->getTileImage("1001"));
+
+    // Requesting resident tiles does not load them again, and a tile is
+    // reloaded when requested at another level.
+    visible = { mesh->getPartition(0), mesh->getPartition(1) };
+    REQUIRE(tileSet->requestTiles(*mesh, visible, 2) == mx::StringSet({ "1001", "1043" }));
+    REQUIRE(tileSet->getStatistics().loads == 2);
+    REQUIRE(tileSet->requestTile("1043", 0));
+    REQUIRE(tileSet->getTileImage("1043")->width == TILE_SIZE);
+    REQUIRE(tileSet->requestTile("1001", 20));
+    REQUIRE(tileSet->getTileImage("1001")->width == 1);
+    REQUIRE(tileSet->requestTile("1001", 30));
+    REQUIRE(tileSet->getStatistics().loads == 4);
+
+    // Tiles which do not exist fail to load.
+    REQUIRE(!tileSet->requestTile("1101"));
+    REQUIRE(tileSet->getStatistics().failedLoads == 1);
+
+    // Tiles which are no longer visible can be evicted.
+    tileSet->evictTilesExcept({ "1043" });
+    statistics = tileSet->getStatistics();
+    REQUIRE(statistics.residentTiles == 1);
+    REQUIRE(statistics.evictions == 1);
+    REQUIRE(statistics.residentBytes == TILE_SIZE * TILE_SIZE * 4);
+    tileSet->clear();
+    REQUIRE(tileSet->getStatistics().residentTiles == 0);
+
+    logFile << "Tiles: " << statistics.tileCount << ", resident: " << statistics.residentTiles
+            << ", resident bytes: " << statistics.residentBytes << ", loads: " << statistics.loads
+            << ", failed loads: " << statistics.failedLoads << ", evictions: " << statistics.evictions << std::endl;
+}
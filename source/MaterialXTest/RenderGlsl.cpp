@@ -259,11 +259,15 @@ bool GlslShaderRenderTester::runValidator(const std::string& shaderName,
             profileTimes.elementsTested++;
 
             mx::FilePath outputFilePath = outputPath;
-            // Use separate directory for reduced output
+            // Use separate directories for reduced and baked output
             if (options.shaderInterfaceType == mx::SHADER_INTERFACE_REDUCED)
             {
                 outputFilePath = outputFilePath / mx::FilePath("reduced");
             }
+            else if (options.bakeUniforms)
+            {
+                outputFilePath = outputFilePath / mx::FilePath("baked");
+            }
 
             // Note: mkdir will fail if the directory already exists which is ok.
             {
@@ -154,11 +154,15 @@ bool OslShaderRenderTester::runValidator(const std::string& shaderName,
 
             std::string shaderPath;
             mx::FilePath outputFilePath = outputPath;
-            // Use separate directory for reduced output
+            // Use separate directories for reduced and baked output
             if (options.shaderInterfaceType == mx::SHADER_INTERFACE_REDUCED)
             {
                 outputFilePath = outputFilePath / mx::FilePath("reduced");
             }
+            else if (options.bakeUniforms)
+            {
+                outputFilePath = outputFilePath / mx::FilePath("baked");
+            }
 
             // Note: mkdir will fail if the directory already exists which is ok.
             {
@@ -269,6 +273,15 @@ bool OslShaderRenderTester::runValidator(const std::string& shaderName,
                             RenderUtil::AdditiveScopedTimer renderTimer(profileTimes.languageTimes.renderTime, "OSL render time");
                             _validator->validateRender();
                         }
+
+                        // Baked shaders must render the same as the shaders using uniforms,
+                        // if these have been rendered with the complete interface.
+                        if (options.bakeUniforms && (testOptions.shaderInterfaces & 2))
+                        {
+                            const mx::FilePath bakedImage = shaderPath + "_osl.png";
+                            const mx::FilePath uniformImage = mx::FilePath(outputPath) / mx::FilePath(shaderName + "_osl.png");
+                            CHECK(RenderUtil::compareImages(bakedImage, uniformImage, 2, log));
+                        }
                     }
                     else
                     {
@@ -7,6 +7,11 @@
 #include <MaterialXTest/RenderUtil.h>
 #include <MaterialXTest/Catch/catch.hpp>
 
+#include <MaterialXRender/StbImageLoader.h>
+
+#include <algorithm>
+#include <cstdlib>
+
 namespace mx = MaterialX;
 
 namespace RenderUtil
@@ -57,6 +62,46 @@ void ShaderRenderTester::getGenerationOptions(const GenShaderUtil::TestSuiteOpti
         completeOption.shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
         optionsList.push_back(completeOption);
     }
+    if (testOptions.shaderInterfaces & 4)
+    {
+        mx::GenOptions bakedOption = originalOptions;
+        bakedOption.shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+        bakedOption.bakeUniforms = true;
+        optionsList.push_back(bakedOption);
+    }
+}
+
+bool compareImages(const mx::FilePath& filePath1, const mx::FilePath& filePath2, unsigned int tolerance, std::ostream& log)
+{
+    mx::StbImageLoaderPtr loader = mx::StbImageLoader::create();
+    mx::ImageDesc image1;
+    mx::ImageDesc image2;
+    if (!loader->loadImage(filePath1, image1) || !loader->loadImage(filePath2, image2))
+    {
+        log << ">> Failed to load images for comparison: " << filePath1.asString() << ", " << filePath2.asString() << std::endl;
+        return false;
+    }
+    if (image1.baseType != mx::ImageDesc::BASETYPE_UINT8 || image2.baseType != mx::ImageDesc::BASETYPE_UINT8 ||
+        image1.width != image2.width || image1.height != image2.height || image1.channelCount != image2.channelCount)
+    {
+        log << ">> Images differ in format: " << filePath1.asString() << ", " << filePath2.asString() << std::endl;
+        return false;
+    }
+
+    const unsigned char* data1 = static_cast<const unsigned char*>(image1.resourceBuffer);
+    const unsigned char* data2 = static_cast<const unsigned char*>(image2.resourceBuffer);
+    const size_t size = size_t(image1.width) * image1.height * image1.channelCount;
+    unsigned int maxDifference = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        maxDifference = std::max(maxDifference, (unsigned int) std::abs(int(data1[i]) - int(data2[i])));
+    }
+    if (maxDifference > tolerance)
+    {
+        log << ">> Images differ by up to " << maxDifference << ": " << filePath1.asString() << ", " << filePath2.asString() << std::endl;
+        return false;
+    }
+    return true;
 }
 
 void ShaderRenderTester::printRunLog(const RenderProfileTimes &profileTimes,
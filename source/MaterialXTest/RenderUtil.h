@@ -42,6 +42,10 @@ namespace RenderUtil
 void createLightRig(mx::DocumentPtr doc, mx::LightHandler& lightHandler, mx::GenContext& context,
     const mx::FilePath& envIrradiancePath, const mx::FilePath& envRadiancePath);
 
+// Compare two 8-bit images on disk, returning true if they have the same size and
+// all channel values differ by no more than the given tolerance, in the 0-255 range.
+bool compareImages(const mx::FilePath& filePath1, const mx::FilePath& filePath2, unsigned int tolerance, std::ostream& log);
+
 // Scoped timer which adds a duration to a given externally reference timing duration
 //
 class AdditiveScopedTimer
@@ -23,6 +23,11 @@ void bindPyGenOptions(py::module& mod)
         .value("SPECULAR_ENVIRONMENT_NONE", mx::HwSpecularEnvironmentMethod::SPECULAR_ENVIRONMENT_NONE)
         .export_values();
 
+    py::enum_<mx::ConvolutionSamplingMethod>(mod, "ConvolutionSamplingMethod")
+        .value("CONVOLUTION_SAMPLING_FULL", mx::ConvolutionSamplingMethod::CONVOLUTION_SAMPLING_FULL)
+        .value("CONVOLUTION_SAMPLING_SEPARABLE", mx::ConvolutionSamplingMethod::CONVOLUTION_SAMPLING_SEPARABLE)
+        .export_values();
+
     py::class_<mx::GenOptions>(mod, "GenOptions")
         .def_readwrite("shaderInterfaceType", &mx::GenOptions::shaderInterfaceType)
         .def_readwrite("fileTextureVerticalFlip", &mx::GenOptions::fileTextureVerticalFlip)
@@ -30,5 +35,11 @@ void bindPyGenOptions(py::module& mod)
         .def_readwrite("hwTransparency", &mx::GenOptions::hwTransparency)
         .def_readwrite("hwSpecularEnvironmentMethod", &mx::GenOptions::hwSpecularEnvironmentMethod)
         .def_readwrite("hwMaxActiveLightSources", &mx::GenOptions::hwMaxActiveLightSources)
+        .def_readwrite("hwLightLoopHoisting", &mx::GenOptions::hwLightLoopHoisting)
+        .def_readwrite("optimizationLevel", &mx::GenOptions::optimizationLevel)
+        .def_readwrite("convolutionSamplingMethod", &mx::GenOptions::convolutionSamplingMethod)
+        .def_readwrite("flattenSubgraphs", &mx::GenOptions::flattenSubgraphs)
+        .def_readwrite("bakeUniforms", &mx::GenOptions::bakeUniforms)
+        .def_readwrite("bakedUniformNames", &mx::GenOptions::bakedUniformNames)
         .def(py::init<>());
 }
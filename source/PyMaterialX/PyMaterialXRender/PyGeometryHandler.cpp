@@ -47,5 +47,26 @@ void bindPyGeometryHandler(py::module& mod)
         .def("loadGeometry", &mx::GeometryHandler::loadGeometry)
         .def("getMeshes", &mx::GeometryHandler::getMeshes)
         .def("getMinimumBounds", &mx::GeometryHandler::getMinimumBounds)
-        .def("getMaximumBounds", &mx::GeometryHandler::getMaximumBounds);
+        .def("getMaximumBounds", &mx::GeometryHandler::getMaximumBounds)
+        .def("setMeshCache", &mx::GeometryHandler::setMeshCache)
+        .def("getMeshCache", &mx::GeometryHandler::getMeshCache)
+        .def("setOptimizeMeshes", &mx::GeometryHandler::setOptimizeMeshes)
+        .def("getOptimizeMeshes", &mx::GeometryHandler::getOptimizeMeshes);
+
+    py::class_<mx::MeshCache::Statistics>(mod, "MeshCacheStatistics")
+        .def_readonly("hits", &mx::MeshCache::Statistics::hits)
+        .def_readonly("misses", &mx::MeshCache::Statistics::misses)
+        .def_readonly("writes", &mx::MeshCache::Statistics::writes);
+
+    py::class_<mx::MeshCache, mx::MeshCachePtr>(mod, "MeshCache")
+        .def(py::init<const mx::FilePath&>(), py::arg("directory") = mx::FilePath())
+        .def_static("create", &mx::MeshCache::create, py::arg("directory") = mx::FilePath())
+        .def_readonly_static("VERSION", &mx::MeshCache::VERSION)
+        .def_readonly_static("EXTENSION", &mx::MeshCache::EXTENSION)
+        .def("getDirectory", &mx::MeshCache::getDirectory)
+        .def("getCachePath", &mx::MeshCache::getCachePath)
+        .def("readMeshes", &mx::MeshCache::readMeshes)
+        .def("writeMeshes", &mx::MeshCache::writeMeshes)
+        .def("getStatistics", &mx::MeshCache::getStatistics)
+        .def("resetStatistics", &mx::MeshCache::resetStatistics);
 }
@@ -124,7 +124,13 @@ void bindPyImageHandler(py::module& mod)
 {
     py::class_<mx::ImageBufferDeallocator>(mod, "ImageBufferDeallocator");
 
-    py::class_<mx::ImageDesc>(mod, "ImageDesc")
+    py::class_<mx::ImageDesc> imageDesc(mod, "ImageDesc");
+
+    py::enum_<mx::ImageDesc::MipFilter>(imageDesc, "MipFilter")
+        .value("BOX", mx::ImageDesc::MipFilter::BOX)
+        .value("KAISER", mx::ImageDesc::MipFilter::KAISER);
+
+    imageDesc
         .def_readwrite("width", &mx::ImageDesc::width)
         .def_readwrite("height", &mx::ImageDesc::height)
         .def_readwrite("channelCount", &mx::ImageDesc::channelCount)
@@ -134,6 +140,10 @@ void bindPyImageHandler(py::module& mod)
         .def_readwrite("resourceId", &mx::ImageDesc::resourceId)
         .def_readwrite("resourceBufferDeallocator ", &mx::ImageDesc::resourceBufferDeallocator)
         .def("computeMipCount", &mx::ImageDesc::computeMipCount)
+        .def("generateMipMaps", &mx::ImageDesc::generateMipMaps,
+            py::arg("filter") = mx::ImageDesc::MipFilter::BOX, py::arg("numThreads") = 0)
+        .def("getMipWidth", &mx::ImageDesc::getMipWidth)
+        .def("getMipHeight", &mx::ImageDesc::getMipHeight)
         .def("freeResourceBuffer", &mx::ImageDesc::freeResourceBuffer);
 
     py::class_<mx::ImageSamplingProperties>(mod, "ImageSamplingProperties")
@@ -142,6 +152,25 @@ void bindPyImageHandler(py::module& mod)
         .def_readwrite("filterType", &mx::ImageSamplingProperties::filterType)
         .def_readwrite("defaultColor", &mx::ImageSamplingProperties::defaultColor);
 
+    py::class_<mx::ImageBufferCache::Statistics>(mod, "ImageBufferCacheStatistics")
+        .def_readonly("hits", &mx::ImageBufferCache::Statistics::hits)
+        .def_readonly("misses", &mx::ImageBufferCache::Statistics::misses)
+        .def_readonly("evictions", &mx::ImageBufferCache::Statistics::evictions);
+
+    py::class_<mx::ImageBufferCache, mx::ImageBufferCachePtr>(mod, "ImageBufferCache")
+        .def_static("create", &mx::ImageBufferCache::create)
+        .def("setBudget", &mx::ImageBufferCache::setBudget)
+        .def("getBudget", &mx::ImageBufferCache::getBudget)
+        .def("getSize", &mx::ImageBufferCache::getSize)
+        .def("numImages", &mx::ImageBufferCache::numImages)
+        .def("hasImage", &mx::ImageBufferCache::hasImage)
+        .def("removeImage", &mx::ImageBufferCache::removeImage)
+        .def("setPinned", &mx::ImageBufferCache::setPinned)
+        .def("isPinned", &mx::ImageBufferCache::isPinned)
+        .def("clear", &mx::ImageBufferCache::clear)
+        .def("getStatistics", &mx::ImageBufferCache::getStatistics)
+        .def("resetStatistics", &mx::ImageBufferCache::resetStatistics);
+
     py::class_<mx::ImageLoader, PyImageLoader, mx::ImageLoaderPtr>(mod, "ImageLoader")
         .def_readwrite_static("BMP_EXTENSION", &mx::ImageLoader::BMP_EXTENSION)
         .def_readwrite_static("EXR_EXTENSION", &mx::ImageLoader::EXR_EXTENSION)
@@ -172,5 +201,12 @@ void bindPyImageHandler(py::module& mod)
         .def("clearImageCache", &mx::ImageHandler::clearImageCache)
         .def("setSearchPath", &mx::ImageHandler::setSearchPath)
         .def("getSearchPath", &mx::ImageHandler::getSearchPath)
-        .def("findFile", &mx::ImageHandler::findFile);
+        .def("findFile", &mx::ImageHandler::findFile)
+        .def("prefetchImages", [](mx::ImageHandler& handler, const mx::FilePathVec& filePaths, unsigned int numThreads)
+            {
+                handler.prefetchImages(filePaths, numThreads);
+            }, py::arg("filePaths"), py::arg("numThreads") = 0)
+        .def("waitForPrefetch", &mx::ImageHandler::waitForPrefetch)
+        .def("setBufferCache", &mx::ImageHandler::setBufferCache)
+        .def("getBufferCache", &mx::ImageHandler::getBufferCache);
 }
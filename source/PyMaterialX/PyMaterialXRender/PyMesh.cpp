@@ -43,7 +43,9 @@ void bindPyMesh(py::module& mod)
         .def("setIdentifier", &mx::MeshPartition::setIdentifier)
         .def("getIndices", static_cast<mx::MeshIndexBuffer& (mx::MeshPartition::*)()>(&mx::MeshPartition::getIndices), py::return_value_policy::reference)
         .def("getFaceCount", &mx::MeshPartition::getFaceCount)
-        .def("setFaceCount", &mx::MeshPartition::setFaceCount);
+        .def("setFaceCount", &mx::MeshPartition::setFaceCount)
+        .def("computeACMR", &mx::MeshPartition::computeACMR,
+            py::arg("cacheSize") = mx::MeshPartition::DEFAULT_VERTEX_CACHE_SIZE);
 
     py::class_<mx::Mesh, mx::MeshPtr>(mod, "Mesh")
         .def_static("create", &mx::Mesh::create)
@@ -55,6 +57,7 @@ void bindPyMesh(py::module& mod)
         .def("getStream", static_cast<mx::MeshStreamPtr (mx::Mesh::*)(const std::string&) const>(&mx::Mesh::getStream))
         .def("getStream", static_cast<mx::MeshStreamPtr (mx::Mesh::*)(const std::string&, unsigned int) const> (&mx::Mesh::getStream))
         .def("addStream", &mx::Mesh::addStream)
+        .def("getStreams", &mx::Mesh::getStreams)
         .def("setVertexCount", &mx::Mesh::setVertexCount)
         .def("getVertexCount", &mx::Mesh::getVertexCount)
         .def("setMinimumBounds", &mx::Mesh::setMinimumBounds)
@@ -68,7 +71,14 @@ void bindPyMesh(py::module& mod)
         .def("getPartitionCount", &mx::Mesh::getPartitionCount)
         .def("addPartition", &mx::Mesh::addPartition)
         .def("getPartition", &mx::Mesh::getPartition)
-        .def("generateTangents", &mx::Mesh::generateTangents)
+        .def("generateTangents", &mx::Mesh::generateTangents,
+            py::arg("positionStream"), py::arg("texcoordStream"), py::arg("normalStream"),
+            py::arg("tangentStream"), py::arg("bitangentStream"), py::arg("numThreads") = 0)
         .def("mergePartitions", &mx::Mesh::mergePartitions)
+        .def("optimizeVertexCache", &mx::Mesh::optimizeVertexCache,
+            py::arg("cacheSize") = mx::MeshPartition::DEFAULT_VERTEX_CACHE_SIZE)
+        .def("optimizeOverdraw", &mx::Mesh::optimizeOverdraw,
+            py::arg("threshold") = 1.05f, py::arg("cacheSize") = mx::MeshPartition::DEFAULT_VERTEX_CACHE_SIZE)
+        .def("optimizeVertexFetch", &mx::Mesh::optimizeVertexFetch)
         .def("splitByUdims", &mx::Mesh::splitByUdims);
 }